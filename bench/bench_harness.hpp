@@ -0,0 +1,74 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace bench {
+
+struct Result {
+    std::string name;
+    std::uint64_t iterations = 0;
+    double ns_per_op = 0.0;
+    double bytes_per_op = 0.0;  // optional, for throughput columns
+};
+
+template <typename T>
+inline void do_not_optimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
+
+// Runs `fn` in growing batches until one batch takes at least `min_seconds`,
+// then reports the best of three batches of that size.
+template <typename Fn>
+Result measure(const std::string& name, Fn&& fn, double bytes_per_op = 0.0, double min_seconds = 0.1) {
+    using clock = std::chrono::steady_clock;
+    std::uint64_t iterations = 1;
+    auto run_batch = [&](std::uint64_t count) {
+        auto start = clock::now();
+        for (std::uint64_t i = 0; i < count; ++i) {
+            fn();
+        }
+        return std::chrono::duration<double>(clock::now() - start).count();
+    };
+    double elapsed = run_batch(iterations);
+    while (elapsed < min_seconds && iterations < (std::uint64_t{1} << 40)) {
+        double scale = elapsed > 0.0 ? std::min(10.0, std::max(2.0, 1.2 * min_seconds / elapsed)) : 10.0;
+        iterations = static_cast<std::uint64_t>(static_cast<double>(iterations) * scale);
+        elapsed = run_batch(iterations);
+    }
+    double best = elapsed;
+    for (int rep = 0; rep < 2; ++rep) {
+        best = std::min(best, run_batch(iterations));
+    }
+    Result result;
+    result.name = name;
+    result.iterations = iterations;
+    result.ns_per_op = best * 1e9 / static_cast<double>(iterations);
+    result.bytes_per_op = bytes_per_op;
+    return result;
+}
+
+inline void print_table(const std::vector<Result>& results) {
+    std::printf("%-48s %14s %12s %12s\n", "benchmark", "iterations", "ns/op", "MB/s");
+    for (const auto& r : results) {
+        if (r.bytes_per_op > 0.0) {
+            double mbps = r.bytes_per_op / r.ns_per_op * 1e9 / (1024.0 * 1024.0);
+            std::printf("%-48s %14llu %12.1f %12.1f\n", r.name.c_str(), static_cast<unsigned long long>(r.iterations),
+                        r.ns_per_op, mbps);
+        } else {
+            std::printf("%-48s %14llu %12.1f %12s\n", r.name.c_str(), static_cast<unsigned long long>(r.iterations),
+                        r.ns_per_op, "-");
+        }
+    }
+}
+
+}  // namespace bench
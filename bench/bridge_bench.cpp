@@ -0,0 +1,394 @@
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <netinet/in.h>
+#include <sys/socket.h>
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bench_harness.hpp"
+#include "core/gimbal_packet.hpp"
+#include "core/image_stream_bridge.hpp"
+#include "network/reactor.hpp"
+#include "network/socket_utils.hpp"
+#include "utils/async_log_writer.hpp"
+#include "utils/hex_encode.hpp"
+#include "utils/json.hpp"
+#include "utils/json_view.hpp"
+#include "utils/json_writer.hpp"
+#include "utils/logger.hpp"
+#include "utils/metrics.hpp"
+#include "utils/settings.hpp"
+#include "utils/timestamp.hpp"
+
+// Regression suite over the per-packet and per-frame hot paths. Prints the
+// usual table; `--json <file>` (or `-` for stdout) also writes the results
+// in a stable schema so runs from two releases can be diffed by a script.
+
+namespace {
+
+constexpr int kSchemaVersion = 1;
+
+struct Options {
+    std::string json_path;
+    std::string filter;
+    double min_seconds = 0.1;
+    int image_udp_port = 39998;
+};
+
+void print_usage(const char* argv0) {
+    std::printf(
+        "Usage: %s [--json <file|->] [--filter <substring>] [--min-time <seconds>] [--image-port <udp port>]\n",
+        argv0);
+}
+
+bool parse_args(int argc, char** argv, Options& opts) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto next = [&]() -> const char* { return i + 1 < argc ? argv[++i] : nullptr; };
+        const char* value = nullptr;
+        if (arg == "--json" && (value = next())) {
+            opts.json_path = value;
+        } else if (arg == "--filter" && (value = next())) {
+            opts.filter = value;
+        } else if (arg == "--min-time" && (value = next())) {
+            opts.min_seconds = std::atof(value);
+        } else if (arg == "--image-port" && (value = next())) {
+            opts.image_udp_port = std::atoi(value);
+        } else {
+            return false;
+        }
+    }
+    return opts.min_seconds > 0.0;
+}
+
+class Suite {
+public:
+    explicit Suite(const Options& opts) : opts_(opts) {}
+
+    bool enabled(const std::string& name) const {
+        return opts_.filter.empty() || name.find(opts_.filter) != std::string::npos;
+    }
+
+    // For skipping expensive setup: pass the exact names the setup would run.
+    bool any_enabled(const std::vector<std::string>& names) const {
+        return std::any_of(names.begin(), names.end(), [&](const std::string& name) { return enabled(name); });
+    }
+
+    template <typename Fn>
+    void run(const std::string& name, Fn&& fn, double bytes_per_op = 0.0) {
+        if (!enabled(name)) return;
+        results_.push_back(bench::measure(name, std::forward<Fn>(fn), bytes_per_op, opts_.min_seconds));
+    }
+
+    const std::vector<bench::Result>& results() const { return results_; }
+
+private:
+    const Options& opts_;
+    std::vector<bench::Result> results_;
+};
+
+std::string compiler_id() {
+#if defined(__clang__)
+    return "clang " __clang_version__;
+#elif defined(__GNUC__)
+    return "gcc " __VERSION__;
+#elif defined(_MSC_VER)
+    return "msvc " + std::to_string(_MSC_VER);
+#else
+    return "unknown";
+#endif
+}
+
+bool write_json(const std::string& path, const Options& opts, const std::vector<bench::Result>& results) {
+    std::string out;
+    mini_json::Writer writer(out, 2);
+    writer.begin_object();
+    writer.member("schema", kSchemaVersion);
+    writer.member("suite", "bridge_bench");
+    writer.member("timestamp", timestamp::local_string(std::chrono::system_clock::now()));
+    writer.member("compiler", compiler_id());
+#ifdef NDEBUG
+    writer.member("optimized", true);
+#else
+    writer.member("optimized", false);
+#endif
+    writer.member("hex_kernel", utils::hex_kernel_name(utils::hex_active_kernel()));
+    writer.member("min_seconds", opts.min_seconds);
+    writer.key("results").begin_array();
+    for (const auto& r : results) {
+        writer.begin_object();
+        writer.member("name", r.name);
+        writer.member("iterations", r.iterations);
+        writer.member("ns_per_op", r.ns_per_op);
+        if (r.bytes_per_op > 0.0) {
+            writer.member("bytes_per_op", r.bytes_per_op);
+            writer.member("mb_per_s", r.bytes_per_op / r.ns_per_op * 1e9 / (1024.0 * 1024.0));
+        }
+        writer.end_object();
+    }
+    writer.end_array();
+    writer.end_object();
+    out += '\n';
+
+    if (path == "-") {
+        std::fwrite(out.data(), 1, out.size(), stdout);
+        return true;
+    }
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) return false;
+    bool ok = std::fwrite(out.data(), 1, out.size(), file) == out.size();
+    return std::fclose(file) == 0 && ok;
+}
+
+// Route-shaped document, the same flavour json_parse_bench uses.
+std::string make_route(std::size_t waypoints) {
+    std::string out = "{\n  \"name\": \"survey \\\"north field\\\"\",\n  \"version\": 3,\n  \"waypoints\": [\n";
+    char line[256];
+    for (std::size_t i = 0; i < waypoints; ++i) {
+        std::snprintf(line, sizeof(line),
+                      "    {\"id\": %zu, \"lat\": %.7f, \"lon\": %.7f, \"alt\": %.2f, \"action\": \"%s\", "
+                      "\"tags\": [\"leg%zu\", \"auto\"], \"hold\": %s}%s\n",
+                      i, 37.5 + static_cast<double>(i) * 1e-5, 127.0 - static_cast<double>(i) * 2e-5,
+                      80.0 + static_cast<double>(i % 40), i % 5 == 0 ? "photo\\tburst" : "fly", i / 100,
+                      i % 3 == 0 ? "true" : "false", i + 1 < waypoints ? "," : "");
+        out += line;
+    }
+    out += "  ]\n}\n";
+    return out;
+}
+
+void bench_gimbal_packet(Suite& suite) {
+    using namespace core;
+    gimbal_packet::Buffer buffer{};
+    GimbalPose pose{12.34, -5.5, 0.25, 2.0};
+    suite.run("gimbal_packet/encode_pose", [&] {
+        pose.yaw += 0.01;
+        auto size = gimbal_packet::encode({buffer.data(), buffer.size()}, gimbal_packet::Format::Pose, pose, 0, 0);
+        bench::do_not_optimize(size);
+        bench::do_not_optimize(buffer);
+    });
+    suite.run("gimbal_packet/encode_sensor_tagged", [&] {
+        pose.yaw += 0.01;
+        auto size = gimbal_packet::encode({buffer.data(), buffer.size()}, gimbal_packet::Format::Sensor, pose, 1, 2);
+        gimbal_packet::write_tag({buffer.data(), buffer.size()}, static_cast<std::uint32_t>(size));
+        bench::do_not_optimize(buffer);
+    });
+    suite.run("gimbal_packet/decode_pose", [&] {
+        GimbalPose decoded;
+        bool ok = gimbal_packet::decode_pose({buffer.data(), buffer.size()}, decoded);
+        bench::do_not_optimize(ok);
+        bench::do_not_optimize(decoded);
+    });
+}
+
+void bench_hex(Suite& suite, std::mt19937& rng) {
+    std::string line;
+    for (std::size_t size : {64u, 1500u, 65536u}) {
+        std::vector<std::uint8_t> data(size);
+        for (auto& b : data) b = static_cast<std::uint8_t>(rng());
+        line.reserve(3 * size);
+        suite.run("hex/append_spaced/" + std::to_string(size), [&] {
+            line.clear();
+            utils::append_hex_spaced(line, data.data(), data.size());
+            bench::do_not_optimize(line);
+        }, static_cast<double>(size));
+    }
+}
+
+void bench_timestamp(Suite& suite) {
+    char buf[timestamp::kMaxLength];
+    suite.run("timestamp/format_local_millis", [&] {
+        auto n = timestamp::format_local(buf, std::chrono::system_clock::now());
+        bench::do_not_optimize(n);
+        bench::do_not_optimize(buf);
+    });
+    suite.run("timestamp/format_local_micros", [&] {
+        auto n = timestamp::format_local(buf, std::chrono::system_clock::now(), timestamp::Precision::Micros);
+        bench::do_not_optimize(n);
+        bench::do_not_optimize(buf);
+    });
+    std::string line;
+    suite.run("timestamp/append_local", [&] {
+        line.clear();
+        timestamp::append_local(line, std::chrono::system_clock::now());
+        bench::do_not_optimize(line);
+    });
+}
+
+void bench_logger(Suite& suite) {
+    constexpr const char* kFormat = "Forwarded {} bytes from {} to {} ({} ms)";
+    const std::string peer = "192.168.10.20:9000";
+    const char* target = "raw";
+    logging::Logger logger("Bench");
+    logger.set_level(logging::Level::Error);
+    suite.run("logger/infof_disabled", [&] { logger.infof(kFormat, 1400, peer, target, 0.25); });
+
+    if (!suite.enabled("logger/infof_async_enqueue")) return;
+    logging::AsyncOptions options;
+    options.console = false;
+    options.queue_capacity = 1 << 16;
+    logger.set_level(logging::Level::Info);
+    logger.start_async(options);
+    suite.run("logger/infof_async_enqueue", [&] { logger.infof(kFormat, 1400, peer, target, 0.25); });
+    logger.stop_async();
+}
+
+void bench_json(Suite& suite) {
+    for (std::size_t waypoints : {20u, 2000u}) {
+        const std::string text = make_route(waypoints);
+        const auto bytes = static_cast<double>(text.size());
+        const std::string suffix = "/" + std::to_string(text.size() / 1024) + "KB";
+        suite.run("json/parse" + suffix, [&] {
+            auto value = mini_json::parse(text);
+            bench::do_not_optimize(value);
+        }, bytes);
+        suite.run("json/document_parse" + suffix, [&] {
+            auto doc = mini_json::Document::parse(text);
+            bench::do_not_optimize(doc);
+        }, bytes);
+
+        const auto tree = mini_json::parse(text);
+        suite.run("json/dump" + suffix, [&] {
+            auto out = tree.dump(2);
+            bench::do_not_optimize(out);
+        }, bytes);
+    }
+}
+
+void bench_settings(Suite& suite) {
+    const settings::AppConfig defaults;
+    const mini_json::Value tree = defaults.to_json();
+    const std::string text = tree.dump(2);
+    suite.run("settings/from_json", [&] {
+        auto config = settings::AppConfig::from_json(tree, "savedata");
+        bench::do_not_optimize(config);
+    });
+    suite.run("settings/parse_and_from_json", [&] {
+        auto config = settings::AppConfig::from_json(mini_json::parse(text), "savedata");
+        bench::do_not_optimize(config);
+    }, static_cast<double>(text.size()));
+    std::string out;
+    suite.run("settings/write_json", [&] {
+        out.clear();
+        mini_json::Writer writer(out, 2);
+        defaults.write_json(writer);
+        bench::do_not_optimize(out);
+    });
+}
+
+void bench_metrics(Suite& suite) {
+    auto& registry = metrics::default_registry();
+    auto& counter = registry.counter("bench_counter", "bridge_bench scratch counter");
+    auto& histogram = registry.histogram("bench_histogram", "bridge_bench scratch histogram");
+    suite.run("metrics/counter_inc", [&] { counter.add(); });
+    std::uint64_t ns = 1000;
+    suite.run("metrics/histogram_record", [&] {
+        ns = ns * 1103515245u + 12345u;
+        histogram.record(ns % 10'000'000);
+    });
+}
+
+// Feeds one frame of each size through a real bridge on loopback, then times
+// latest_frame(): the copy every preview/viewer reader takes under the frame
+// lock.
+void bench_image(Suite& suite, const Options& opts) {
+    const std::size_t sizes[] = {16u * 1024u, 60u * 1024u};
+    auto bench_name = [](std::size_t size) { return "image/latest_frame/" + std::to_string(size / 1024) + "KB"; };
+    std::vector<std::string> names;
+    for (std::size_t size : sizes) names.push_back(bench_name(size));
+    if (!suite.any_enabled(names)) return;
+    logging::Logger logger("BenchBridge");
+    logger.set_level(logging::Level::Error);
+    settings::BridgeSettings cfg;
+    cfg.ip = "127.0.0.1";
+    cfg.udp_port = opts.image_udp_port;
+    cfg.tcp_port = 0;
+    network::Reactor reactor;
+    reactor.start();
+    core::ImageStreamBridge bridge(cfg, reactor, logger);
+    bridge.start();
+    if (!bridge.status().udp_running) {
+        std::fprintf(stderr, "image benches skipped: cannot bind UDP %d\n", opts.image_udp_port);
+        return;
+    }
+
+    int sender = network::create_udp_socket();
+    sockaddr_in dest = network::make_address(cfg.ip, static_cast<std::uint16_t>(cfg.udp_port));
+    std::vector<std::uint8_t> frame;
+    for (std::size_t size : sizes) {
+        frame.assign(size, 0);
+        frame[0] = 0xFF;
+        frame[1] = 0xD8;
+        const auto previous = bridge.status().last_frame_meta.sequence;
+        sendto(sender, reinterpret_cast<const char*>(frame.data()), static_cast<int>(frame.size()), 0,
+               reinterpret_cast<sockaddr*>(&dest), sizeof(dest));
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+        while (bridge.status().last_frame_meta.sequence == previous && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        if (bridge.status().last_frame_bytes != size) {
+            std::fprintf(stderr, "image benches skipped: %zu byte frame did not arrive\n", size);
+            break;
+        }
+
+        std::vector<std::uint8_t> out;
+        suite.run(bench_name(size), [&] {
+            auto meta = bridge.latest_frame(out);
+            bench::do_not_optimize(meta);
+            bench::do_not_optimize(out);
+        }, static_cast<double>(size));
+    }
+    network::close_socket(sender);
+    bridge.stop();
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    Options opts;
+    if (!parse_args(argc, argv, opts)) {
+        print_usage(argv[0]);
+        return 2;
+    }
+#ifdef _WIN32
+    WSADATA wsaData;
+    if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0) {
+        std::fprintf(stderr, "Failed to initialize Winsock\n");
+        return 1;
+    }
+#endif
+
+    std::mt19937 rng(42);
+    Suite suite(opts);
+    bench_gimbal_packet(suite);
+    bench_hex(suite, rng);
+    bench_timestamp(suite);
+    bench_logger(suite);
+    bench_json(suite);
+    bench_settings(suite);
+    bench_metrics(suite);
+    bench_image(suite, opts);
+
+    if (opts.json_path != "-") {
+        bench::print_table(suite.results());
+    }
+    if (!opts.json_path.empty() && !write_json(opts.json_path, opts, suite.results())) {
+        std::fprintf(stderr, "failed to write %s\n", opts.json_path.c_str());
+        return 1;
+    }
+#ifdef _WIN32
+    WSACleanup();
+#endif
+    return 0;
+}
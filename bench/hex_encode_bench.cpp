@@ -0,0 +1,83 @@
+#include <cstdint>
+#include <cstdio>
+#include <iomanip>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "bench_harness.hpp"
+#include "utils/hex_encode.hpp"
+
+namespace {
+
+// Previous RoverRelayLogger hex_dump, kept verbatim as the baseline.
+namespace legacy {
+std::string hex_dump(const std::vector<std::uint8_t>& data) {
+    std::ostringstream oss;
+    for (std::size_t i = 0; i < data.size(); ++i) {
+        if (i > 0) oss << ' ';
+        oss << std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(data[i]);
+    }
+    return oss.str();
+}
+}  // namespace legacy
+
+constexpr utils::HexKernel kKernels[] = {utils::HexKernel::Scalar, utils::HexKernel::Ssse3, utils::HexKernel::Avx2};
+
+std::vector<std::uint8_t> random_bytes(std::size_t size, std::mt19937& rng) {
+    std::vector<std::uint8_t> data(size);
+    for (auto& b : data) b = static_cast<std::uint8_t>(rng());
+    return data;
+}
+
+bool verify(std::mt19937& rng) {
+    for (std::size_t size = 0; size <= 300; ++size) {
+        auto data = random_bytes(size, rng);
+        std::string expected = legacy::hex_dump(data);
+        for (auto kernel : kKernels) {
+            if (!utils::hex_kernel_supported(kernel)) continue;
+            std::string actual(3 * size, '\0');
+            actual.resize(utils::hex_encode_spaced(kernel, actual.data(), data.data(), data.size()));
+            if (actual != expected) {
+                std::fprintf(stderr, "hex mismatch: kernel=%s size=%zu\n", utils::hex_kernel_name(kernel), size);
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+int main() {
+    std::mt19937 rng(42);
+    if (!verify(rng)) return 1;
+    std::printf("active kernel: %s\n\n", utils::hex_kernel_name(utils::hex_active_kernel()));
+
+    std::vector<bench::Result> results;
+    for (std::size_t size : {16u, 64u, 256u, 1500u, 4096u, 16384u, 65536u}) {
+        auto data = random_bytes(size, rng);
+        const auto bytes = static_cast<double>(size);
+        const std::string suffix = "/" + std::to_string(size);
+
+        results.push_back(bench::measure("legacy_ostringstream" + suffix, [&] {
+            auto text = legacy::hex_dump(data);
+            bench::do_not_optimize(text);
+        }, bytes));
+
+        std::string line;
+        line.reserve(3 * size);
+        for (auto kernel : kKernels) {
+            if (!utils::hex_kernel_supported(kernel)) continue;
+            results.push_back(bench::measure(std::string(utils::hex_kernel_name(kernel)) + suffix, [&] {
+                line.resize(3 * size);
+                line.resize(utils::hex_encode_spaced(kernel, line.data(), data.data(), data.size()));
+                bench::do_not_optimize(line);
+            }, bytes));
+        }
+    }
+
+    bench::print_table(results);
+    return 0;
+}
@@ -0,0 +1,299 @@
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "bench_harness.hpp"
+#include "utils/json.hpp"
+#include "utils/json_view.hpp"
+
+namespace {
+
+// Previous mini_json parser, kept verbatim as the baseline.
+namespace legacy {
+using mini_json::Value;
+
+class Parser {
+public:
+    explicit Parser(const std::string& text) : text_(text) {}
+
+    Value parse_value() {
+        skip_ws();
+        if (eof()) {
+            throw std::runtime_error("Unexpected end of JSON input");
+        }
+        char ch = peek();
+        if (ch == 'n') return parse_null();
+        if (ch == 't' || ch == 'f') return parse_bool();
+        if (ch == '"') return parse_string();
+        if (ch == '{') return parse_object();
+        if (ch == '[') return parse_array();
+        if (ch == '-' || std::isdigit(static_cast<unsigned char>(ch))) {
+            return parse_number();
+        }
+        throw std::runtime_error("Invalid JSON token");
+    }
+
+    void ensure_consumed() {
+        skip_ws();
+        if (!eof()) {
+            throw std::runtime_error("Extra data after JSON value");
+        }
+    }
+
+private:
+    Value parse_null() {
+        expect("null");
+        return Value(nullptr);
+    }
+
+    Value parse_bool() {
+        if (match("true")) {
+            return Value(true);
+        }
+        expect("false");
+        return Value(false);
+    }
+
+    Value parse_number() {
+        size_t start = pos_;
+        if (peek() == '-') advance();
+        while (!eof() && std::isdigit(static_cast<unsigned char>(peek()))) {
+            advance();
+        }
+        if (!eof() && peek() == '.') {
+            advance();
+            while (!eof() && std::isdigit(static_cast<unsigned char>(peek()))) {
+                advance();
+            }
+        }
+        if (!eof() && (peek() == 'e' || peek() == 'E')) {
+            advance();
+            if (!eof() && (peek() == '+' || peek() == '-')) {
+                advance();
+            }
+            while (!eof() && std::isdigit(static_cast<unsigned char>(peek()))) {
+                advance();
+            }
+        }
+        double value = std::stod(text_.substr(start, pos_ - start));
+        return Value(value);
+    }
+
+    Value parse_string() {
+        expect('"');
+        std::ostringstream oss;
+        while (!eof()) {
+            char ch = advance();
+            if (ch == '"') {
+                return Value(oss.str());
+            }
+            if (ch == '\\') {
+                if (eof()) {
+                    throw std::runtime_error("Invalid escape sequence");
+                }
+                char esc = advance();
+                switch (esc) {
+                    case '\"': oss << '"'; break;
+                    case '\\': oss << '\\'; break;
+                    case '/': oss << '/'; break;
+                    case 'b': oss << '\b'; break;
+                    case 'f': oss << '\f'; break;
+                    case 'n': oss << '\n'; break;
+                    case 'r': oss << '\r'; break;
+                    case 't': oss << '\t'; break;
+                    case 'u': {
+                        std::string hex;
+                        for (int i = 0; i < 4; ++i) {
+                            if (eof()) throw std::runtime_error("Invalid unicode escape");
+                            hex.push_back(advance());
+                        }
+                        char16_t code = static_cast<char16_t>(std::stoi(hex, nullptr, 16));
+                        if (code < 0x80) {
+                            oss << static_cast<char>(code);
+                        } else if (code < 0x800) {
+                            oss << static_cast<char>(0xC0 | ((code >> 6) & 0x1F));
+                            oss << static_cast<char>(0x80 | (code & 0x3F));
+                        } else {
+                            oss << static_cast<char>(0xE0 | ((code >> 12) & 0x0F));
+                            oss << static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+                            oss << static_cast<char>(0x80 | (code & 0x3F));
+                        }
+                        break;
+                    }
+                    default:
+                        throw std::runtime_error("Unknown escape sequence");
+                }
+            } else {
+                oss << ch;
+            }
+        }
+        throw std::runtime_error("Unterminated string literal");
+    }
+
+    Value parse_array() {
+        expect('[');
+        Value::Array arr;
+        skip_ws();
+        if (peek() == ']') {
+            advance();
+            return Value(arr);
+        }
+        while (true) {
+            arr.push_back(parse_value());
+            skip_ws();
+            if (peek() == ',') {
+                advance();
+                skip_ws();
+                continue;
+            }
+            if (peek() == ']') {
+                advance();
+                break;
+            }
+            throw std::runtime_error("Expected ',' or ']'");
+        }
+        return Value(arr);
+    }
+
+    Value parse_object() {
+        expect('{');
+        Value::Object obj;
+        skip_ws();
+        if (peek() == '}') {
+            advance();
+            return Value(obj);
+        }
+        while (true) {
+            skip_ws();
+            if (peek() != '"') {
+                throw std::runtime_error("Expected string key");
+            }
+            std::string key = parse_string().as_string();
+            skip_ws();
+            expect(':');
+            skip_ws();
+            obj.emplace(std::move(key), parse_value());
+            skip_ws();
+            if (peek() == ',') {
+                advance();
+                skip_ws();
+                continue;
+            }
+            if (peek() == '}') {
+                advance();
+                break;
+            }
+            throw std::runtime_error("Expected ',' or '}' in object");
+        }
+        return Value(obj);
+    }
+
+    void skip_ws() {
+        while (!eof() && std::isspace(static_cast<unsigned char>(peek()))) {
+            advance();
+        }
+    }
+
+    bool eof() const { return pos_ >= text_.size(); }
+    char peek() const { return eof() ? '\0' : text_[pos_]; }
+    char advance() { return text_[pos_++]; }
+
+    bool match(const char* token) {
+        size_t len = std::strlen(token);
+        if (text_.compare(pos_, len, token) == 0) {
+            pos_ += len;
+            return true;
+        }
+        return false;
+    }
+
+    void expect(const char* token) {
+        if (!match(token)) {
+            throw std::runtime_error("Unexpected token in JSON input");
+        }
+    }
+
+    void expect(char token) {
+        if (eof() || text_[pos_] != token) {
+            throw std::runtime_error("Unexpected character in JSON input");
+        }
+        ++pos_;
+    }
+
+    const std::string& text_;
+    size_t pos_ = 0;
+};
+
+Value parse(const std::string& text) {
+    Parser parser(text);
+    Value root = parser.parse_value();
+    parser.ensure_consumed();
+    return root;
+}
+}  // namespace legacy
+
+// Route/scenario-shaped document: a few header fields and `waypoints`
+// objects with numbers, short strings, a tag array and the odd escape.
+std::string make_route(std::size_t waypoints) {
+    std::string out = "{\n  \"name\": \"survey \\\"north field\\\"\",\n  \"version\": 3,\n  \"waypoints\": [\n";
+    char line[256];
+    for (std::size_t i = 0; i < waypoints; ++i) {
+        std::snprintf(line, sizeof(line),
+                      "    {\"id\": %zu, \"lat\": %.7f, \"lon\": %.7f, \"alt\": %.2f, \"speed\": %.1f, "
+                      "\"action\": \"%s\", \"tags\": [\"leg%zu\", \"auto\"], \"hold\": %s}%s\n",
+                      i, 37.5 + static_cast<double>(i) * 1e-5, 127.0 - static_cast<double>(i) * 2e-5,
+                      80.0 + static_cast<double>(i % 40), 4.0 + static_cast<double>(i % 7),
+                      i % 5 == 0 ? "photo\\tburst" : "fly", i / 100, i % 3 == 0 ? "true" : "false",
+                      i + 1 < waypoints ? "," : "");
+        out += line;
+    }
+    out += "  ],\n  \"notes\": null\n}\n";
+    return out;
+}
+
+}  // namespace
+
+int main() {
+    std::vector<bench::Result> results;
+    for (std::size_t waypoints : {20u, 2000u, 40000u}) {
+        const std::string text = make_route(waypoints);
+
+        // Sanity check: both parsers must build the same tree.
+        if (legacy::parse(text).dump() != mini_json::parse(text).dump()) {
+            std::fprintf(stderr, "parse mismatch for %zu waypoints\n", waypoints);
+            return 1;
+        }
+
+        const auto bytes = static_cast<double>(text.size());
+        const std::string suffix = "/" + std::to_string(text.size() / 1024) + "KB";
+        results.push_back(bench::measure("legacy_parse" + suffix, [&] {
+            auto value = legacy::parse(text);
+            bench::do_not_optimize(value);
+        }, bytes));
+        results.push_back(bench::measure("parse_to_value" + suffix, [&] {
+            auto value = mini_json::parse(text);
+            bench::do_not_optimize(value);
+        }, bytes));
+        results.push_back(bench::measure("document_view" + suffix, [&] {
+            auto doc = mini_json::Document::parse(text);
+            bench::do_not_optimize(doc);
+        }, bytes));
+        results.push_back(bench::measure("document_view_sum_alt" + suffix, [&] {
+            auto doc = mini_json::Document::parse(text);
+            double sum = 0.0;
+            if (const auto* points = doc.root().find("waypoints")) {
+                for (const auto& point : points->items()) {
+                    if (const auto* alt = point.find("alt")) sum += alt->as_number();
+                }
+            }
+            bench::do_not_optimize(sum);
+        }, bytes));
+    }
+
+    bench::print_table(results);
+    return 0;
+}
@@ -0,0 +1,91 @@
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "bench_harness.hpp"
+#include "utils/async_log_writer.hpp"
+#include "utils/logger.hpp"
+
+namespace {
+
+// Previous Logger::format implementation, kept verbatim as the baseline.
+namespace legacy {
+void format_impl(std::ostringstream& oss, const std::string& fmt) { oss << fmt; }
+
+template <typename T, typename... Args>
+void format_impl(std::ostringstream& oss, const std::string& fmt, T&& value, Args&&... rest) {
+    std::size_t pos = fmt.find("{}");
+    if (pos == std::string::npos) {
+        oss << fmt;
+        return;
+    }
+    oss << fmt.substr(0, pos);
+    oss << std::forward<T>(value);
+    format_impl(oss, fmt.substr(pos + 2), std::forward<Args>(rest)...);
+}
+
+template <typename... Args>
+std::string format(const std::string& fmt, Args&&... args) {
+    std::ostringstream oss;
+    format_impl(oss, fmt, std::forward<Args>(args)...);
+    return oss.str();
+}
+}  // namespace legacy
+
+constexpr const char* kFormat = "Image stream bridge started on UDP {} and TCP {} ({} viewers, {} ms, {})";
+
+}  // namespace
+
+int main() {
+    std::vector<bench::Result> results;
+    int udp = 9998;
+    int tcp = 9999;
+    std::size_t viewers = 3;
+    double age = 12.75;
+    std::string tag = "realtime";
+
+    // Sanity check: both engines must render identical text.
+    std::string expected = legacy::format(kFormat, udp, tcp, viewers, age, tag);
+    std::string actual;
+    logging::detail::format_to(actual, kFormat, udp, tcp, viewers, age, tag);
+    if (expected != actual) {
+        std::fprintf(stderr, "format mismatch:\n  legacy: %s\n  new:    %s\n", expected.c_str(), actual.c_str());
+        return 1;
+    }
+
+    results.push_back(bench::measure("format/legacy_ostringstream", [&] {
+        auto text = legacy::format(kFormat, udp, tcp, viewers, age, tag);
+        bench::do_not_optimize(text);
+    }));
+    results.push_back(bench::measure("format/single_pass_thread_buffer", [&] {
+        std::string& buffer = logging::detail::format_buffer();
+        buffer.clear();
+        logging::detail::format_to(buffer, kFormat, udp, tcp, viewers, age, tag);
+        bench::do_not_optimize(buffer);
+    }));
+
+    // Disabled level: the legacy Logger formatted before checking the level.
+    logging::Logger logger("Bench");
+    logger.set_level(logging::Level::Error);
+    results.push_back(bench::measure("infof/disabled_level_legacy_cost", [&] {
+        auto text = legacy::format(kFormat, udp, tcp, viewers, age, tag);
+        bench::do_not_optimize(text);
+    }));
+    results.push_back(bench::measure("infof/disabled_level", [&] {
+        logger.infof(kFormat, udp, tcp, viewers, age, tag);
+    }));
+
+    // Enabled level through the async backend with console output off.
+    logging::AsyncOptions options;
+    options.console = false;
+    options.queue_capacity = 1 << 16;
+    logger.set_level(logging::Level::Info);
+    logger.start_async(options);
+    results.push_back(bench::measure("infof/enabled_async_enqueue", [&] {
+        logger.infof(kFormat, udp, tcp, viewers, age, tag);
+    }));
+    logger.stop_async();
+
+    bench::print_table(results);
+    return 0;
+}
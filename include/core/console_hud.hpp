@@ -0,0 +1,80 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <iosfwd>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "core/gimbal_control.hpp"
+#include "core/image_stream_bridge.hpp"
+#include "core/udp_relay.hpp"
+#include "utils/metrics.hpp"
+
+namespace core {
+
+struct HudOptions {
+    double interval_s = 1.0;                    // redraw period
+    std::vector<double> windows_s{1.0, 10.0, 60.0};  // one table column per window
+    bool ansi = true;                           // redraw in place; ignored when stdout is not a terminal
+};
+
+// Terminal dashboard for headless runs. Registry counters are sampled four
+// times a second into a ring covering the longest window; rates are the
+// counter delta across each window and frame-age percentiles come from the
+// samples inside it. On a terminal the block is redrawn in place, otherwise
+// it is printed once per interval.
+class ConsoleHud {
+public:
+    ConsoleHud(HudOptions options, metrics::Registry& registry, const ImageStreamBridge& image_bridge,
+               const GimbalControl& gimbal, const UdpRelay& relay, std::ostream& out);
+    ~ConsoleHud();
+
+    ConsoleHud(const ConsoleHud&) = delete;
+    ConsoleHud& operator=(const ConsoleHud&) = delete;
+
+    void start();
+    void stop();
+
+private:
+    struct Sample {
+        std::chrono::steady_clock::time_point time{};
+        double relay_packets = 0.0;
+        double relay_bytes = 0.0;
+        double relay_errors = 0.0;
+        double relay_raw_drops = 0.0;
+        double relay_proc_drops = 0.0;
+        double image_frames = 0.0;
+        double image_bytes = 0.0;
+        double image_errors = 0.0;
+        double gimbal_errors = 0.0;
+        double log_drops = 0.0;
+        double frame_age_s = -1.0;  // < 0 before the first frame
+    };
+
+    void run();
+    void take_sample();
+    std::string render() const;
+
+    HudOptions options_;
+    metrics::Registry& registry_;
+    const ImageStreamBridge& image_bridge_;
+    const GimbalControl& gimbal_;
+    const UdpRelay& relay_;
+    std::ostream& out_;
+    bool ansi_ = false;
+
+    std::deque<Sample> samples_;  // worker thread only
+    std::size_t drawn_lines_ = 0;
+
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    bool running_ = false;
+    std::thread thread_;
+};
+
+}  // namespace core
@@ -1,12 +1,22 @@
 #pragma once
 
+#include <array>
 #include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <mutex>
 #include <string>
-#include <thread>
 #include <vector>
 
+#include "core/gimbal_packet.hpp"
+#include "core/gimbal_pose.hpp"
+#include "core/gimbal_trajectory.hpp"
+#include "core/pose_history.hpp"
+#include "core/status_feed.hpp"
+#include "network/reactor.hpp"
+#include "network/socket_utils.hpp"
 #include "utils/logger.hpp"
+#include "utils/metrics.hpp"
 #include "utils/settings.hpp"
 
 namespace core {
@@ -17,34 +27,140 @@ struct GimbalStatus {
     double pitch = 0.0;
     double roll = 0.0;
     double zoom = 1.0;
+    bool moving = false;
+    std::size_t pending_waypoints = 0;
+    bool measuring_latency = false;
+    std::size_t latency_samples = 0;
+    double latency_p50_ms = 0.0;
+    double latency_p99_ms = 0.0;
+    double latency_max_ms = 0.0;
 };
 
 class GimbalControl {
 public:
-    GimbalControl(const settings::GimbalSettings& cfg, logging::Logger& logger);
+    GimbalControl(const settings::GimbalSettings& cfg, network::Reactor& reactor, logging::Logger& logger);
     ~GimbalControl();
 
     void start();
     void stop();
 
+    // Applies edited settings while running. Target address, rate, packet
+    // format, sensor ids and limits are picked up before the next tick; a
+    // changed feedback bind or latency toggle restarts the sender.
+    // The commanded pose is kept either way.
+    bool apply_settings(const settings::GimbalSettings& cfg);
+
+    // update_pose(), move_to(), follow_waypoints() and hold() take over from
+    // steer(): a steer target not yet applied by the send tick is dropped.
     void update_pose(double yaw_deg, double pitch_deg, double roll_deg, double zoom_level);
 
+    // Smoothly slews the commanded pose; interpolation runs on the send tick.
+    void move_to(const GimbalPose& target);
+    void move_to(const GimbalPose& target, const TrajectoryLimits& limits);
+    void follow_waypoints(std::vector<GimbalPose> waypoints);
+    void follow_waypoints(std::vector<GimbalPose> waypoints, const TrajectoryLimits& limits);
+    void hold();
+
+    // Latest-wins target for interactive steering (sliders, keys). Only
+    // stores to a lock-free slot; the next send tick picks up the newest
+    // target and slews towards it with the configured limits, so a burst of
+    // UI events costs one trajectory update per tick and never an extra
+    // packet. Single writer: call from one thread (the GUI).
+    void steer(const GimbalPose& target);
+
+    // Bumped by every pose change that does not come from steer(), so a
+    // steering UI can tell when to re-read the commanded pose.
+    std::uint64_t pose_overrides() const { return pose_overrides_.load(std::memory_order_acquire); }
+
+    TrajectoryLimits default_limits() const;
+
     GimbalStatus status() const;
 
+    // Publishes a StatusDelta from the sender's loop every
+    // StatusFeed::kPublishPeriod; nullptr detaches. `feed` must stay alive
+    // until it is detached or this object is destroyed.
+    void set_status_feed(StatusFeed* feed);
+
+    // Timestamped commanded poses, one per sent packet; safe to read from any thread.
+    const PoseHistory& pose_history() const { return pose_history_; }
+
+    // Reactor loop the send timer and feedback socket run on.
+    std::size_t loop() const { return loop_; }
+
 private:
-    void worker();
+    struct InflightCommand {
+        std::atomic<std::uint32_t> sequence{0};
+        std::atomic<std::int64_t> sent_ns{0};
+    };
 
+    static constexpr std::size_t kInflightSlots = 256;
+
+    void start_worker();
+    void stop_worker();
+    settings::GimbalSettings config_snapshot() const;
+
+    // Loop-side: open_sender() and load() run through Reactor::run_sync.
+    void open_sender(const settings::GimbalSettings& cfg);
+    void load(const settings::GimbalSettings& cfg);
+    void tick();
+    void on_feedback();
+    void record_feedback(std::uint32_t sequence);
+    bool take_steer_target(GimbalPose& out);
+    void drop_pending_steer();
+    void publish_status();
+
+    std::mutex control_mutex_;  // serialises start/stop/apply_settings
+    mutable std::mutex config_mutex_;
     settings::GimbalSettings config_;
     logging::Logger& logger_;
+    network::Reactor& reactor_;
+    const std::size_t loop_;
 
     std::atomic<bool> running_{false};
-    std::thread worker_thread_;
+    std::atomic<bool> measuring_{false};
+
+    // Loop-side sender state, derived from the settings in load().
+    int socket_ = -1;
+    network::EventHandle timer_;
+    network::EventHandle feedback_event_;
+    sockaddr_in target_{};
+    std::chrono::nanoseconds period_{};
+    gimbal_packet::Format format_{};
+    int sensor_type_ = 0;
+    int sensor_id_ = 0;
+    std::chrono::steady_clock::time_point last_tick_{};
+    gimbal_packet::Buffer packet_{};
+    TrajectoryLimits limits_{};
+    std::uint64_t steer_applied_ = 0;  // guarded by pose_mutex_
+    std::atomic<std::uint64_t> pose_overrides_{0};
+
+    // Seqlock written by steer(), read by tick(); odd while a write is in
+    // progress.
+    struct SteerSlot {
+        std::atomic<std::uint64_t> sequence{0};
+        std::atomic<double> yaw{0.0};
+        std::atomic<double> pitch{0.0};
+        std::atomic<double> roll{0.0};
+        std::atomic<double> zoom{1.0};
+    };
+    SteerSlot steer_;
 
     mutable std::mutex pose_mutex_;
-    double yaw_ = 0.0;
-    double pitch_ = 0.0;
-    double roll_ = 0.0;
-    double zoom_ = 1.0;
+    GimbalTrajectory trajectory_;
+    PoseHistory pose_history_;
+
+    std::array<InflightCommand, kInflightSlots> inflight_{};
+    std::uint32_t next_sequence_ = 0;
+    metrics::LatencyHistogram& latency_;
+    metrics::Counter& commands_sent_;
+    metrics::Counter& send_errors_;
+
+    // Status feed, loop-side. The timer is declared last so it is removed
+    // before anything its callback reads is destroyed.
+    StatusFeed* feed_ = nullptr;
+    std::int64_t published_ns_ = 0;
+    std::uint64_t published_commands_ = 0;
+    network::EventHandle feed_timer_;
 };
 
 }  // namespace core
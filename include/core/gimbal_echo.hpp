@@ -0,0 +1,38 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <string>
+#include <thread>
+
+#include "utils/logger.hpp"
+
+namespace core {
+
+// Local stand-in for the gimbal generator: bounces every datagram back to
+// its sender so GimbalControl's latency instrumentation can be exercised.
+class GimbalEcho {
+public:
+    GimbalEcho(std::string bind_ip, int port, int delay_ms, logging::Logger& logger);
+    ~GimbalEcho();
+
+    void start();
+    void stop();
+
+    std::size_t echoed() const { return echoed_.load(); }
+
+private:
+    void loop();
+
+    std::string bind_ip_;
+    int port_;
+    int delay_ms_;
+    logging::Logger& logger_;
+
+    std::atomic<bool> running_{false};
+    int socket_ = -1;
+    std::thread thread_;
+    std::atomic<std::size_t> echoed_{0};
+};
+
+}  // namespace core
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "core/gimbal_pose.hpp"
+#include "network/packet_codec.hpp"
+
+namespace core {
+namespace gimbal_packet {
+
+namespace codec = network::codec;
+
+constexpr std::size_t kSize = 32;
+
+using Buffer = std::array<std::uint8_t, kSize>;
+
+// Angles and zoom travel as big-endian int32 in hundredths.
+constexpr auto kPoseLayout = codec::make_layout<kSize>(
+    codec::be_int(0, 4, 100.0),
+    codec::be_int(4, 4, 100.0),
+    codec::be_int(8, 4, 100.0),
+    codec::be_int(12, 4, 100.0));
+
+// Pose layout followed by the sensor selector bytes.
+constexpr auto kSensorLayout = codec::make_layout<kSize>(
+    codec::be_int(0, 4, 100.0),
+    codec::be_int(4, 4, 100.0),
+    codec::be_int(8, 4, 100.0),
+    codec::be_int(12, 4, 100.0),
+    codec::be_uint(16, 1),
+    codec::be_uint(17, 1));
+
+// Latency instrumentation trailer: magic + sequence number in the padding.
+constexpr std::uint32_t kTagMagic = 0x4D524F54;  // "MROT"
+constexpr auto kTagLayout = codec::make_layout<kSize>(
+    codec::be_uint(24, 4),
+    codec::be_uint(28, 4));
+
+static_assert(codec::is_valid(kPoseLayout), "invalid gimbal pose layout");
+static_assert(codec::is_valid(kSensorLayout), "invalid gimbal sensor layout");
+static_assert(codec::is_valid(kTagLayout), "invalid gimbal tag layout");
+
+enum class Format { Pose, Sensor };
+
+inline Format parse_format(const std::string& name) {
+    return name == "sensor" ? Format::Sensor : Format::Pose;
+}
+
+inline std::size_t encode(codec::ByteSpan out, Format format, const GimbalPose& pose, int sensor_type, int sensor_id) {
+    if (format == Format::Sensor) {
+        return codec::encode(kSensorLayout, out, pose.yaw, pose.pitch, pose.roll, pose.zoom, sensor_type, sensor_id);
+    }
+    return codec::encode(kPoseLayout, out, pose.yaw, pose.pitch, pose.roll, pose.zoom);
+}
+
+inline void write_tag(codec::ByteSpan out, std::uint32_t sequence) {
+    if (out.data == nullptr || out.size < kSize) return;
+    codec::encode_field(kTagLayout.fields[0], out.data, kTagMagic);
+    codec::encode_field(kTagLayout.fields[1], out.data, sequence);
+}
+
+inline bool read_tag(codec::ConstByteSpan in, std::uint32_t& sequence) {
+    if (in.data == nullptr || in.size < kSize) return false;
+    if (codec::load_raw(kTagLayout.fields[0], in.data) != kTagMagic) return false;
+    sequence = static_cast<std::uint32_t>(codec::load_raw(kTagLayout.fields[1], in.data));
+    return true;
+}
+
+inline bool decode_pose(codec::ConstByteSpan in, GimbalPose& pose) {
+    std::array<double, kPoseLayout.field_count> values{};
+    if (!codec::decode(kPoseLayout, in, values)) return false;
+    pose = GimbalPose{values[0], values[1], values[2], values[3]};
+    return true;
+}
+
+}  // namespace gimbal_packet
+}  // namespace core
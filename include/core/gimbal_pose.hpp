@@ -0,0 +1,12 @@
+#pragma once
+
+namespace core {
+
+struct GimbalPose {
+    double yaw = 0.0;
+    double pitch = 0.0;
+    double roll = 0.0;
+    double zoom = 1.0;
+};
+
+}  // namespace core
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstddef>
+#include <deque>
+#include <vector>
+
+#include "core/gimbal_pose.hpp"
+
+namespace core {
+
+// Angular limits are in degrees per second (squared); zoom limits in zoom levels.
+// A non-positive limit disables that constraint.
+struct TrajectoryLimits {
+    double max_rate = 60.0;
+    double max_accel = 120.0;
+    double max_zoom_rate = 2.0;
+    double max_zoom_accel = 4.0;
+};
+
+// Rate/acceleration limited follower that walks the commanded pose towards a
+// target (or a list of waypoints) one sender tick at a time.
+class GimbalTrajectory {
+public:
+    void reset(const GimbalPose& pose);
+    void set_target(const GimbalPose& target, const TrajectoryLimits& limits);
+    void set_waypoints(std::vector<GimbalPose> waypoints, const TrajectoryLimits& limits);
+    void hold();
+
+    const GimbalPose& step(double dt_seconds);
+
+    const GimbalPose& current() const { return current_; }
+    bool active() const { return active_; }
+    std::size_t pending_waypoints() const { return waypoints_.size(); }
+
+private:
+    struct Axis {
+        double velocity = 0.0;
+        bool advance(double& position, double target, double max_rate, double max_accel, double dt);
+    };
+
+    GimbalPose current_{};
+    GimbalPose target_{};
+    TrajectoryLimits limits_{};
+    std::deque<GimbalPose> waypoints_;
+    Axis yaw_axis_;
+    Axis pitch_axis_;
+    Axis roll_axis_;
+    Axis zoom_axis_;
+    bool active_ = false;
+};
+
+}  // namespace core
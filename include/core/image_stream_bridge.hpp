@@ -1,54 +1,142 @@
 #pragma once
 
 #include <atomic>
+#include <chrono>
 #include <cstdint>
+#include <memory>
 #include <mutex>
 #include <optional>
 #include <string>
-#include <thread>
 #include <vector>
 
+#include "core/gimbal_pose.hpp"
+#include "core/status_feed.hpp"
+#include "network/reactor.hpp"
 #include "network/socket_endpoint.hpp"
 #include "utils/logger.hpp"
+#include "utils/metrics.hpp"
 #include "utils/settings.hpp"
 
 namespace core {
 
+class PoseHistory;
+
+struct FrameMetadata {
+    std::uint64_t sequence = 0;
+    std::chrono::system_clock::time_point received_at{};
+    std::int64_t received_steady_ns = 0;
+    bool has_pose = false;
+    GimbalPose pose{};  // gimbal pose interpolated at receive time
+};
+
 struct ImageStreamStatus {
     bool udp_running = false;
     bool tcp_running = false;
     std::size_t last_frame_bytes = 0;
     std::chrono::system_clock::time_point last_frame_time{};
     std::size_t clients = 0;
+    FrameMetadata last_frame_meta{};
 };
 
 class ImageStreamBridge {
 public:
-    ImageStreamBridge(const settings::BridgeSettings& cfg, logging::Logger& logger);
+    ImageStreamBridge(const settings::BridgeSettings& cfg, network::Reactor& reactor, logging::Logger& logger);
     ~ImageStreamBridge();
 
     void start();
     void stop();
 
+    // Applies edited settings to the running bridge. Only the UDP receiver or
+    // TCP listener whose address changed is rebound; connected viewers keep
+    // streaming. Returns false when nothing differs from the current settings.
+    bool apply_settings(const settings::BridgeSettings& cfg);
+
     ImageStreamStatus status() const;
 
+    // Publishes a StatusDelta from the receiver's loop every
+    // StatusFeed::kPublishPeriod; nullptr detaches. `feed` must stay alive
+    // until it is detached or this object is destroyed.
+    void set_status_feed(StatusFeed* feed);
+
+    // Attaches the gimbal pose history used to tag received frames.
+    void set_pose_source(const PoseHistory* history);
+
+    // Copies the newest frame into `out` and returns its metadata.
+    FrameMetadata latest_frame(std::vector<std::uint8_t>& out) const;
+    // Shares the newest frame without copying it; `out` is null until the
+    // first frame arrives. Frames are immutable once published.
+    FrameMetadata latest_frame(std::shared_ptr<const std::vector<std::uint8_t>>& out) const;
+
+    // Reactor loop the receiver, listener and viewers run on.
+    std::size_t loop() const { return loop_; }
+
 private:
-    void udp_loop();
-    void tcp_loop();
+    // A connected TCP viewer. `frame` pins the frame being written so a new
+    // UDP frame never has to wait for slow viewers.
+    struct Viewer {
+        int fd = -1;
+        network::EventHandle event;
+        std::shared_ptr<const std::vector<std::uint8_t>> frame;
+        std::size_t offset = 0;
+        bool want_write = false;  // writable interest registered
+    };
+
+    int open_udp(const std::string& ip, int port);
+    int open_tcp(const std::string& ip, int port);
+    void start_udp(int sock);
+    void start_tcp(int sock);
+    void stop_udp();
+    void stop_tcp();
+    void close_viewers();
 
+    // Reactor callbacks, all on loop_.
+    void on_udp_readable();
+    void on_tcp_accept();
+    void on_viewer_event(Viewer* viewer, std::uint32_t events);
+    void on_viewer_tick();
+    bool flush_viewer(Viewer& viewer);
+    void close_viewer(Viewer* viewer);
+    void publish_status();
+
+    std::mutex control_mutex_;  // serialises start/stop/apply_settings
     settings::BridgeSettings config_;
     logging::Logger& logger_;
+    network::Reactor& reactor_;
+    const std::size_t loop_;
 
     std::atomic<bool> running_{false};
-    int udp_socket_ = -1;
-    int tcp_socket_ = -1;
-    std::thread udp_thread_;
-    std::thread tcp_thread_;
+    std::atomic<int> udp_socket_{-1};
+    std::atomic<int> tcp_socket_{-1};
+
+    // Loop-side state.
+    network::EventHandle udp_event_;
+    network::EventHandle tcp_event_;
+    network::EventHandle viewer_timer_;
+    std::vector<std::unique_ptr<Viewer>> viewers_;
+    std::vector<std::uint8_t> buffer_;
+
+    std::atomic<const PoseHistory*> pose_source_{nullptr};
 
     mutable std::mutex frame_mutex_;
-    std::vector<std::uint8_t> last_frame_;
-    std::chrono::system_clock::time_point last_frame_time_{};
-    std::size_t tcp_clients_ = 0;
+    std::shared_ptr<const std::vector<std::uint8_t>> last_frame_;
+    FrameMetadata last_frame_meta_{};
+
+    metrics::Counter& frames_received_;
+    metrics::Counter& bytes_received_;
+    metrics::Counter& receive_errors_;
+    metrics::Counter& bytes_sent_;
+    metrics::Gauge& tcp_clients_;
+    metrics::LatencyHistogram& frame_interval_;
+    std::atomic<std::int64_t> last_frame_steady_ns_{0};
+    metrics::ObserverHandle frame_age_;
+
+    // Status feed, loop-side. The timer is declared last so it is removed
+    // before anything its callback reads is destroyed.
+    StatusFeed* feed_ = nullptr;
+    std::int64_t published_ns_ = 0;
+    std::uint64_t published_frames_ = 0;
+    std::uint64_t published_bytes_ = 0;
+    network::EventHandle feed_timer_;
 };
 
 }  // namespace core
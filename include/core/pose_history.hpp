@@ -0,0 +1,56 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "core/gimbal_pose.hpp"
+
+namespace core {
+
+struct PoseSample {
+    std::int64_t time_ns = 0;  // steady_clock
+    GimbalPose pose{};
+};
+
+// Single-writer ring of timestamped poses. Each slot is a seqlock whose
+// sequence also encodes the logical sample index, so readers detect both torn
+// reads and slots recycled by the writer without ever taking a lock.
+class PoseHistory {
+public:
+    static constexpr std::size_t kCapacity = 1024;
+
+    // Writer side; timestamps must be non-decreasing.
+    void push(std::int64_t time_ns, const GimbalPose& pose);
+
+    // Pose linearly interpolated at `time_ns` (O(log n)). Times past the newest
+    // sample clamp to it for up to the maximum extrapolation age and fail
+    // beyond it, as do times older than the retained window.
+    bool pose_at(std::int64_t time_ns, GimbalPose& out) const;
+    // Usually two writer periods, so a stalled writer stops vouching for its
+    // last pose. Defaults to 100 ms (two periods at 20 Hz).
+    void set_max_extrapolation(std::int64_t age_ns);
+    bool latest(PoseSample& out) const;
+    std::size_t size() const;
+
+private:
+    struct Slot {
+        std::atomic<std::uint64_t> sequence{0};
+        std::atomic<std::int64_t> time_ns{0};
+        std::atomic<double> yaw{0.0};
+        std::atomic<double> pitch{0.0};
+        std::atomic<double> roll{0.0};
+        std::atomic<double> zoom{1.0};
+    };
+
+    enum class ReadResult { Ok, Overwritten };
+
+    ReadResult read(std::uint64_t index, PoseSample& out) const;
+
+    std::array<Slot, kCapacity> slots_{};
+    std::atomic<std::uint64_t> head_{0};
+    std::atomic<std::int64_t> max_extrapolation_ns_{100'000'000};
+};
+
+}  // namespace core
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#include "core/gimbal_pose.hpp"
+#include "utils/mpsc_queue.hpp"
+
+namespace core {
+
+// One module's activity since its previous delta, cut on the module's own
+// reactor loop every StatusFeed::kPublishPeriod.
+struct StatusDelta {
+    enum class Source : std::uint8_t { Relay, Image, Gimbal };
+
+    Source source = Source::Relay;
+    bool running = false;
+    std::int64_t steady_ns = 0;    // end of the interval
+    std::int64_t interval_ns = 0;  // length of the interval
+    std::uint64_t packets = 0;     // relay: datagrams forwarded, image: frames received
+    std::uint64_t bytes = 0;
+    std::int64_t frame_age_ns = -1;  // image only; < 0 before the first frame
+    GimbalPose pose{};               // gimbal only: last commanded pose
+};
+
+// Push channel from the bridge modules to a single consumer (the GUI). The
+// modules publish from a reactor timer off their hot paths, so attaching a
+// feed adds no work per datagram and no locks; a consumer that falls a full
+// ring behind loses deltas (counted in dropped()) rather than stalling them.
+class StatusFeed {
+public:
+    static constexpr std::chrono::milliseconds kPublishPeriod{100};
+
+    explicit StatusFeed(std::size_t capacity = 256);
+
+    StatusFeed(const StatusFeed&) = delete;
+    StatusFeed& operator=(const StatusFeed&) = delete;
+
+    // Any thread; never blocks.
+    bool publish(const StatusDelta& delta);
+
+    // Consumer only. Calls `fn(const StatusDelta&)` for every queued delta
+    // and returns how many there were.
+    template <typename Fn>
+    std::size_t drain(Fn&& fn) {
+        std::size_t count = 0;
+        StatusDelta delta;
+        while (queue_.try_pop(delta)) {
+            fn(delta);
+            ++count;
+        }
+        queue_.publish_consumer_position();
+        return count;
+    }
+
+    std::uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+    utils::MpscQueue<StatusDelta> queue_;
+    std::atomic<std::uint64_t> dropped_{0};
+};
+
+}  // namespace core
@@ -1,73 +1,199 @@
 #pragma once
 
+#include <array>
 #include <atomic>
+#include <chrono>
 #include <cstdint>
+#include <fstream>
+#include <functional>
+#include <memory>
 #include <mutex>
 #include <string>
 #include <thread>
 #include <vector>
-#include <fstream>
 
+#include "core/status_feed.hpp"
+#include "network/reactor.hpp"
 #include "network/socket_endpoint.hpp"
+#include "network/socket_utils.hpp"
 #include "utils/logger.hpp"
+#include "utils/metrics.hpp"
+#include "utils/mpsc_queue.hpp"
 #include "utils/settings.hpp"
 
 namespace core {
 
+struct RelayDestinationStatus {
+    std::size_t sent_packets = 0;
+    std::size_t dropped_packets = 0;  // backlog overflow
+    std::size_t send_errors = 0;
+    std::size_t queued_packets = 0;
+};
+
 struct RelayStatus {
     bool running = false;
     std::size_t forwarded_packets = 0;
     std::size_t forwarded_bytes = 0;
+    RelayDestinationStatus raw;
+    RelayDestinationStatus proc;
 };
 
 class RoverRelayLogger;
 
 class UdpRelay {
 public:
-    UdpRelay(const settings::RelaySettings& cfg, logging::Logger& logger, RoverRelayLogger* rover_logger);
+    UdpRelay(const settings::RelaySettings& cfg, network::Reactor& reactor, logging::Logger& logger,
+             RoverRelayLogger* rover_logger);
     ~UdpRelay();
 
     void start();
     void stop();
 
+    // Applies edited settings while running: new destinations take effect
+    // before the next datagram, a changed bind address reopens the socket
+    // and `enable` starts or stops the relay. `log_packets` is only read
+    // when the packet logger is created at startup. A destination that could
+    // not be opened is retried on every call, even with unchanged settings.
+    bool apply_settings(const settings::RelaySettings& cfg);
+
     RelayStatus status() const;
 
-private:
-    void worker();
+    // Publishes a StatusDelta from the relay's loop every
+    // StatusFeed::kPublishPeriod; nullptr detaches. `feed` must stay alive
+    // until it is detached or this object is destroyed.
+    void set_status_feed(StatusFeed* feed);
 
+    // Reactor loop the relay's socket runs on.
+    std::size_t loop() const { return loop_; }
+
+private:
+    bool open_socket(const settings::RelaySettings& cfg);
+    void close_socket();
+    void load_destinations(const settings::RelaySettings& cfg);
+    settings::RelaySettings config_snapshot() const;
+
+    void on_readable();
+
+    // Per-destination sending (udp_relay.cpp), all loop-side. A datagram
+    // goes straight to the destination's socket unless that destination
+    // already has a backlog; it is queued only when the socket buffer is full.
+    struct Destination;
+    struct DestinationMetrics {
+        metrics::Counter& sent_packets;
+        metrics::Counter& sent_bytes;
+        metrics::Counter& dropped;
+        metrics::Counter& send_errors;
+        metrics::Gauge& queued;
+    };
+    static DestinationMetrics destination_metrics(const char* role);
+    void forward(Destination& dest, const std::uint8_t* data, std::size_t bytes);
+    bool send_now(Destination& dest, const std::uint8_t* data, std::size_t bytes);
+    void enqueue(Destination& dest, const std::uint8_t* data, std::size_t bytes);
+    void flush(Destination& dest);
+
+    // io_uring path, used when the reactor asks for it and a ring can be
+    // set up; its state lives in UringPath (udp_relay.cpp).
+    struct UringPath;
+    bool open_uring();
+    void close_uring();
+    void arm_uring_recv();
+    void on_uring_ready();
+    void forward_uring(std::uint16_t buffer, std::size_t bytes);
+    void send_held();
+    void finish_uring_batch(std::size_t index, bool forward);
+    void handle_uring_completion(std::uint64_t user_data, std::int32_t res, std::uint32_t flags, bool forward);
+
+    void publish_status();
+
+    std::mutex control_mutex_;  // serialises start/stop/apply_settings
+    mutable std::mutex config_mutex_;
     settings::RelaySettings config_;
     logging::Logger& logger_;
     RoverRelayLogger* rover_logger_;
+    network::Reactor& reactor_;
+    const std::size_t loop_;
 
     std::atomic<bool> running_{false};
-    std::thread worker_thread_;
 
-    mutable std::mutex stats_mutex_;
-    std::size_t forwarded_packets_ = 0;
-    std::size_t forwarded_bytes_ = 0;
+    // Loop-side state, only touched on the reactor loop (or through run_sync).
+    int socket_ = -1;
+    network::EventHandle event_;
+    std::array<std::unique_ptr<Destination>, 2> destinations_;  // raw, proc
+    std::vector<std::uint8_t> buffer_;
+    std::unique_ptr<UringPath> uring_;
+
+    metrics::Counter& forwarded_packets_;
+    metrics::Counter& forwarded_bytes_;
+    metrics::Counter& receive_errors_;
+    metrics::Counter& send_errors_;
+    std::array<DestinationMetrics, 2> destination_metrics_;  // raw, proc
+
+    // Status feed, loop-side. The timer is declared last so it is removed
+    // before anything its callback reads is destroyed.
+    StatusFeed* feed_ = nullptr;
+    std::int64_t published_ns_ = 0;
+    std::uint64_t published_packets_ = 0;
+    std::uint64_t published_bytes_ = 0;
+    network::EventHandle feed_timer_;
 };
 
+// Packet recorder. log_packet() only copies the datagram into a lock-free
+// queue; the "packet-log" thread hex-formats and writes it, so neither
+// formatting nor disk I/O runs on the relay's loop. When the writer falls
+// behind, packets are dropped from the log (never from the relay) and the
+// count is written to the file.
 class RoverRelayLogger {
 public:
-    RoverRelayLogger(logging::Logger& logger, std::string directory);
+    RoverRelayLogger(logging::Logger& logger, std::string directory,
+                     std::function<void()> on_thread_start = nullptr);
     ~RoverRelayLogger();
 
     void start();
     void stop();
-    void log_packet(const std::vector<std::uint8_t>& packet);
+    void log_packet(const std::uint8_t* data, std::size_t size);
 
     bool active() const;
     std::size_t lines_written() const;
+    std::size_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
 
 private:
+    // Datagrams up to kInlineCapacity bytes are copied into the queue cell
+    // itself, so logging a typical packet never allocates.
+    struct PacketRecord {
+        static constexpr std::size_t kInlineCapacity = 512;
+
+        std::chrono::system_clock::time_point time{};
+        std::size_t size = 0;
+        std::uint8_t inline_bytes[kInlineCapacity];
+        std::vector<std::uint8_t> overflow;
+
+        const std::uint8_t* data() const { return overflow.empty() ? inline_bytes : overflow.data(); }
+    };
+
+    void run();
+    bool drain();
+    void append(const PacketRecord& record);
+    void write_batch(bool force_flush);
     void open_file();
     void close_file();
 
     logging::Logger& logger_;
     std::string directory_;
+    std::function<void()> on_thread_start_;
+    utils::MpscQueue<PacketRecord> queue_;
+    std::thread thread_;
+
+    // Writer-thread state.
     std::ofstream file_;
+    std::string batch_;
+    std::chrono::steady_clock::time_point last_flush_{};
+    std::size_t reported_drops_ = 0;
+
     std::atomic<bool> active_{false};
+    std::atomic<bool> running_{false};
     std::atomic<std::size_t> lines_{0};
+    std::atomic<std::size_t> dropped_{0};
+    metrics::Counter& dropped_total_;
 };
 
 }  // namespace core
@@ -0,0 +1,108 @@
+#pragma once
+
+// Only built when CMake finds <linux/io_uring.h> with multishot receive
+// (BRIDGE_HAVE_IO_URING); include it behind that guard.
+
+#include <linux/io_uring.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace network {
+
+// Minimal io_uring instance over the raw syscalls, so there is no liburing
+// dependency. Single issuer: every call must come from the thread that owns
+// the ring (for the bridge modules, their reactor loop). The ring fd polls
+// readable while completions are pending, so it can be registered with the
+// Reactor like any socket.
+class IoUring {
+public:
+    // Throws std::runtime_error when the kernel refuses (ENOSYS, EPERM under
+    // seccomp or io_uring_disabled, ...); callers fall back to epoll.
+    explicit IoUring(unsigned entries);
+    ~IoUring();
+
+    IoUring(const IoUring&) = delete;
+    IoUring& operator=(const IoUring&) = delete;
+
+    int fd() const { return fd_; }
+
+    // Zeroed SQE, or nullptr when the submission queue is full (submit() and
+    // retry).
+    io_uring_sqe* get_sqe();
+    // Hands queued SQEs to the kernel; returns the count or -errno.
+    int submit();
+    // Submits and blocks until at least `min_complete` CQEs are ready.
+    int submit_and_wait(unsigned min_complete);
+
+    // Calls `fn(const io_uring_cqe&)` for every ready completion, then
+    // releases them. Returns the number seen.
+    template <typename Fn>
+    unsigned drain(Fn&& fn) {
+        unsigned head = *cq_head_;
+        const unsigned tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+        unsigned seen = 0;
+        for (; head != tail; ++head, ++seen) fn(cqes_[head & *cq_mask_]);
+        __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+        return seen;
+    }
+
+private:
+    int enter(unsigned to_submit, unsigned min_complete, unsigned flags);
+
+    int fd_ = -1;
+    void* sq_ring_ = nullptr;
+    std::size_t sq_ring_size_ = 0;
+    void* cq_ring_ = nullptr;
+    std::size_t cq_ring_size_ = 0;
+    io_uring_sqe* sqes_ = nullptr;
+    std::size_t sqes_size_ = 0;
+
+    unsigned* sq_head_ = nullptr;
+    unsigned* sq_tail_ = nullptr;
+    unsigned* sq_mask_ = nullptr;
+    unsigned* sq_array_ = nullptr;
+    unsigned sq_entries_ = 0;
+    unsigned sqe_tail_ = 0;  // local tail, published by submit()
+
+    unsigned* cq_head_ = nullptr;
+    unsigned* cq_tail_ = nullptr;
+    unsigned* cq_mask_ = nullptr;
+    io_uring_cqe* cqes_ = nullptr;
+};
+
+// Provided-buffer ring registered with an IoUring: the kernel picks a buffer
+// from group `group` for each IOSQE_BUFFER_SELECT receive and reports its id
+// in the CQE flags, so a multishot receive never waits for user space to
+// post a buffer. Buffers return to the kernel through recycle().
+class BufferRing {
+public:
+    // `count` must be a power of two.
+    BufferRing(IoUring& ring, std::uint16_t group, unsigned count, std::size_t buffer_size);
+    ~BufferRing();
+
+    BufferRing(const BufferRing&) = delete;
+    BufferRing& operator=(const BufferRing&) = delete;
+
+    std::uint16_t group() const { return group_; }
+    std::uint8_t* data(std::uint16_t id) { return storage_.data() + static_cast<std::size_t>(id) * buffer_size_; }
+    void recycle(std::uint16_t id);
+
+private:
+    void add(std::uint16_t id);
+    void publish();
+
+    IoUring& ring_;
+    std::uint16_t group_;
+    unsigned count_;
+    std::size_t buffer_size_;
+    std::vector<std::uint8_t> storage_;
+    // Laid out as io_uring_buf_ring, but indexed as a plain array: in C++ the
+    // header's flexible-array wrapper adds an empty struct that shifts bufs[].
+    io_uring_buf* bufs_ = nullptr;
+    std::size_t buf_ring_size_ = 0;
+    std::uint16_t tail_ = 0;
+};
+
+}  // namespace network
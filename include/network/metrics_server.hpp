@@ -0,0 +1,46 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+#include "utils/logger.hpp"
+#include "utils/metrics.hpp"
+
+namespace network {
+
+// Minimal HTTP/1.1 endpoint for scrapers: `GET /metrics` returns the registry
+// in OpenMetrics text, anything else gets 404. Requests are served one at a
+// time on a single thread; rendering only takes the registry mutex, never a
+// module lock, so a scrape does not stall forwarding.
+class MetricsServer {
+public:
+    MetricsServer(std::string bind_ip, int port, metrics::Registry& registry, logging::Logger& logger);
+    ~MetricsServer();
+
+    MetricsServer(const MetricsServer&) = delete;
+    MetricsServer& operator=(const MetricsServer&) = delete;
+
+    bool start();
+    void stop();
+
+    bool running() const { return running_; }
+
+private:
+    void serve();
+    void handle_client(int client_fd);
+
+    std::string bind_ip_;
+    int port_;
+    metrics::Registry& registry_;
+    logging::Logger& logger_;
+
+    std::atomic<bool> running_{false};
+    std::atomic<int> socket_{-1};
+    std::thread thread_;
+    std::string body_;      // reused between scrapes
+    std::string response_;
+};
+
+}  // namespace network
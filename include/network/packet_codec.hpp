@@ -0,0 +1,159 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace network {
+namespace codec {
+
+enum class Endian { Big, Little };
+
+// One fixed-width integer on the wire. Encoding stores trunc(value * scale);
+// decoding returns raw / scale.
+struct Field {
+    std::size_t offset = 0;
+    std::size_t width = 4;
+    double scale = 1.0;
+    Endian endian = Endian::Big;
+    bool is_signed = true;
+};
+
+constexpr Field be_int(std::size_t offset, std::size_t width, double scale = 1.0) {
+    return Field{offset, width, scale, Endian::Big, true};
+}
+
+constexpr Field be_uint(std::size_t offset, std::size_t width, double scale = 1.0) {
+    return Field{offset, width, scale, Endian::Big, false};
+}
+
+constexpr Field le_int(std::size_t offset, std::size_t width, double scale = 1.0) {
+    return Field{offset, width, scale, Endian::Little, true};
+}
+
+constexpr Field le_uint(std::size_t offset, std::size_t width, double scale = 1.0) {
+    return Field{offset, width, scale, Endian::Little, false};
+}
+
+template <std::size_t Size, std::size_t N>
+struct Layout {
+    static constexpr std::size_t size = Size;
+    static constexpr std::size_t field_count = N;
+    std::array<Field, N> fields;
+};
+
+template <std::size_t Size, typename... Fields>
+constexpr Layout<Size, sizeof...(Fields)> make_layout(Fields... fields) {
+    return Layout<Size, sizeof...(Fields)>{{{fields...}}};
+}
+
+// Compile-time sanity check for layout declarations: every field must fit the
+// packet and use a supported width.
+template <std::size_t Size, std::size_t N>
+constexpr bool is_valid(const Layout<Size, N>& layout) {
+    for (std::size_t i = 0; i < N; ++i) {
+        const Field& f = layout.fields[i];
+        if (f.width != 1 && f.width != 2 && f.width != 4 && f.width != 8) return false;
+        if (f.offset + f.width > Size) return false;
+        if (f.scale == 0.0) return false;
+    }
+    return true;
+}
+
+struct ByteSpan {
+    std::uint8_t* data = nullptr;
+    std::size_t size = 0;
+};
+
+struct ConstByteSpan {
+    constexpr ConstByteSpan() = default;
+    constexpr ConstByteSpan(const std::uint8_t* bytes, std::size_t length) : data(bytes), size(length) {}
+    constexpr ConstByteSpan(ByteSpan span) : data(span.data), size(span.size) {}
+
+    const std::uint8_t* data = nullptr;
+    std::size_t size = 0;
+};
+
+template <std::size_t Size>
+constexpr ByteSpan span_of(std::array<std::uint8_t, Size>& buffer) {
+    return ByteSpan{buffer.data(), Size};
+}
+
+template <std::size_t Size>
+constexpr ConstByteSpan span_of(const std::array<std::uint8_t, Size>& buffer) {
+    return ConstByteSpan{buffer.data(), Size};
+}
+
+inline void store_raw(const Field& field, std::uint8_t* base, std::uint64_t raw) {
+    std::uint8_t* dst = base + field.offset;
+    for (std::size_t i = 0; i < field.width; ++i) {
+        std::size_t shift = 8 * (field.endian == Endian::Big ? field.width - 1 - i : i);
+        dst[i] = static_cast<std::uint8_t>((raw >> shift) & 0xFF);
+    }
+}
+
+inline std::uint64_t load_raw(const Field& field, const std::uint8_t* base) {
+    const std::uint8_t* src = base + field.offset;
+    std::uint64_t raw = 0;
+    for (std::size_t i = 0; i < field.width; ++i) {
+        std::size_t shift = 8 * (field.endian == Endian::Big ? field.width - 1 - i : i);
+        raw |= static_cast<std::uint64_t>(src[i]) << shift;
+    }
+    return raw;
+}
+
+inline void encode_field(const Field& field, std::uint8_t* base, double value) {
+    double scaled = value * field.scale;
+    // Clamp before converting so out-of-range inputs stay well defined.
+    scaled = std::clamp(scaled, -9.2e18, 9.2e18);
+    if (scaled != scaled) scaled = 0.0;
+    auto raw = static_cast<std::uint64_t>(static_cast<std::int64_t>(scaled));
+    store_raw(field, base, raw);
+}
+
+inline double decode_field(const Field& field, const std::uint8_t* base) {
+    std::uint64_t raw = load_raw(field, base);
+    if (field.is_signed && field.width < 8) {
+        std::uint64_t sign_bit = std::uint64_t{1} << (8 * field.width - 1);
+        if (raw & sign_bit) {
+            raw |= ~((sign_bit << 1) - 1);
+        }
+    }
+    double value = field.is_signed ? static_cast<double>(static_cast<std::int64_t>(raw)) : static_cast<double>(raw);
+    return value / field.scale;
+}
+
+// Zero-fills Layout::size bytes of `out` and writes one value per field, in
+// declaration order. Returns the encoded size, or 0 if `out` is too small.
+template <std::size_t Size, std::size_t N, typename... Values>
+std::size_t encode(const Layout<Size, N>& layout, ByteSpan out, Values... values) {
+    static_assert(sizeof...(Values) == N, "value count must match the layout field count");
+    if (out.data == nullptr || out.size < Size) return 0;
+    std::memset(out.data, 0, Size);
+    const double scalars[] = {static_cast<double>(values)...};
+    for (std::size_t i = 0; i < N; ++i) {
+        encode_field(layout.fields[i], out.data, scalars[i]);
+    }
+    return Size;
+}
+
+// Decodes every field of `layout` into `out`; returns false if `in` is short.
+template <std::size_t Size, std::size_t N>
+bool decode(const Layout<Size, N>& layout, ConstByteSpan in, std::array<double, N>& out) {
+    if (in.data == nullptr || in.size < Size) return false;
+    for (std::size_t i = 0; i < N; ++i) {
+        out[i] = decode_field(layout.fields[i], in.data);
+    }
+    return true;
+}
+
+template <std::size_t Size, std::size_t N>
+double decode_one(const Layout<Size, N>& layout, ConstByteSpan in, std::size_t index, double fallback = 0.0) {
+    if (index >= N || in.data == nullptr || in.size < Size) return fallback;
+    return decode_field(layout.fields[index], in.data);
+}
+
+}  // namespace codec
+}  // namespace network
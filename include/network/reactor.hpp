@@ -0,0 +1,117 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace network {
+
+class Reactor;
+
+// I/O path for the modules' hot sockets. IoUring is honoured by modules that
+// implement it when the build found <linux/io_uring.h> and the kernel allows
+// it; everything else, and any module that cannot set up a ring, uses the
+// reactor's epoll/poll readiness callbacks.
+enum class IoBackend { Epoll, IoUring };
+
+// "io_uring" selects IoUring; anything else is Epoll.
+IoBackend parse_io_backend(const std::string& name);
+const char* io_backend_name(IoBackend backend);
+
+// Owns one socket or timer registration; removes it on destruction. Moving
+// transfers ownership, reset() removes early.
+class EventHandle {
+public:
+    EventHandle() = default;
+    EventHandle(Reactor* reactor, std::uint64_t id) : reactor_(reactor), id_(id) {}
+    ~EventHandle() { reset(); }
+
+    EventHandle(EventHandle&& other) noexcept : reactor_(other.reactor_), id_(other.id_) { other.reactor_ = nullptr; }
+    EventHandle& operator=(EventHandle&& other) noexcept;
+    EventHandle(const EventHandle&) = delete;
+    EventHandle& operator=(const EventHandle&) = delete;
+
+    void reset();
+    bool active() const { return reactor_ != nullptr; }
+    std::uint64_t id() const { return id_; }
+
+private:
+    Reactor* reactor_ = nullptr;
+    std::uint64_t id_ = 0;
+};
+
+// Event loop runtime shared by the bridge modules. Each loop thread waits on
+// its own epoll set (poll() off Linux) with an eventfd for wake-ups; sockets
+// and timerfd timers are registered on one loop and their callbacks always
+// run on that loop's thread. A module that keeps every registration on one
+// loop and changes its loop-side state through run_sync() needs no locks
+// between its own callbacks.
+//
+// Callbacks must not block or throw and must not call run_sync() for a
+// different loop. stop() must not be called from a loop thread.
+class Reactor {
+public:
+    using IoCallback = std::function<void(std::uint32_t events)>;
+    using Task = std::function<void()>;
+
+    static constexpr std::uint32_t kReadable = 1;
+    static constexpr std::uint32_t kWritable = 2;
+
+    explicit Reactor(std::size_t loop_threads = 1, IoBackend io_backend = IoBackend::Epoll);
+    ~Reactor();
+
+    Reactor(const Reactor&) = delete;
+    Reactor& operator=(const Reactor&) = delete;
+
+    void start();
+    // Wakes every loop, lets it finish queued tasks and joins its thread.
+    // Registrations stay in place; their callbacks just stop running.
+    void stop();
+
+    std::size_t loop_count() const { return loops_.size(); }
+    IoBackend io_backend() const { return io_backend_; }
+    // Round-robin loop for a new module.
+    std::size_t next_loop();
+    bool in_loop(std::size_t loop) const;
+
+    // `fd` must be non-blocking and stays owned by the caller. Errors and
+    // hang-ups are reported as readable|writable so the next recv/send sees
+    // them.
+    EventHandle add_socket(std::size_t loop, int fd, std::uint32_t events, IoCallback callback);
+    void set_events(const EventHandle& handle, std::uint32_t events);
+
+    // Repeating timer, first expiry one period from now. Expiries missed
+    // while the loop was busy are folded into one callback.
+    EventHandle add_timer(std::size_t loop, std::chrono::nanoseconds period, Task callback);
+
+    // Once this returns the callback is not running and never runs again
+    // (called from inside that callback, it just won't run again).
+    void remove(std::uint64_t id);
+
+    void post(std::size_t loop, Task task);
+    // Runs `task` on the loop and waits for it; runs inline on that loop's
+    // own thread or once stop() has joined the loop thread (until then, a
+    // stopping loop still runs it on its own thread).
+    void run_sync(std::size_t loop, const Task& task);
+
+private:
+    struct Entry;
+    struct Loop;
+
+    void run_loop(Loop& loop);
+    void wake(Loop& loop);
+    void run_tasks(Loop& loop);
+    Loop& loop_of(std::uint64_t id) const;
+
+    const IoBackend io_backend_;
+    std::vector<std::unique_ptr<Loop>> loops_;
+    std::atomic<std::size_t> next_loop_{0};
+    std::atomic<std::uint64_t> next_id_{1};
+};
+
+}  // namespace network
@@ -1,12 +1,14 @@
 #pragma once
 
 #include <cstdint>
+#include <iosfwd>
 #include <string>
 
 #ifdef _WIN32
 #include <winsock2.h>
 #else
 #include <netinet/in.h>
+#include <sys/socket.h>
 #endif
 
 namespace network {
@@ -16,8 +18,39 @@ int create_tcp_socket();
 
 void close_socket(int fd);
 
+// Wakes threads blocked in recv/accept on `fd` (close() alone does not on
+// Linux). The descriptor stays open; close it after joining the reader.
+void shutdown_socket(int fd);
+
+bool set_receive_timeout(int fd, int timeout_ms);
+
+// Reactor-registered sockets must never block the loop thread.
+bool set_nonblocking(int fd);
+
+// Flags for send() on TCP sockets: a viewer that disconnects mid-frame must
+// show up as an error return rather than a SIGPIPE that kills the process.
+#ifdef MSG_NOSIGNAL
+constexpr int kStreamSendFlags = MSG_NOSIGNAL;
+#else
+constexpr int kStreamSendFlags = 0;
+#endif
+
 sockaddr_in make_address(const std::string& ip, std::uint16_t port);
 
 std::string describe_endpoint(const std::string& ip, std::uint16_t port);
 
+// errno / WSAGetLastError() captured right after a failed call. Only an int
+// is copied, so it can be handed to a log call that may be suppressed; the
+// text is produced when (and if) the message is formatted.
+struct SocketError {
+    int code = 0;
+};
+
+SocketError last_socket_error();
+
+// True for EAGAIN/EWOULDBLOCK: a non-blocking socket has nothing to read or
+// no room to write right now.
+bool would_block(const SocketError& error);
+std::ostream& operator<<(std::ostream& os, const SocketError& error);
+
 }  // namespace network
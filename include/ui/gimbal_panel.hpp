@@ -0,0 +1,70 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+
+#include <QGroupBox>
+
+#include "core/gimbal_control.hpp"
+
+class QFocusEvent;
+class QKeyEvent;
+class QLabel;
+class QSlider;
+class QTimer;
+
+namespace ui {
+
+// Interactive gimbal steering: yaw/pitch/roll/zoom sliders plus held-key
+// jogging (arrows, Q/E, +/-). Every change goes through
+// GimbalControl::steer(), which only stores the newest target; the sender
+// applies it once per tick, so dragging or holding a key never queues work
+// on the gimbal loop. Pose changes made elsewhere (move_to(), hold(), ...)
+// discard a pending steer and are mirrored back onto the sliders.
+class GimbalPanel : public QGroupBox {
+    Q_OBJECT
+
+public:
+    explicit GimbalPanel(core::GimbalControl& gimbal, QWidget* parent = nullptr);
+
+public slots:
+    // Moves the sliders to the currently commanded pose without steering.
+    void sync_from_gimbal();
+
+protected:
+    void keyPressEvent(QKeyEvent* event) override;
+    void keyReleaseEvent(QKeyEvent* event) override;
+    void focusOutEvent(QFocusEvent* event) override;
+
+private slots:
+    void on_slider_changed();
+    void jog();
+    void check_overrides();
+    void center();
+    void stop_motion();
+
+private:
+    enum Axis { Yaw, Pitch, Roll, Zoom, kAxisCount };
+
+    bool set_jog(QKeyEvent* event, bool pressed);
+    core::GimbalPose slider_pose() const;
+    void set_sliders(const core::GimbalPose& pose);
+    void update_value_labels();
+    void steer_to_sliders();
+
+    core::GimbalControl& gimbal_;
+    std::array<QSlider*, kAxisCount> sliders_{};
+    std::array<QLabel*, kAxisCount> values_{};
+
+    QTimer* jog_timer_ = nullptr;
+    std::array<int, kAxisCount> jog_direction_{};  // -1, 0 or +1 per axis
+    bool jog_fast_ = false;
+    std::chrono::steady_clock::time_point last_jog_{};
+
+    QTimer* sync_timer_ = nullptr;
+    std::uint64_t seen_overrides_ = 0;
+    bool following_ = false;  // sliders track the gimbal until it settles
+};
+
+}  // namespace ui
@@ -1,16 +1,24 @@
 #pragma once
 
+#include <limits>
 #include <memory>
 
 #include <QMainWindow>
 
 #include "core/gimbal_control.hpp"
 #include "core/image_stream_bridge.hpp"
+#include "core/status_feed.hpp"
 #include "core/udp_relay.hpp"
+#include "ui/gimbal_panel.hpp"
 #include "ui/module_config_dialog.hpp"
+#include "ui/preview_decoder.hpp"
+#include "ui/sparkline.hpp"
 #include "utils/settings.hpp"
 
 class QLabel;
+class QResizeEvent;
+class QShowEvent;
+class QThread;
 class QTimer;
 
 namespace settings {
@@ -29,18 +37,33 @@ public:
                core::GimbalControl& gimbal_control,
                core::UdpRelay& udp_relay,
                QWidget* parent = nullptr);
+    ~MainWindow() override;
+
+public slots:
+    // Re-reads config.json and applies whatever changed to the running
+    // modules; a file that fails to parse leaves everything as it is.
+    void reload_config();
 
 private slots:
     void refresh_status();
+    void drain_status_feed();
     void open_image_settings();
     void open_gimbal_settings();
     void open_relay_settings();
+    void show_preview(const QImage& image, quint64 sequence);
+
+protected:
+    void resizeEvent(QResizeEvent* event) override;
+    void showEvent(QShowEvent* event) override;
 
 private:
     QWidget* build_central_widget();
     QWidget* build_image_panel();
     QWidget* build_status_panel();
+    QWidget* build_trend_panel();
     QWidget* build_navigation_panel();
+    void start_preview();
+    void update_preview_size();
 
     void show_status_message(const QString& message);
 
@@ -55,8 +78,25 @@ private:
     QLabel* gimbal_status_ = nullptr;
     QLabel* relay_status_ = nullptr;
     QLabel* last_frame_info_ = nullptr;
+    GimbalPanel* gimbal_panel_ = nullptr;
 
     QTimer* status_timer_ = nullptr;
+
+    // Pushed by the modules from their reactor loops, drained by feed_timer_.
+    core::StatusFeed status_feed_;
+    QTimer* feed_timer_ = nullptr;
+    Sparkline* relay_pps_chart_ = nullptr;
+    Sparkline* relay_mbps_chart_ = nullptr;
+    Sparkline* frame_fps_chart_ = nullptr;
+    Sparkline* frame_age_chart_ = nullptr;
+    Sparkline* pose_chart_ = nullptr;
+    double frame_age_ms_ = std::numeric_limits<double>::quiet_NaN();
+    bool have_pose_ = false;
+    core::GimbalPose pose_{};
+
+    QThread* preview_thread_ = nullptr;
+    PreviewDecoder* preview_decoder_ = nullptr;  // owned by preview_thread_
+    bool has_preview_ = false;
 };
 
 }  // namespace ui
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include <QImage>
+#include <QObject>
+#include <QSize>
+
+#include "core/image_stream_bridge.hpp"
+
+class QTimer;
+
+namespace ui {
+
+// Decodes the bridge's newest JPEG for the main window preview. Lives on its
+// own QThread: it polls ImageStreamBridge::latest_frame() every
+// kPollIntervalMs, lets QImageReader decode straight to the label size and
+// hands the QImage over through the queued frame_ready() signal. Only one
+// image is in flight at a time; frames that arrive while the GUI has not
+// painted the previous one are skipped, so neither the event loop nor the
+// bridge ever queue behind the preview.
+class PreviewDecoder : public QObject {
+    Q_OBJECT
+
+public:
+    static constexpr int kPollIntervalMs = 33;
+
+    explicit PreviewDecoder(core::ImageStreamBridge& image_bridge, QObject* parent = nullptr);
+
+    // Both are safe to call from the GUI thread.
+    void set_target_size(const QSize& size);
+    // Called once the last frame_ready() image is on screen.
+    void frame_shown() { in_flight_.store(false, std::memory_order_release); }
+
+public slots:
+    // Starts polling; connect to QThread::started.
+    void start();
+
+signals:
+    void frame_ready(const QImage& image, quint64 sequence);
+
+private slots:
+    void poll();
+
+private:
+    core::ImageStreamBridge& image_bridge_;
+    QTimer* poll_timer_ = nullptr;
+    std::uint64_t last_sequence_ = 0;
+    QSize decoded_for_;
+
+    std::atomic<int> target_width_{0};
+    std::atomic<int> target_height_{0};
+    std::atomic<bool> in_flight_{false};
+};
+
+}  // namespace ui
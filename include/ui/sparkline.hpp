@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include <QColor>
+#include <QString>
+#include <QWidget>
+
+class QPaintEvent;
+
+namespace ui {
+
+// Small line chart over a fixed number of samples. Every series keeps its
+// own ring of `capacity` values, so memory never grows with uptime; NaN
+// samples leave a gap. The y axis fits the visible samples (and includes
+// zero unless `zero_based` is false).
+class Sparkline : public QWidget {
+    Q_OBJECT
+
+public:
+    Sparkline(const QString& title, const QString& unit, std::size_t capacity, QWidget* parent = nullptr);
+
+    // Returns the index to pass to append().
+    int add_series(const QString& name, const QColor& color);
+    void append(int series, double value);
+    void set_zero_based(bool zero_based) { zero_based_ = zero_based; }
+    void set_precision(int decimals) { precision_ = decimals; }
+
+    QSize sizeHint() const override;
+    QSize minimumSizeHint() const override;
+
+protected:
+    void paintEvent(QPaintEvent* event) override;
+
+private:
+    struct Series {
+        QString name;
+        QColor color;
+        std::vector<double> values;  // ring, `next` is the oldest once full
+        std::size_t next = 0;
+        std::size_t count = 0;
+
+        double at(std::size_t i) const;  // 0 = oldest retained sample
+        double latest() const;
+    };
+
+    QString title_;
+    QString unit_;
+    std::size_t capacity_;
+    bool zero_based_ = true;
+    int precision_ = 1;
+    std::vector<Series> series_;
+};
+
+}  // namespace ui
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <thread>
+
+#include "utils/mpsc_queue.hpp"
+
+namespace logging {
+
+enum class Level;
+
+struct AsyncOptions {
+    std::size_t queue_capacity = 4096;
+    std::chrono::milliseconds flush_interval{200};
+    bool console = true;
+    std::string file_path;  // empty disables file output
+    std::size_t max_file_bytes = 10 * 1024 * 1024;
+    int max_files = 5;
+    std::function<void()> on_thread_start;  // runs first on the writer thread (affinity, priority)
+};
+
+// Messages up to kInlineCapacity bytes are copied into the queue cell itself,
+// so enqueueing a short record never allocates.
+struct LogRecord {
+    static constexpr std::size_t kInlineCapacity = 200;
+
+    std::chrono::system_clock::time_point time{};
+    Level level{};
+    std::uint16_t inline_length = 0;
+    char inline_text[kInlineCapacity];
+    std::string overflow;
+
+    void set_message(std::string_view message);
+    std::string_view message() const;
+};
+
+// Background writer: drains records from a lock-free MPSC queue, formats the
+// timestamp/prefix off the caller's thread and batches console/file writes.
+class AsyncLogWriter {
+public:
+    AsyncLogWriter(std::string name, AsyncOptions options);
+    ~AsyncLogWriter();
+
+    void start();
+    void stop();
+
+    bool push(Level level, std::string_view message);
+
+    std::size_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+    std::size_t written() const { return written_.load(std::memory_order_relaxed); }
+    std::size_t queue_depth() const { return queue_.size_approx(); }
+
+private:
+    void run();
+    bool drain();
+    void append(const LogRecord& record);
+    void write_batch(bool force_flush);
+    void open_file();
+    void rotate_file();
+
+    std::string name_;
+    AsyncOptions options_;
+    utils::MpscQueue<LogRecord> queue_;
+
+    std::atomic<bool> running_{false};
+    std::thread thread_;
+
+    std::string batch_;
+    bool batch_has_error_ = false;
+    std::ofstream file_;
+    std::size_t file_bytes_ = 0;
+    std::chrono::steady_clock::time_point last_flush_{};
+
+    std::atomic<std::size_t> dropped_{0};
+    std::atomic<std::size_t> written_{0};
+    std::size_t reported_drops_ = 0;
+};
+
+}  // namespace logging
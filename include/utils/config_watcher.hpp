@@ -0,0 +1,44 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <string>
+#include <thread>
+
+#include "utils/logger.hpp"
+
+namespace settings {
+
+// Calls `on_change` on a background thread after the config file has been
+// rewritten. On Linux the parent directory is watched with inotify, because
+// atomic_write() replaces the file by renaming a temporary over it; elsewhere
+// the modification time is polled once a second. Bursts of events (an editor
+// writing in several steps) are coalesced into one callback.
+class ConfigWatcher {
+public:
+    ConfigWatcher(std::string path, std::function<void()> on_change, logging::Logger& logger);
+    ~ConfigWatcher();
+
+    ConfigWatcher(const ConfigWatcher&) = delete;
+    ConfigWatcher& operator=(const ConfigWatcher&) = delete;
+
+    void start();
+    void stop();
+
+    bool using_inotify() const { return inotify_fd_ >= 0; }
+
+private:
+    void run_inotify();
+    void run_polling();
+
+    std::string path_;
+    std::function<void()> on_change_;
+    logging::Logger& logger_;
+
+    std::atomic<bool> running_{false};
+    std::thread thread_;
+    int inotify_fd_ = -1;
+};
+
+}  // namespace settings
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace utils {
+
+enum class HexKernel { Scalar, Ssse3, Avx2 };
+
+// Lowercase hex with one space between bytes ("0a ff 10"), the text format of
+// the rover packet log.
+constexpr std::size_t hex_spaced_length(std::size_t size) { return size == 0 ? 0 : 3 * size - 1; }
+
+// Writes hex_spaced_length(size) characters and returns that count. `out`
+// must have room for 3 * size bytes: every kernel also stores the space after
+// the last byte. Picks the widest kernel the CPU supports; an explicitly
+// requested kernel the CPU lacks falls back to a narrower one.
+std::size_t hex_encode_spaced(char* out, const std::uint8_t* data, std::size_t size);
+std::size_t hex_encode_spaced(HexKernel kernel, char* out, const std::uint8_t* data, std::size_t size);
+
+void append_hex_spaced(std::string& out, const std::uint8_t* data, std::size_t size);
+
+bool hex_kernel_supported(HexKernel kernel);
+HexKernel hex_active_kernel();
+const char* hex_kernel_name(HexKernel kernel);
+
+}  // namespace utils
@@ -7,6 +7,8 @@
 
 namespace mini_json {
 
+class Writer;
+
 class Value {
 public:
     using Object = std::map<std::string, Value>;
@@ -40,10 +42,9 @@ public:
     Array& as_array();
 
     std::string dump(int indent = 0) const;
+    void write(Writer& writer) const;
 
 private:
-    std::string dump_impl(int indent, int level) const;
-
     std::variant<std::nullptr_t, bool, double, std::string, Object, Array> data_;
 };
 
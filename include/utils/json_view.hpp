@@ -0,0 +1,119 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+#include "utils/json.hpp"
+
+namespace mini_json {
+
+// Bump allocator for parse trees: nodes are never freed individually, the
+// whole arena goes away with its Document.
+class Arena {
+public:
+    explicit Arena(std::size_t block_size = 64 * 1024);
+
+    Arena(Arena&&) noexcept = default;
+    Arena& operator=(Arena&&) noexcept = default;
+
+    void* allocate(std::size_t bytes, std::size_t align);
+
+    template <typename T>
+    T* allocate_array(std::size_t count) {
+        return static_cast<T*>(allocate(sizeof(T) * count, alignof(T)));
+    }
+
+    std::size_t bytes_reserved() const { return reserved_; }
+
+private:
+    std::vector<std::unique_ptr<unsigned char[]>> blocks_;
+    unsigned char* cursor_ = nullptr;
+    std::size_t remaining_ = 0;
+    std::size_t block_size_;
+    std::size_t reserved_ = 0;
+};
+
+struct ViewMember;
+
+template <typename T>
+struct ViewRange {
+    const T* first = nullptr;
+    std::size_t count = 0;
+
+    const T* begin() const { return first; }
+    const T* end() const { return first + count; }
+    std::size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    const T& operator[](std::size_t index) const { return first[index]; }
+};
+
+// Read-only JSON node. Strings are views into the parsed text when they
+// contain no escapes, otherwise into the arena; containers point at
+// contiguous arena arrays. Valid as long as the Document and its source text.
+class ViewValue {
+public:
+    enum class Type : std::uint8_t { Null, Bool, Number, String, Object, Array };
+
+    Type type() const { return type_; }
+    bool is_null() const { return type_ == Type::Null; }
+    bool is_bool() const { return type_ == Type::Bool; }
+    bool is_number() const { return type_ == Type::Number; }
+    bool is_string() const { return type_ == Type::String; }
+    bool is_object() const { return type_ == Type::Object; }
+    bool is_array() const { return type_ == Type::Array; }
+
+    bool as_bool(bool fallback = false) const { return is_bool() ? boolean_ : fallback; }
+    double as_number(double fallback = 0.0) const { return is_number() ? number_ : fallback; }
+    std::string_view as_string(std::string_view fallback = {}) const {
+        return is_string() ? std::string_view(text_, size_) : fallback;
+    }
+
+    // Empty ranges for non-containers.
+    ViewRange<ViewValue> items() const;
+    ViewRange<ViewMember> members() const;
+
+    // First member with this key (the owning parser keeps the first of
+    // duplicate keys too), or nullptr.
+    const ViewValue* find(std::string_view key) const;
+
+    Value to_value() const;
+
+private:
+    friend class ViewParser;
+
+    Type type_ = Type::Null;
+    bool boolean_ = false;
+    std::size_t size_ = 0;
+    union {
+        double number_ = 0.0;
+        const char* text_;
+        const ViewValue* items_;
+        const ViewMember* members_;
+    };
+};
+
+struct ViewMember {
+    std::string_view key;
+    ViewValue value;
+};
+
+// Single-pass parse of `text`, which must outlive the document. Errors throw
+// std::runtime_error like mini_json::parse().
+class Document {
+public:
+    static Document parse(std::string_view text);
+
+    const ViewValue& root() const { return root_; }
+    std::size_t arena_bytes() const { return arena_.bytes_reserved(); }
+
+private:
+    explicit Document(std::size_t arena_block) : arena_(arena_block) {}
+
+    Arena arena_;
+    ViewValue root_;
+};
+
+}  // namespace mini_json
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <charconv>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace mini_json {
+
+class Value;
+
+// Streaming JSON emitter. Values are appended to one growable string, or
+// buffered and written to a file descriptor, as the calls are made, so large
+// documents never need a Value tree. With the same indent the output matches
+// Value::dump(). Misuse (a value where a key is expected, unbalanced ends)
+// throws std::runtime_error.
+class Writer {
+public:
+    explicit Writer(std::string& out, int indent = 0);
+    // Bytes are written to `fd` whenever the internal buffer passes 64 KB, on
+    // flush() and on destruction; the descriptor stays owned by the caller.
+    explicit Writer(int fd, int indent = 0);
+    ~Writer();
+
+    Writer(const Writer&) = delete;
+    Writer& operator=(const Writer&) = delete;
+
+    Writer& begin_object();
+    Writer& end_object();
+    Writer& begin_array();
+    Writer& end_array();
+
+    Writer& key(std::string_view name);
+
+    Writer& null();
+    Writer& value(std::nullptr_t) { return null(); }
+    Writer& value(bool flag);
+    Writer& value(double number);
+    Writer& value(std::string_view text);
+    Writer& value(const char* text) { return value(std::string_view(text)); }
+    Writer& value(const std::string& text) { return value(std::string_view(text)); }
+    Writer& value(const Value& tree);
+
+    template <typename T, std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, bool>, int> = 0>
+    Writer& value(T number) {
+        begin_value();
+        char buf[24];
+        auto result = std::to_chars(buf, buf + sizeof(buf), number);
+        out_->append(buf, result.ptr);
+        return end_value();
+    }
+
+    template <typename T>
+    Writer& member(std::string_view name, const T& item) {
+        key(name);
+        return value(item);
+    }
+
+    // Descriptor mode: pushes buffered bytes out. Returns false once a write
+    // has failed; string mode always succeeds.
+    bool flush();
+    bool ok() const { return ok_; }
+    std::size_t depth() const { return stack_.size(); }
+
+private:
+    struct Frame {
+        bool object = false;
+        bool after_key = false;
+        std::size_t count = 0;
+    };
+
+    void begin_value();
+    Writer& end_value();
+    Writer& open(char bracket, bool object);
+    Writer& close(char bracket, bool object);
+    void newline();
+    void append_escaped(std::string_view text);
+
+    std::string buffer_;
+    std::string* out_;
+    int fd_ = -1;
+    int indent_ = 0;
+    bool ok_ = true;
+    bool root_done_ = false;
+    std::vector<Frame> stack_;
+};
+
+}  // namespace mini_json
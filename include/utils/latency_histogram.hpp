@@ -0,0 +1,44 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace metrics {
+
+// Log-linear histogram (16 sub-buckets per power of two, ~6% resolution) over
+// nanosecond samples. record() is wait-free and safe from any thread.
+class LatencyHistogram {
+public:
+    static constexpr std::size_t kSubBuckets = 16;
+    static constexpr std::size_t kBucketCount = kSubBuckets + (64 - 4) * kSubBuckets;
+
+    struct Snapshot {
+        std::array<std::uint64_t, kBucketCount> counts{};
+        std::uint64_t count = 0;
+        std::uint64_t sum = 0;
+        std::uint64_t max = 0;
+
+        std::uint64_t percentile(double q) const;
+        double mean() const { return count ? static_cast<double>(sum) / static_cast<double>(count) : 0.0; }
+    };
+
+    void record(std::uint64_t value_ns);
+    void reset();
+
+    Snapshot snapshot() const;
+    std::uint64_t count() const { return count_.load(std::memory_order_relaxed); }
+
+    static std::size_t bucket_index(std::uint64_t value);
+    static std::uint64_t bucket_lower_bound(std::size_t index);
+    static std::uint64_t bucket_upper_bound(std::size_t index);
+
+private:
+    std::array<std::atomic<std::uint64_t>, kBucketCount> buckets_{};
+    std::atomic<std::uint64_t> count_{0};
+    std::atomic<std::uint64_t> sum_{0};
+    std::atomic<std::uint64_t> max_{0};
+};
+
+}  // namespace metrics
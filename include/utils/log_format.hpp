@@ -0,0 +1,121 @@
+#pragma once
+
+#include <charconv>
+#include <cstddef>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+
+namespace logging {
+namespace detail {
+
+constexpr std::size_t count_placeholders(std::string_view fmt) {
+    std::size_t count = 0;
+    for (std::size_t i = 0; i + 1 < fmt.size(); ++i) {
+        if (fmt[i] == '{' && fmt[i + 1] == '}') {
+            ++count;
+            ++i;
+        }
+    }
+    return count;
+}
+
+// Per-thread scratch buffer reused by every *f() call on that thread.
+inline std::string& format_buffer() {
+    thread_local std::string buffer;
+    return buffer;
+}
+
+template <typename T>
+void append_arg(std::string& out, const T& value) {
+    using U = std::decay_t<T>;
+    if constexpr (std::is_same_v<U, std::string> || std::is_same_v<U, std::string_view>) {
+        out.append(value.data(), value.size());
+    } else if constexpr (std::is_same_v<U, const char*> || std::is_same_v<U, char*>) {
+        out.append(value ? value : "(null)");
+    } else if constexpr (std::is_same_v<U, char> || std::is_same_v<U, signed char> ||
+                         std::is_same_v<U, unsigned char>) {
+        out.push_back(static_cast<char>(value));
+    } else if constexpr (std::is_same_v<U, bool>) {
+        out.push_back(value ? '1' : '0');
+    } else if constexpr (std::is_integral_v<U>) {
+        char buf[24];
+        auto result = std::to_chars(buf, buf + sizeof(buf), value);
+        out.append(buf, result.ptr);
+    } else if constexpr (std::is_floating_point_v<U>) {
+        // Same text as the default ostream formatting (%g, precision 6).
+        char buf[32];
+        auto result = std::to_chars(buf, buf + sizeof(buf), value, std::chars_format::general, 6);
+        out.append(buf, result.ptr);
+    } else {
+        thread_local std::ostringstream oss;
+        oss.str(std::string());
+        oss.clear();
+        oss << value;
+        out += oss.str();
+    }
+}
+
+template <typename T>
+void format_next(std::string& out, std::string_view fmt, std::size_t& pos, const T& value) {
+    if (pos == std::string_view::npos) return;
+    std::size_t found = fmt.find("{}", pos);
+    if (found == std::string_view::npos) {
+        out.append(fmt.data() + pos, fmt.size() - pos);
+        pos = std::string_view::npos;
+        return;
+    }
+    out.append(fmt.data() + pos, found - pos);
+    append_arg(out, value);
+    pos = found + 2;
+}
+
+// Single left-to-right pass; arguments beyond the last placeholder are ignored.
+template <typename... Args>
+void format_to(std::string& out, std::string_view fmt, const Args&... args) {
+    std::size_t pos = 0;
+    (format_next(out, fmt, pos, args), ...);
+    if (pos != std::string_view::npos) {
+        out.append(fmt.data() + pos, fmt.size() - pos);
+    }
+}
+
+}  // namespace detail
+}  // namespace logging
+
+// Checked variants of Logger::*f(): the placeholder count of the literal
+// format string is verified against the argument count at compile time.
+// The format string travels inside __VA_ARGS__ so a call without arguments,
+// e.g. BRIDGE_LOG_INFOF(logger, "started"), leaves no trailing comma.
+#define BRIDGE_LOG_FORMAT_STRING_(fmt, ...) fmt
+
+#define BRIDGE_LOG_CHECK_FORMAT(...)                                                                      \
+    static_assert(::logging::detail::count_placeholders(BRIDGE_LOG_FORMAT_STRING_(__VA_ARGS__, 0)) + 1 == \
+                      std::tuple_size<decltype(std::forward_as_tuple(__VA_ARGS__))>::value,               \
+                  "format placeholder count does not match argument count")
+
+#define BRIDGE_LOG_DEBUGF(logger, ...)        \
+    do {                                      \
+        BRIDGE_LOG_CHECK_FORMAT(__VA_ARGS__); \
+        (logger).debugf(__VA_ARGS__);         \
+    } while (0)
+
+#define BRIDGE_LOG_INFOF(logger, ...)         \
+    do {                                      \
+        BRIDGE_LOG_CHECK_FORMAT(__VA_ARGS__); \
+        (logger).infof(__VA_ARGS__);          \
+    } while (0)
+
+#define BRIDGE_LOG_WARNF(logger, ...)         \
+    do {                                      \
+        BRIDGE_LOG_CHECK_FORMAT(__VA_ARGS__); \
+        (logger).warnf(__VA_ARGS__);          \
+    } while (0)
+
+#define BRIDGE_LOG_ERRORF(logger, ...)        \
+    do {                                      \
+        BRIDGE_LOG_CHECK_FORMAT(__VA_ARGS__); \
+        (logger).errorf(__VA_ARGS__);         \
+    } while (0)
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string_view>
+
+#include "utils/log_format.hpp"
+
+namespace logging {
+
+enum class Level;
+class Logger;
+
+// Token bucket for one log call site, kept as a single "theoretical arrival
+// time" (GCRA) so admission is one load plus one CAS. A rejected call only
+// bumps a relaxed counter; the count is handed to the next admitted message
+// so it can say how many similar messages were dropped.
+class RateLimiter {
+public:
+    explicit RateLimiter(double per_second = 1.0, double burst = 5.0)
+        : interval_ns_(static_cast<std::int64_t>(1e9 / std::max(per_second, 1e-3))),
+          tolerance_ns_(static_cast<std::int64_t>(static_cast<double>(interval_ns_) * (std::max(burst, 1.0) - 1.0))) {}
+
+    RateLimiter(const RateLimiter&) = delete;
+    RateLimiter& operator=(const RateLimiter&) = delete;
+
+    bool allow(std::uint64_t& suppressed) {
+        return allow(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                         std::chrono::steady_clock::now().time_since_epoch())
+                         .count(),
+                     suppressed);
+    }
+
+    bool allow(std::int64_t now_ns, std::uint64_t& suppressed) {
+        std::int64_t tat = tat_.load(std::memory_order_relaxed);
+        while (true) {
+            std::int64_t start = std::max(tat, now_ns);
+            if (start - now_ns > tolerance_ns_) {
+                suppressed_.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            if (tat_.compare_exchange_weak(tat, start + interval_ns_, std::memory_order_relaxed)) {
+                break;
+            }
+        }
+        suppressed = suppressed_.exchange(0, std::memory_order_relaxed);
+        return true;
+    }
+
+    std::uint64_t pending_suppressed() const { return suppressed_.load(std::memory_order_relaxed); }
+
+    // Records where suppressed messages came from so report_suppressed() can
+    // summarise a storm that ended without another admitted message. Only
+    // limiters with static storage may be registered (the list is never
+    // pruned), and `fmt` must be a string literal.
+    bool registered() const { return registered_.load(std::memory_order_relaxed); }
+    void register_site(Logger* logger, Level level, std::string_view fmt);
+
+private:
+    friend void report_suppressed();
+
+    const std::int64_t interval_ns_;
+    const std::int64_t tolerance_ns_;
+    std::atomic<std::int64_t> tat_{0};
+    std::atomic<std::uint64_t> suppressed_{0};
+
+    std::atomic<bool> registered_{false};
+    Logger* logger_ = nullptr;
+    Level level_{};
+    std::string_view fmt_;
+    RateLimiter* next_ = nullptr;
+};
+
+// Emits "suppressed N similar messages" for every registered call site that
+// still has a pending count and whose bucket admits a message now. Call it
+// periodically and once at shutdown.
+void report_suppressed();
+
+}  // namespace logging
+
+// Rate-limited, format-checked logging for hot loops. Each expansion owns a
+// static limiter (1 message/s, bursts of 5), so every call site is throttled
+// independently; arguments are only formatted for admitted messages.
+#define BRIDGE_LOG_LIMITED(logger, level, ...)                           \
+    do {                                                                 \
+        BRIDGE_LOG_CHECK_FORMAT(__VA_ARGS__);                            \
+        static ::logging::RateLimiter bridge_log_limiter;                \
+        (logger).logf_limited(bridge_log_limiter, level, __VA_ARGS__);   \
+    } while (0)
+
+#define BRIDGE_LOG_WARNF_LIMITED(logger, ...) \
+    BRIDGE_LOG_LIMITED(logger, ::logging::Level::Warning, __VA_ARGS__)
+
+#define BRIDGE_LOG_ERRORF_LIMITED(logger, ...) \
+    BRIDGE_LOG_LIMITED(logger, ::logging::Level::Error, __VA_ARGS__)
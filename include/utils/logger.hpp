@@ -1,18 +1,35 @@
 #pragma once
 
+#include <atomic>
 #include <chrono>
+#include <memory>
 #include <mutex>
-#include <ostream>
-#include <sstream>
 #include <string>
+#include <string_view>
+#include <vector>
+
+#include "utils/log_format.hpp"
+#include "utils/log_rate_limit.hpp"
+#include "utils/metrics.hpp"
 
 namespace logging {
 
 enum class Level { Debug, Info, Warning, Error };
 
+class AsyncLogWriter;
+struct AsyncOptions;
+
 class Logger {
 public:
     explicit Logger(std::string name);
+    ~Logger();
+
+    // Switches to a background writer: callers only enqueue records. Can be
+    // called again after stop_async(); each start gets a fresh writer.
+    void start_async(const AsyncOptions& options);
+    void stop_async();
+    bool is_async() const;
+    std::size_t dropped_records() const;
 
     void set_level(Level level);
     Level level() const;
@@ -22,55 +39,80 @@ public:
     void warn(const std::string& message);
     void error(const std::string& message);
 
+    bool enabled(Level level) const { return level >= level_.load(std::memory_order_relaxed); }
+
+    // Formatting is skipped entirely when the level is filtered out; otherwise
+    // arguments are rendered into a per-thread buffer in a single pass.
     template <typename... Args>
-    void infof(const std::string& fmt, Args&&... args) {
-        info(format(fmt, std::forward<Args>(args)...));
+    void infof(std::string_view fmt, const Args&... args) {
+        logf(Level::Info, fmt, args...);
     }
 
     template <typename... Args>
-    void warnf(const std::string& fmt, Args&&... args) {
-        warn(format(fmt, std::forward<Args>(args)...));
+    void warnf(std::string_view fmt, const Args&... args) {
+        logf(Level::Warning, fmt, args...);
     }
 
     template <typename... Args>
-    void errorf(const std::string& fmt, Args&&... args) {
-        error(format(fmt, std::forward<Args>(args)...));
+    void errorf(std::string_view fmt, const Args&... args) {
+        logf(Level::Error, fmt, args...);
     }
 
     template <typename... Args>
-    void debugf(const std::string& fmt, Args&&... args) {
-        debug(format(fmt, std::forward<Args>(args)...));
+    void debugf(std::string_view fmt, const Args&... args) {
+        logf(Level::Debug, fmt, args...);
     }
 
-private:
+    // Hot-path variant: the limiter is consulted before formatting, and an
+    // admitted message reports how many calls were suppressed before it.
+    // Usually reached through BRIDGE_LOG_WARNF_LIMITED / _ERRORF_LIMITED.
     template <typename... Args>
-    std::string format(const std::string& fmt, Args&&... args) {
-        std::ostringstream oss;
-        format_impl(oss, fmt, std::forward<Args>(args)...);
-        return oss.str();
+    void logf_limited(RateLimiter& limiter, Level level, std::string_view fmt, const Args&... args) {
+        if (!enabled(level)) {
+            return;
+        }
+        std::uint64_t suppressed = 0;
+        if (!limiter.allow(suppressed)) {
+            if (!limiter.registered()) limiter.register_site(this, level, fmt);
+            return;
+        }
+        std::string& buffer = detail::format_buffer();
+        buffer.clear();
+        detail::format_to(buffer, fmt, args...);
+        if (suppressed > 0) {
+            detail::format_to(buffer, " (suppressed {} similar messages)", suppressed);
+        }
+        log(level, buffer);
     }
 
-    void log(Level level, const std::string& message);
-
-    void format_impl(std::ostringstream& oss, const std::string& fmt);
-
-    template <typename T, typename... Args>
-    void format_impl(std::ostringstream& oss, const std::string& fmt, T&& value, Args&&... rest) {
-        std::size_t pos = fmt.find("{}");
-        if (pos == std::string::npos) {
-            oss << fmt;
+private:
+    template <typename... Args>
+    void logf(Level level, std::string_view fmt, const Args&... args) {
+        if (!enabled(level)) {
             return;
         }
-        oss << fmt.substr(0, pos);
-        oss << std::forward<T>(value);
-        format_impl(oss, fmt.substr(pos + 2), std::forward<Args>(rest)...);
+        std::string& buffer = detail::format_buffer();
+        buffer.clear();
+        detail::format_to(buffer, fmt, args...);
+        log(level, buffer);
     }
 
+    void log(Level level, std::string_view message);
+
+    friend void report_suppressed();
+
     std::string name_;
-    Level level_ = Level::Info;
-    std::mutex mutex_;
+    std::atomic<Level> level_{Level::Info};
+    mutable std::mutex mutex_;
+    mutable std::mutex async_mutex_;  // serialises start_async/stop_async
+    std::unique_ptr<AsyncLogWriter> async_writer_;
+    // Stopped writers, kept until the Logger is destroyed.
+    std::vector<std::unique_ptr<AsyncLogWriter>> retired_writers_;
+    std::atomic<AsyncLogWriter*> async_{nullptr};
+    metrics::ObserverHandle queue_depth_;
 };
 
 std::string level_to_string(Level level);
+std::string format_timestamp(std::chrono::system_clock::time_point time);
 
 }  // namespace logging
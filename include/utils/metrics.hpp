@@ -0,0 +1,162 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "utils/latency_histogram.hpp"
+
+namespace metrics {
+
+using Labels = std::vector<std::pair<std::string, std::string>>;
+
+// Monotonic counter split into cache-line sized shards. Each thread sticks to
+// one shard, so writers on different threads never contend on a line; value()
+// sums the shards.
+class Counter {
+public:
+    static constexpr std::size_t kShards = 8;
+
+    void add(std::uint64_t amount = 1) {
+        shards_[shard_index()].value.fetch_add(amount, std::memory_order_relaxed);
+    }
+
+    std::uint64_t value() const {
+        std::uint64_t total = 0;
+        for (const auto& shard : shards_) total += shard.value.load(std::memory_order_relaxed);
+        return total;
+    }
+
+private:
+    struct alignas(64) Shard {
+        std::atomic<std::uint64_t> value{0};
+    };
+
+    static std::size_t shard_index() {
+        static std::atomic<std::size_t> next{0};
+        thread_local const std::size_t index = next.fetch_add(1, std::memory_order_relaxed) % kShards;
+        return index;
+    }
+
+    std::array<Shard, kShards> shards_{};
+};
+
+// Point-in-time value (queue depth, connected clients).
+class Gauge {
+public:
+    void set(std::int64_t value) { value_.store(value, std::memory_order_relaxed); }
+    void add(std::int64_t delta) { value_.fetch_add(delta, std::memory_order_relaxed); }
+    void sub(std::int64_t delta) { value_.fetch_sub(delta, std::memory_order_relaxed); }
+    std::int64_t value() const { return value_.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<std::int64_t> value_{0};
+};
+
+enum class MetricType { Counter, Gauge, Histogram };
+
+struct ScalarSample {
+    std::string name;
+    std::string help;
+    Labels labels;
+    MetricType type = MetricType::Counter;
+    double value = 0.0;
+};
+
+struct HistogramSample {
+    std::string name;
+    std::string help;
+    Labels labels;
+    LatencyHistogram::Snapshot data;  // nanoseconds
+};
+
+// Everything registered, read in one pass and ordered by name then labels,
+// so each metric family is contiguous.
+struct RegistrySnapshot {
+    std::chrono::system_clock::time_point taken_at{};
+    std::vector<ScalarSample> scalars;
+    std::vector<HistogramSample> histograms;
+
+    const ScalarSample* find(std::string_view name, const Labels& labels = {}) const;
+    const HistogramSample* find_histogram(std::string_view name, const Labels& labels = {}) const;
+    double value(std::string_view name, const Labels& labels = {}, double fallback = 0.0) const;
+};
+
+class Registry;
+
+// Keeps a callback metric registered; unregisters it when destroyed.
+class ObserverHandle {
+public:
+    ObserverHandle() = default;
+    ObserverHandle(ObserverHandle&& other) noexcept;
+    ObserverHandle& operator=(ObserverHandle&& other) noexcept;
+    ~ObserverHandle() { reset(); }
+
+    void reset();
+
+private:
+    friend class Registry;
+    ObserverHandle(Registry* registry, std::string key) : registry_(registry), key_(std::move(key)) {}
+
+    Registry* registry_ = nullptr;
+    std::string key_;
+};
+
+// Owns every metric in the process. Lookups are get-or-create and take a
+// mutex, so modules resolve their metrics once (usually in the constructor)
+// and keep the reference; updates never lock. Registering an existing name
+// and label set with a different type throws std::invalid_argument.
+class Registry {
+public:
+    Registry() = default;
+    Registry(const Registry&) = delete;
+    Registry& operator=(const Registry&) = delete;
+
+    Counter& counter(std::string_view name, std::string_view help, Labels labels = {});
+    Gauge& gauge(std::string_view name, std::string_view help, Labels labels = {});
+    LatencyHistogram& histogram(std::string_view name, std::string_view help, Labels labels = {});
+
+    // Value computed when a snapshot is taken (frame age, queue depth). The
+    // callback runs under the registry mutex, so it must be cheap and must not
+    // touch the registry. `type` is Counter or Gauge.
+    [[nodiscard]] ObserverHandle observe(std::string_view name, std::string_view help, Labels labels,
+                                         MetricType type, std::function<double()> read);
+
+    RegistrySnapshot snapshot() const;
+
+private:
+    friend class ObserverHandle;
+
+    struct Entry {
+        std::string name;
+        std::string help;
+        Labels labels;
+        MetricType type = MetricType::Counter;
+        std::unique_ptr<Counter> counter;
+        std::unique_ptr<Gauge> gauge;
+        std::unique_ptr<LatencyHistogram> histogram;
+        std::function<double()> read;
+    };
+
+    void remove(const std::string& key);
+
+    Entry& entry(std::string_view name, std::string_view help, Labels labels, MetricType type);
+
+    mutable std::mutex mutex_;
+    std::map<std::string, Entry> entries_;
+};
+
+// Process-wide registry used by the core modules and the exporters.
+Registry& default_registry();
+
+}  // namespace metrics
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+namespace utils {
+
+// Bounded lock-free multi-producer/single-consumer queue (Vyukov ring).
+// try_push never blocks; it fails when the ring is full.
+template <typename T>
+class MpscQueue {
+public:
+    explicit MpscQueue(std::size_t capacity) {
+        std::size_t size = 2;
+        while (size < capacity) size <<= 1;
+        mask_ = size - 1;
+        cells_ = std::make_unique<Cell[]>(size);
+        for (std::size_t i = 0; i < size; ++i) {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    template <typename Fill>
+    bool try_emplace(Fill&& fill) {
+        std::size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+        Cell* cell = nullptr;
+        while (true) {
+            cell = &cells_[pos & mask_];
+            std::size_t seq = cell->sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos);
+            if (diff == 0) {
+                if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = enqueue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+        fill(cell->value);
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool try_push(T value) {
+        return try_emplace([&](T& slot) { slot = std::move(value); });
+    }
+
+    // Consumer side only.
+    bool try_pop(T& out) {
+        Cell& cell = cells_[dequeue_pos_ & mask_];
+        std::size_t seq = cell.sequence.load(std::memory_order_acquire);
+        if (seq != dequeue_pos_ + 1) {
+            return false;
+        }
+        out = std::move(cell.value);
+        cell.sequence.store(dequeue_pos_ + mask_ + 1, std::memory_order_release);
+        ++dequeue_pos_;
+        return true;
+    }
+
+    std::size_t capacity() const { return mask_ + 1; }
+
+    std::size_t size_approx() const {
+        std::size_t head = enqueue_pos_.load(std::memory_order_relaxed);
+        std::size_t tail = dequeue_pos_snapshot_.load(std::memory_order_relaxed);
+        return head >= tail ? head - tail : 0;
+    }
+
+    // Called by the consumer after a drain so size_approx() stays meaningful
+    // for other threads.
+    void publish_consumer_position() { dequeue_pos_snapshot_.store(dequeue_pos_, std::memory_order_relaxed); }
+
+private:
+    struct Cell {
+        std::atomic<std::size_t> sequence{0};
+        T value{};
+    };
+
+    std::unique_ptr<Cell[]> cells_;
+    std::size_t mask_ = 0;
+    alignas(64) std::atomic<std::size_t> enqueue_pos_{0};
+    alignas(64) std::size_t dequeue_pos_ = 0;
+    std::atomic<std::size_t> dequeue_pos_snapshot_{0};
+};
+
+}  // namespace utils
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <string>
+
+#include "utils/metrics.hpp"
+
+namespace metrics {
+
+inline constexpr const char* kOpenMetricsContentType =
+    "application/openmetrics-text; version=1.0.0; charset=utf-8";
+
+// Appends `snapshot` to `out` in the OpenMetrics 1.0 text format, ending with
+// "# EOF". Counters get the `_total` suffix; histograms are converted from
+// nanoseconds to `_seconds` and only their non-empty buckets are emitted, so a
+// scrape stays a few kilobytes.
+void render_openmetrics(const RegistrySnapshot& snapshot, std::string& out);
+
+}  // namespace metrics
@@ -3,6 +3,7 @@
 #include <chrono>
 #include <optional>
 #include <string>
+#include <vector>
 
 #include "utils/json.hpp"
 
@@ -28,6 +29,13 @@ struct GimbalSettings {
     int sensor_id = 1;
     std::string control_method = "tcp";  // tcp | mavlink
     bool show_packets = false;
+    std::string packet_format = "pose";  // pose | sensor
+    double send_rate_hz = 20.0;
+    double max_rate_dps = 60.0;
+    double max_accel_dps2 = 120.0;
+    double max_zoom_rate = 2.0;
+    double max_zoom_accel = 4.0;
+    bool measure_latency = false;
 };
 
 struct RelaySettings {
@@ -39,6 +47,15 @@ struct RelaySettings {
     int proc_port = 10709;
     bool enable = true;
     bool log_packets = false;
+    // Datagrams held per destination while its socket buffer is full, and
+    // what to give up once that backlog is full too: "drop_oldest" keeps
+    // the freshest data, "drop_newest" keeps what is already queued.
+    // Lengths are limited to 0..kMaxQueue.
+    static constexpr int kMaxQueue = 65536;
+    int raw_queue = 1024;
+    std::string raw_drop_policy = "drop_oldest";
+    int proc_queue = 1024;
+    std::string proc_drop_policy = "drop_oldest";
 };
 
 struct RoverSettings {
@@ -46,23 +63,73 @@ struct RoverSettings {
     std::string log_directory;
 };
 
+struct LoggingSettings {
+    bool async = false;
+    std::string file_path;  // empty = console only
+    int max_file_mb = 10;
+    int max_files = 5;
+    int flush_interval_ms = 200;
+    int queue_capacity = 4096;
+};
+
+struct MetricsSettings {
+    bool enable = false;  // serve OpenMetrics text on http://bind_ip:port/metrics
+    std::string bind_ip = "127.0.0.1";
+    int port = 9464;
+};
+
+// Placement for one group of threads; empty/0 keeps what the thread
+// inherited from the main thread, which itself runs with `service`.
+struct ThreadSettings {
+    std::string cpus;  // Linux cpulist, e.g. "2-3,6"
+    int priority = 0;  // 1-99 runs the threads SCHED_FIFO
+};
+
+struct RuntimeSettings {
+    int loop_threads = 1;             // reactor event loops shared by relay, image bridge and gimbal
+    std::string io_backend = "epoll";  // epoll | io_uring (UDP relay path; falls back to epoll)
+    bool mlockall = false;            // lock all current and future pages in RAM
+    ThreadSettings relay;             // reactor loop(s) carrying each module
+    ThreadSettings image;
+    ThreadSettings gimbal;
+    ThreadSettings logging;  // async log writer
+    ThreadSettings service;  // main thread, metrics server, HUD, config watcher, gimbal echo
+};
+
 struct AppConfig {
     BridgeSettings bridge;
     GimbalSettings gimbal;
     RelaySettings relay;
     RoverSettings rover;
+    LoggingSettings logging;
+    MetricsSettings metrics;
+    RuntimeSettings runtime;
     bool console_hud = true;
     double hud_interval = 1.0;
+    std::vector<double> hud_windows{1.0, 10.0, 60.0};  // HUD sliding windows, seconds
 
+    void write_json(mini_json::Writer& writer) const;
     mini_json::Value to_json() const;
     static AppConfig from_json(const mini_json::Value& value, const std::string& base_dir);
 };
 
+// Field-wise comparison, used to find what a reloaded config changed.
+bool operator==(const BridgeSettings& a, const BridgeSettings& b);
+bool operator==(const GimbalSettings& a, const GimbalSettings& b);
+bool operator==(const RelaySettings& a, const RelaySettings& b);
+inline bool operator!=(const BridgeSettings& a, const BridgeSettings& b) { return !(a == b); }
+inline bool operator!=(const GimbalSettings& a, const GimbalSettings& b) { return !(a == b); }
+inline bool operator!=(const RelaySettings& a, const RelaySettings& b) { return !(a == b); }
+
 class ConfigManager {
 public:
     explicit ConfigManager(std::string base_dir);
 
     AppConfig load();
+    // Re-reads the file for hot reload. Unlike load(), a missing or corrupt
+    // file yields nullopt instead of defaults, so a half-edited config never
+    // resets running modules.
+    std::optional<AppConfig> try_load() const;
     void save(const AppConfig& config) const;
 
     const std::string& base_dir() const { return base_dir_; }
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace utils {
+
+// Names the calling thread so it shows up in top -H, perf and gdb. Linux
+// keeps the first 15 bytes; a no-op where the platform has no equivalent.
+void set_current_thread_name(const std::string& name);
+
+// Parses a Linux cpulist such as "2" or "0-3,6". Returns false on malformed
+// input or CPU numbers beyond CPU_SETSIZE.
+bool parse_cpu_list(const std::string& text, std::vector<int>& cpus);
+
+// Pins the calling thread to `cpus` (a cpulist; empty leaves the affinity
+// alone) and, for priority 1-99, switches it to SCHED_FIFO at that priority
+// (0 leaves the scheduler alone). New threads inherit both from their
+// creator. Returns false and fills `error` when any part was refused, e.g.
+// SCHED_FIFO without CAP_SYS_NICE or an RLIMIT_RTPRIO.
+bool apply_current_thread_policy(const std::string& cpus, int priority, std::string& error);
+
+// mlockall(MCL_CURRENT | MCL_FUTURE) so page faults cannot stall the
+// real-time threads. Returns false and fills `error` on failure.
+bool lock_process_memory(std::string& error);
+
+}  // namespace utils
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace timestamp {
+
+enum class Precision { Millis, Micros, Nanos };
+
+// Raw clock readings for binary formats: wall clock for correlation with
+// other hosts, monotonic for intervals.
+struct ClockPair {
+    std::int64_t wall_ns = 0;
+    std::int64_t mono_ns = 0;
+};
+
+// "YYYY-MM-DD HH:MM:SS.nnnnnnnnn" plus terminator fits in this many bytes.
+constexpr std::size_t kMaxLength = 32;
+
+ClockPair now();
+std::int64_t wall_ns(std::chrono::system_clock::time_point time);
+
+// Local-time "YYYY-MM-DD HH:MM:SS.mmm" (or .uuuuuu / .nnnnnnnnn). The
+// seconds prefix is cached per thread, so only the first call in each second
+// pays for localtime/strftime. Returns the number of characters written;
+// `out` must hold kMaxLength bytes. No terminator is written.
+std::size_t format_local(char* out, std::int64_t wall_ns, Precision precision = Precision::Millis);
+std::size_t format_local(char* out, std::chrono::system_clock::time_point time,
+                         Precision precision = Precision::Millis);
+
+void append_local(std::string& out, std::chrono::system_clock::time_point time,
+                  Precision precision = Precision::Millis);
+std::string local_string(std::chrono::system_clock::time_point time, Precision precision = Precision::Millis);
+
+}  // namespace timestamp
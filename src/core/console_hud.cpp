@@ -0,0 +1,268 @@
+#include "core/console_hud.hpp"
+
+#ifdef _WIN32
+#include <io.h>
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <ostream>
+
+#include "utils/thread_tuning.hpp"
+#include "utils/timestamp.hpp"
+
+namespace core {
+
+namespace {
+
+constexpr auto kSamplePeriod = std::chrono::milliseconds(250);
+constexpr int kLabelWidth = 16;
+constexpr int kColumnWidth = 10;
+
+bool stdout_is_terminal() {
+#ifdef _WIN32
+    if (!_isatty(_fileno(stdout))) return false;
+    // Cursor movement needs VT processing, which is off by default on Windows.
+    HANDLE handle = GetStdHandle(STD_OUTPUT_HANDLE);
+    DWORD mode = 0;
+    return GetConsoleMode(handle, &mode) && SetConsoleMode(handle, mode | ENABLE_VIRTUAL_TERMINAL_PROCESSING);
+#else
+    return ::isatty(STDOUT_FILENO) != 0;
+#endif
+}
+
+std::string window_label(double seconds) {
+    char buf[16];
+    if (seconds >= 60.0 && std::fmod(seconds, 60.0) == 0.0) {
+        std::snprintf(buf, sizeof(buf), "%gm", seconds / 60.0);
+    } else {
+        std::snprintf(buf, sizeof(buf), "%gs", seconds);
+    }
+    return buf;
+}
+
+void append_cell(std::string& line, const char* fmt, double value) {
+    char buf[32];
+    if (std::isnan(value)) {
+        std::snprintf(buf, sizeof(buf), "%*s", kColumnWidth, "-");
+    } else {
+        std::snprintf(buf, sizeof(buf), fmt, kColumnWidth, value);
+    }
+    line += buf;
+}
+
+void append_label(std::string& line, const char* label) {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%-*s", kLabelWidth, label);
+    line += buf;
+}
+
+double percentile(std::vector<double>& values, double q) {
+    if (values.empty()) return std::nan("");
+    auto index = static_cast<std::size_t>(q * static_cast<double>(values.size() - 1) + 0.5);
+    std::nth_element(values.begin(), values.begin() + static_cast<std::ptrdiff_t>(index), values.end());
+    return values[index];
+}
+
+}  // namespace
+
+ConsoleHud::ConsoleHud(HudOptions options, metrics::Registry& registry, const ImageStreamBridge& image_bridge,
+                       const GimbalControl& gimbal, const UdpRelay& relay, std::ostream& out)
+    : options_(std::move(options)),
+      registry_(registry),
+      image_bridge_(image_bridge),
+      gimbal_(gimbal),
+      relay_(relay),
+      out_(out) {
+    auto& windows = options_.windows_s;
+    windows.erase(std::remove_if(windows.begin(), windows.end(), [](double w) { return !(w > 0.0); }), windows.end());
+    if (windows.empty()) windows.push_back(10.0);
+    std::sort(windows.begin(), windows.end());
+    windows.erase(std::unique(windows.begin(), windows.end()), windows.end());
+    if (!(options_.interval_s > 0.0)) options_.interval_s = 1.0;
+}
+
+ConsoleHud::~ConsoleHud() { stop(); }
+
+void ConsoleHud::start() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (running_) return;
+    running_ = true;
+    ansi_ = options_.ansi && stdout_is_terminal();
+    thread_ = std::thread(&ConsoleHud::run, this);
+}
+
+void ConsoleHud::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!running_) return;
+        running_ = false;
+    }
+    wake_.notify_all();
+    if (thread_.joinable()) thread_.join();
+}
+
+void ConsoleHud::run() {
+    utils::set_current_thread_name("console-hud");
+    using clock = std::chrono::steady_clock;
+    const auto redraw_period =
+        std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(options_.interval_s));
+    auto next_sample = clock::now();
+    auto next_draw = next_sample + redraw_period;
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (running_) {
+        lock.unlock();
+        take_sample();
+        if (clock::now() >= next_draw) {
+            std::string block = render();
+            if (ansi_ && drawn_lines_ > 0) {
+                // Back to the first line of the previous block.
+                out_ << "\x1b[" << drawn_lines_ << 'F';
+            }
+            out_ << block << std::flush;
+            drawn_lines_ = static_cast<std::size_t>(std::count(block.begin(), block.end(), '\n'));
+            next_draw += redraw_period;
+            if (next_draw <= clock::now()) next_draw = clock::now() + redraw_period;
+        }
+        next_sample += kSamplePeriod;
+        lock.lock();
+        wake_.wait_until(lock, next_sample, [this] { return !running_; });
+    }
+}
+
+void ConsoleHud::take_sample() {
+    const auto snap = registry_.snapshot();
+    Sample sample;
+    sample.time = std::chrono::steady_clock::now();
+    sample.relay_packets = snap.value("relay_forwarded_packets");
+    sample.relay_bytes = snap.value("relay_forwarded_bytes");
+    sample.relay_errors = snap.value("relay_send_errors") + snap.value("relay_receive_errors");
+    sample.relay_raw_drops = snap.value("relay_destination_dropped", {{"destination", "raw"}});
+    sample.relay_proc_drops = snap.value("relay_destination_dropped", {{"destination", "proc"}});
+    sample.image_frames = snap.value("image_frames_received");
+    sample.image_bytes = snap.value("image_bytes_received");
+    sample.image_errors = snap.value("image_receive_errors");
+    sample.gimbal_errors = snap.value("gimbal_send_errors");
+    sample.log_drops = snap.value("log_records_dropped");
+    double age = snap.value("image_last_frame_age_seconds", {}, std::nan(""));
+    sample.frame_age_s = std::isnan(age) ? -1.0 : age;
+
+    samples_.push_back(sample);
+    const auto keep = std::chrono::duration<double>(options_.windows_s.back()) + 2 * kSamplePeriod;
+    while (samples_.size() > 2 && sample.time - samples_.front().time > keep) {
+        samples_.pop_front();
+    }
+}
+
+std::string ConsoleHud::render() const {
+    const Sample& now = samples_.back();
+    const auto slack = kSamplePeriod / 2;
+
+    // Index of the oldest sample inside each window; rates are deltas
+    // against it.
+    std::vector<std::size_t> bases;
+    for (double window : options_.windows_s) {
+        const auto span = std::chrono::duration<double>(window) + slack;
+        auto it = std::find_if(samples_.begin(), samples_.end(),
+                               [&](const Sample& s) { return now.time - s.time <= span; });
+        bases.push_back(static_cast<std::size_t>(it - samples_.begin()));
+    }
+    auto rate = [&](std::size_t base, auto&& value) {
+        const Sample& from = samples_[base];
+        double dt = std::chrono::duration<double>(now.time - from.time).count();
+        if (base + 1 >= samples_.size() || dt <= 0.0) return std::nan("");
+        return (value(now) - value(from)) / dt;
+    };
+
+    const auto img = image_bridge_.status();
+    const auto gib = gimbal_.status();
+    const auto rel = relay_.status();
+
+    std::string text;
+    std::string line;
+    auto end_line = [&] {
+        text += line;
+        text += ansi_ ? "\x1b[K\n" : "\n";  // clear leftovers of a longer previous line
+        line.clear();
+    };
+
+    char head[160];
+    std::snprintf(head, sizeof(head), "Unified Bridge  %s  UDP:%s TCP:%s viewers:%zu relay:%s",
+                  timestamp::local_string(std::chrono::system_clock::now()).c_str(), img.udp_running ? "on" : "off",
+                  img.tcp_running ? "on" : "off", img.clients, rel.running ? "on" : "off");
+    line = head;
+    end_line();
+
+    append_label(line, "");
+    for (double window : options_.windows_s) {
+        char buf[32];
+        std::snprintf(buf, sizeof(buf), "%*s", kColumnWidth, window_label(window).c_str());
+        line += buf;
+    }
+    end_line();
+
+    struct Row {
+        const char* label;
+        double Sample::*field;
+        double scale;
+        const char* fmt;
+    };
+    const Row rows[] = {
+        {"relay pps", &Sample::relay_packets, 1.0, "%*.1f"},
+        {"relay Mbit/s", &Sample::relay_bytes, 8e-6, "%*.3f"},
+        {"raw drops/s", &Sample::relay_raw_drops, 1.0, "%*.2f"},
+        {"proc drops/s", &Sample::relay_proc_drops, 1.0, "%*.2f"},
+        {"image fps", &Sample::image_frames, 1.0, "%*.1f"},
+        {"image Mbit/s", &Sample::image_bytes, 8e-6, "%*.3f"},
+        {"log drops/s", &Sample::log_drops, 1.0, "%*.2f"},
+    };
+    for (const Row& row : rows) {
+        append_label(line, row.label);
+        for (std::size_t base : bases) {
+            append_cell(line, row.fmt, rate(base, [&](const Sample& s) { return s.*row.field * row.scale; }));
+        }
+        end_line();
+    }
+
+    append_label(line, "errors/s");
+    for (std::size_t base : bases) {
+        append_cell(line, "%*.2f",
+                    rate(base, [](const Sample& s) { return s.relay_errors + s.image_errors + s.gimbal_errors; }));
+    }
+    end_line();
+
+    const struct {
+        const char* label;
+        double q;
+    } age_rows[] = {{"frame age p50", 0.50}, {"frame age p99", 0.99}};
+    std::vector<double> ages;
+    for (const auto& row : age_rows) {
+        append_label(line, row.label);
+        for (std::size_t base : bases) {
+            ages.clear();
+            for (std::size_t i = base; i < samples_.size(); ++i) {
+                if (samples_[i].frame_age_s >= 0.0) ages.push_back(samples_[i].frame_age_s * 1e3);
+            }
+            append_cell(line, "%*.0f", percentile(ages, row.q));
+        }
+        line += " ms";
+        end_line();
+    }
+
+    char pose[200];
+    int n = std::snprintf(pose, sizeof(pose), "gimbal yaw %.1f pitch %.1f roll %.1f zoom %.2f%s", gib.yaw, gib.pitch,
+                          gib.roll, gib.zoom, gib.moving ? " (moving)" : "");
+    if (gib.measuring_latency && n > 0 && static_cast<std::size_t>(n) < sizeof(pose)) {
+        std::snprintf(pose + n, sizeof(pose) - static_cast<std::size_t>(n), "  rtt p50 %.2fms p99 %.2fms (n=%zu)",
+                      gib.latency_p50_ms, gib.latency_p99_ms, gib.latency_samples);
+    }
+    line = pose;
+    end_line();
+    return text;
+}
+
+}  // namespace core
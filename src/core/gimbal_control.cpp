@@ -1,97 +1,338 @@
 #include "core/gimbal_control.hpp"
 
 #ifdef _WIN32
+#include <BaseTsd.h>
 #include <winsock2.h>
 #include <ws2tcpip.h>
+using ssize_t = SSIZE_T;
 #else
 #include <netinet/in.h>
 #include <sys/socket.h>
 #include <unistd.h>
 #endif
 
-#include <algorithm>
-#include <array>
 #include <chrono>
 
+#include "core/gimbal_packet.hpp"
 #include "network/socket_utils.hpp"
 
 namespace core {
 
 namespace {
-std::vector<std::uint8_t> build_packet(double yaw, double pitch, double roll, double zoom) {
-    std::vector<std::uint8_t> packet(32, 0);
-    auto encode = [](double value) {
-        int32_t scaled = static_cast<int32_t>(value * 100);
-        std::uint8_t bytes[4];
-        bytes[0] = static_cast<std::uint8_t>((scaled >> 24) & 0xFF);
-        bytes[1] = static_cast<std::uint8_t>((scaled >> 16) & 0xFF);
-        bytes[2] = static_cast<std::uint8_t>((scaled >> 8) & 0xFF);
-        bytes[3] = static_cast<std::uint8_t>(scaled & 0xFF);
-        return std::array<std::uint8_t, 4>{bytes[0], bytes[1], bytes[2], bytes[3]};
-    };
-    auto yaw_bytes = encode(yaw);
-    auto pitch_bytes = encode(pitch);
-    auto roll_bytes = encode(roll);
-    auto zoom_bytes = encode(zoom);
-    std::copy(yaw_bytes.begin(), yaw_bytes.end(), packet.begin());
-    std::copy(pitch_bytes.begin(), pitch_bytes.end(), packet.begin() + 4);
-    std::copy(roll_bytes.begin(), roll_bytes.end(), packet.begin() + 8);
-    std::copy(zoom_bytes.begin(), zoom_bytes.end(), packet.begin() + 12);
-    return packet;
-}
-}
-
-GimbalControl::GimbalControl(const settings::GimbalSettings& cfg, logging::Logger& logger)
-    : config_(cfg), logger_(logger) {}
+std::int64_t steady_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+std::chrono::nanoseconds send_period(const settings::GimbalSettings& cfg) {
+    const double rate_hz = cfg.send_rate_hz > 0.0 ? cfg.send_rate_hz : 20.0;
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::duration<double>(1.0 / rate_hz));
+}
+
+// Echoes handled per readiness event before other registrations get a turn.
+constexpr int kMaxBatch = 64;
+}
+
+GimbalControl::GimbalControl(const settings::GimbalSettings& cfg, network::Reactor& reactor,
+                             logging::Logger& logger)
+    : config_(cfg),
+      logger_(logger),
+      reactor_(reactor),
+      loop_(reactor.next_loop()),
+      latency_(metrics::default_registry().histogram("gimbal_command_rtt",
+                                                     "Round trip from command send to generator echo")),
+      commands_sent_(metrics::default_registry().counter("gimbal_commands_sent", "Gimbal command packets sent")),
+      send_errors_(metrics::default_registry().counter("gimbal_send_errors", "Failed gimbal command sends")) {}
 
 GimbalControl::~GimbalControl() { stop(); }
 
 void GimbalControl::start() {
+    std::lock_guard<std::mutex> lock(control_mutex_);
     if (running_) return;
-    running_ = true;
-    worker_thread_ = std::thread(&GimbalControl::worker, this);
+    start_worker();
     logger_.info("Gimbal control started");
 }
 
 void GimbalControl::stop() {
+    std::lock_guard<std::mutex> lock(control_mutex_);
     if (!running_) return;
-    running_ = false;
-    if (worker_thread_.joinable()) worker_thread_.join();
+    stop_worker();
     logger_.info("Gimbal control stopped");
 }
 
+bool GimbalControl::apply_settings(const settings::GimbalSettings& cfg) {
+    std::lock_guard<std::mutex> lock(control_mutex_);
+    settings::GimbalSettings previous = config_snapshot();
+    if (cfg == previous) return false;
+    {
+        std::lock_guard<std::mutex> config_lock(config_mutex_);
+        config_ = cfg;
+    }
+
+    const bool feedback_changed =
+        cfg.measure_latency != previous.measure_latency ||
+        (cfg.measure_latency && (cfg.bind_ip != previous.bind_ip || cfg.bind_port != previous.bind_port));
+    if (running_ && feedback_changed) {
+        stop_worker();
+        start_worker();
+        logger_.info("Gimbal control restarted with new feedback settings");
+    } else {
+        if (running_) {
+            try {
+                reactor_.run_sync(loop_, [&] { load(cfg); });
+            } catch (const std::exception& ex) {
+                logger_.error(std::string("Gimbal control error: ") + ex.what());
+            }
+        }
+        BRIDGE_LOG_INFOF(logger_, "Gimbal settings applied (target {})",
+                         network::describe_endpoint(cfg.generator_ip, static_cast<std::uint16_t>(cfg.generator_port)));
+    }
+    return true;
+}
+
+void GimbalControl::start_worker() {
+    settings::GimbalSettings cfg = config_snapshot();
+    try {
+        reactor_.run_sync(loop_, [&] { open_sender(cfg); });
+    } catch (const std::exception& ex) {
+        logger_.error(std::string("Gimbal control error: ") + ex.what());
+        stop_worker();
+        return;
+    }
+    running_ = true;
+}
+
+// Removal is synchronous: no tick or echo callback runs after this.
+void GimbalControl::stop_worker() {
+    running_ = false;
+    reactor_.run_sync(loop_, [&] {
+        timer_.reset();
+        feedback_event_.reset();
+        measuring_ = false;
+        network::close_socket(socket_);
+        socket_ = -1;
+    });
+}
+
+settings::GimbalSettings GimbalControl::config_snapshot() const {
+    std::lock_guard<std::mutex> lock(config_mutex_);
+    return config_;
+}
+
 void GimbalControl::update_pose(double yaw_deg, double pitch_deg, double roll_deg, double zoom_level) {
     std::lock_guard<std::mutex> lock(pose_mutex_);
-    yaw_ = yaw_deg;
-    pitch_ = pitch_deg;
-    roll_ = roll_deg;
-    zoom_ = zoom_level;
+    drop_pending_steer();
+    trajectory_.reset(GimbalPose{yaw_deg, pitch_deg, roll_deg, zoom_level});
+}
+
+void GimbalControl::move_to(const GimbalPose& target) { move_to(target, default_limits()); }
+
+void GimbalControl::move_to(const GimbalPose& target, const TrajectoryLimits& limits) {
+    std::lock_guard<std::mutex> lock(pose_mutex_);
+    drop_pending_steer();
+    trajectory_.set_target(target, limits);
+}
+
+void GimbalControl::follow_waypoints(std::vector<GimbalPose> waypoints) {
+    follow_waypoints(std::move(waypoints), default_limits());
+}
+
+void GimbalControl::follow_waypoints(std::vector<GimbalPose> waypoints, const TrajectoryLimits& limits) {
+    std::lock_guard<std::mutex> lock(pose_mutex_);
+    drop_pending_steer();
+    trajectory_.set_waypoints(std::move(waypoints), limits);
+}
+
+void GimbalControl::hold() {
+    std::lock_guard<std::mutex> lock(pose_mutex_);
+    drop_pending_steer();
+    trajectory_.hold();
+}
+
+void GimbalControl::steer(const GimbalPose& target) {
+    const std::uint64_t sequence = steer_.sequence.load(std::memory_order_relaxed);
+    steer_.sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    steer_.yaw.store(target.yaw, std::memory_order_relaxed);
+    steer_.pitch.store(target.pitch, std::memory_order_relaxed);
+    steer_.roll.store(target.roll, std::memory_order_relaxed);
+    steer_.zoom.store(target.zoom, std::memory_order_relaxed);
+    steer_.sequence.store(sequence + 2, std::memory_order_release);
+}
+
+// Loop-side, under pose_mutex_. A target caught mid-write is left for the
+// next tick.
+bool GimbalControl::take_steer_target(GimbalPose& out) {
+    const std::uint64_t before = steer_.sequence.load(std::memory_order_acquire);
+    if (before == steer_applied_ || (before & 1) != 0) return false;
+    out.yaw = steer_.yaw.load(std::memory_order_relaxed);
+    out.pitch = steer_.pitch.load(std::memory_order_relaxed);
+    out.roll = steer_.roll.load(std::memory_order_relaxed);
+    out.zoom = steer_.zoom.load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (steer_.sequence.load(std::memory_order_relaxed) != before) return false;
+    steer_applied_ = before;
+    return true;
+}
+
+// Under pose_mutex_. Marks the newest steer target as applied; one still
+// being written (odd sequence) is skipped as well, since it lands on the
+// next even value.
+void GimbalControl::drop_pending_steer() {
+    const std::uint64_t sequence = steer_.sequence.load(std::memory_order_acquire);
+    steer_applied_ = (sequence + 1) & ~std::uint64_t{1};
+    pose_overrides_.fetch_add(1, std::memory_order_release);
+}
+
+TrajectoryLimits GimbalControl::default_limits() const {
+    std::lock_guard<std::mutex> lock(config_mutex_);
+    return TrajectoryLimits{config_.max_rate_dps, config_.max_accel_dps2, config_.max_zoom_rate,
+                            config_.max_zoom_accel};
 }
 
 GimbalStatus GimbalControl::status() const {
     std::lock_guard<std::mutex> lock(pose_mutex_);
-    return GimbalStatus{running_, yaw_, pitch_, roll_, zoom_};
+    const auto& pose = trajectory_.current();
+    GimbalStatus st{running_, pose.yaw, pose.pitch, pose.roll, pose.zoom,
+                    trajectory_.active(), trajectory_.pending_waypoints()};
+    st.measuring_latency = measuring_;
+    if (st.measuring_latency) {
+        auto snap = latency_.snapshot();
+        st.latency_samples = static_cast<std::size_t>(snap.count);
+        st.latency_p50_ms = static_cast<double>(snap.percentile(0.50)) / 1e6;
+        st.latency_p99_ms = static_cast<double>(snap.percentile(0.99)) / 1e6;
+        st.latency_max_ms = static_cast<double>(snap.max) / 1e6;
+    }
+    return st;
 }
 
-void GimbalControl::worker() {
-    int sock = -1;
-    try {
-        sock = network::create_udp_socket();
-        sockaddr_in target = network::make_address(config_.generator_ip, static_cast<std::uint16_t>(config_.generator_port));
-        while (running_) {
-            std::vector<std::uint8_t> packet;
-            {
-                std::lock_guard<std::mutex> lock(pose_mutex_);
-                packet = build_packet(yaw_, pitch_, roll_, zoom_);
-            }
-            sendto(sock, reinterpret_cast<const char*>(packet.data()), packet.size(), 0,
-                   reinterpret_cast<sockaddr*>(&target), sizeof(target));
-            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+void GimbalControl::set_status_feed(StatusFeed* feed) {
+    reactor_.run_sync(loop_, [&] {
+        feed_timer_.reset();
+        feed_ = feed;
+        if (!feed_) return;
+        published_ns_ = steady_ns();
+        published_commands_ = commands_sent_.value();
+        feed_timer_ = reactor_.add_timer(loop_, StatusFeed::kPublishPeriod, [this] { publish_status(); });
+    });
+}
+
+void GimbalControl::publish_status() {
+    StatusDelta delta;
+    delta.source = StatusDelta::Source::Gimbal;
+    delta.running = running_;
+    delta.steady_ns = steady_ns();
+    delta.interval_ns = delta.steady_ns - published_ns_;
+    const std::uint64_t commands = commands_sent_.value();
+    delta.packets = commands - published_commands_;
+    // The history is written on this loop by tick(); reading it avoids
+    // taking pose_mutex_.
+    PoseSample sample;
+    if (pose_history_.latest(sample)) delta.pose = sample.pose;
+    published_ns_ = delta.steady_ns;
+    published_commands_ = commands;
+    feed_->publish(delta);
+}
+
+void GimbalControl::open_sender(const settings::GimbalSettings& cfg) {
+    load(cfg);
+    socket_ = network::create_udp_socket();
+    network::set_nonblocking(socket_);
+    if (cfg.measure_latency) {
+        sockaddr_in bind_addr = network::make_address(cfg.bind_ip, static_cast<std::uint16_t>(cfg.bind_port));
+        if (bind(socket_, reinterpret_cast<sockaddr*>(&bind_addr), sizeof(bind_addr)) < 0) {
+            logger_.error("Failed to bind gimbal feedback socket; latency measurement disabled");
+        } else {
+            latency_.reset();
+            measuring_ = true;
+            feedback_event_ = reactor_.add_socket(loop_, socket_, network::Reactor::kReadable,
+                                                  [this](std::uint32_t) { on_feedback(); });
+            BRIDGE_LOG_INFOF(logger_, "Gimbal latency measurement listening on {}",
+                             network::describe_endpoint(cfg.bind_ip, static_cast<std::uint16_t>(cfg.bind_port)));
         }
-    } catch (const std::exception& ex) {
-        logger_.error(std::string("Gimbal control error: ") + ex.what());
     }
-    network::close_socket(sock);
+    last_tick_ = std::chrono::steady_clock::now();
+    timer_ = reactor_.add_timer(loop_, period_, [this] { tick(); });
+}
+
+// Everything tick() needs is derived from `cfg` here, so the send path never
+// touches config_mutex_. A changed rate re-arms the timer.
+void GimbalControl::load(const settings::GimbalSettings& cfg) {
+    target_ = network::make_address(cfg.generator_ip, static_cast<std::uint16_t>(cfg.generator_port));
+    format_ = gimbal_packet::parse_format(cfg.packet_format);
+    sensor_type_ = cfg.sensor_type;
+    sensor_id_ = cfg.sensor_id;
+    limits_ = TrajectoryLimits{cfg.max_rate_dps, cfg.max_accel_dps2, cfg.max_zoom_rate, cfg.max_zoom_accel};
+    const auto period = send_period(cfg);
+    if (period != period_) {
+        period_ = period;
+        pose_history_.set_max_extrapolation(2 * period_.count());
+        if (timer_.active()) timer_ = reactor_.add_timer(loop_, period_, [this] { tick(); });
+    }
+}
+
+void GimbalControl::tick() {
+    auto now = std::chrono::steady_clock::now();
+    double dt = std::chrono::duration<double>(now - last_tick_).count();
+    last_tick_ = now;
+
+    GimbalPose pose;
+    {
+        std::lock_guard<std::mutex> lock(pose_mutex_);
+        GimbalPose steer_target;
+        if (take_steer_target(steer_target)) trajectory_.set_target(steer_target, limits_);
+        pose = trajectory_.step(dt);
+    }
+    std::size_t length =
+        gimbal_packet::encode(network::codec::span_of(packet_), format_, pose, sensor_type_, sensor_id_);
+    if (measuring_) {
+        if (++next_sequence_ == 0) ++next_sequence_;
+        gimbal_packet::write_tag(network::codec::span_of(packet_), next_sequence_);
+        auto& slot = inflight_[next_sequence_ % kInflightSlots];
+        slot.sent_ns.store(steady_ns(), std::memory_order_relaxed);
+        slot.sequence.store(next_sequence_, std::memory_order_release);
+    }
+    if (sendto(socket_, reinterpret_cast<const char*>(packet_.data()), static_cast<int>(length), 0,
+               reinterpret_cast<sockaddr*>(&target_), sizeof(target_)) < 0) {
+        send_errors_.add();
+        BRIDGE_LOG_WARNF_LIMITED(logger_, "Gimbal command send failed: {}", network::last_socket_error());
+    } else {
+        commands_sent_.add();
+    }
+    pose_history_.push(steady_ns(), pose);
+}
+
+void GimbalControl::on_feedback() {
+    std::array<std::uint8_t, 512> buffer{};
+    for (int i = 0; i < kMaxBatch; ++i) {
+        sockaddr_in src{};
+        socklen_t len = sizeof(src);
+        ssize_t received = recvfrom(socket_, reinterpret_cast<char*>(buffer.data()), static_cast<int>(buffer.size()),
+                                    0, reinterpret_cast<sockaddr*>(&src), &len);
+        if (received < 0) {
+            // EAGAIN ends the batch; ICMP errors from the generator are dropped.
+            return;
+        }
+        std::uint32_t sequence = 0;
+        if (gimbal_packet::read_tag(network::codec::ConstByteSpan{buffer.data(), static_cast<std::size_t>(received)},
+                                    sequence)) {
+            record_feedback(sequence);
+        }
+    }
+}
+
+void GimbalControl::record_feedback(std::uint32_t sequence) {
+    auto& slot = inflight_[sequence % kInflightSlots];
+    std::uint32_t expected = sequence;
+    // Claim the slot so duplicated echoes are only counted once.
+    if (!slot.sequence.compare_exchange_strong(expected, 0, std::memory_order_acq_rel)) {
+        return;
+    }
+    std::int64_t elapsed = steady_ns() - slot.sent_ns.load(std::memory_order_relaxed);
+    if (elapsed >= 0) {
+        latency_.record(static_cast<std::uint64_t>(elapsed));
+    }
 }
 
 }  // namespace core
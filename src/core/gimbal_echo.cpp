@@ -0,0 +1,79 @@
+#include "core/gimbal_echo.hpp"
+
+#ifdef _WIN32
+#include <BaseTsd.h>
+#include <winsock2.h>
+#include <ws2tcpip.h>
+using ssize_t = SSIZE_T;
+#else
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#include <chrono>
+#include <vector>
+
+#include "network/socket_utils.hpp"
+#include "utils/thread_tuning.hpp"
+
+namespace core {
+
+GimbalEcho::GimbalEcho(std::string bind_ip, int port, int delay_ms, logging::Logger& logger)
+    : bind_ip_(std::move(bind_ip)), port_(port), delay_ms_(delay_ms), logger_(logger) {}
+
+GimbalEcho::~GimbalEcho() { stop(); }
+
+void GimbalEcho::start() {
+    if (running_) return;
+    try {
+        socket_ = network::create_udp_socket();
+        sockaddr_in addr = network::make_address(bind_ip_, static_cast<std::uint16_t>(port_));
+        if (bind(socket_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+            logger_.error("Failed to bind gimbal echo socket");
+            network::close_socket(socket_);
+            socket_ = -1;
+            return;
+        }
+    } catch (const std::exception& ex) {
+        logger_.error(std::string("Gimbal echo error: ") + ex.what());
+        network::close_socket(socket_);
+        socket_ = -1;
+        return;
+    }
+    network::set_receive_timeout(socket_, 200);
+    running_ = true;
+    thread_ = std::thread(&GimbalEcho::loop, this);
+    BRIDGE_LOG_INFOF(logger_, "Gimbal echo stand-in listening on {}", network::describe_endpoint(bind_ip_, static_cast<std::uint16_t>(port_)));
+}
+
+void GimbalEcho::stop() {
+    if (!running_) return;
+    running_ = false;
+    if (thread_.joinable()) thread_.join();
+    network::close_socket(socket_);
+    socket_ = -1;
+    logger_.info("Gimbal echo stand-in stopped");
+}
+
+void GimbalEcho::loop() {
+    utils::set_current_thread_name("gimbal-echo");
+    std::vector<std::uint8_t> buffer(2048);
+    while (running_) {
+        sockaddr_in src{};
+        socklen_t len = sizeof(src);
+        ssize_t received = recvfrom(socket_, reinterpret_cast<char*>(buffer.data()), static_cast<int>(buffer.size()), 0,
+                                    reinterpret_cast<sockaddr*>(&src), &len);
+        if (received < 0) {
+            continue;
+        }
+        if (delay_ms_ > 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(delay_ms_));
+        }
+        sendto(socket_, reinterpret_cast<const char*>(buffer.data()), static_cast<int>(received), 0,
+               reinterpret_cast<sockaddr*>(&src), len);
+        ++echoed_;
+    }
+}
+
+}  // namespace core
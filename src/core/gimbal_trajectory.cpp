@@ -0,0 +1,111 @@
+#include "core/gimbal_trajectory.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace core {
+
+namespace {
+constexpr double kArrivalEpsilon = 1e-3;
+}
+
+bool GimbalTrajectory::Axis::advance(double& position, double target, double max_rate, double max_accel, double dt) {
+    double error = target - position;
+    if (max_rate <= 0.0 && max_accel <= 0.0) {
+        position = target;
+        velocity = 0.0;
+        return true;
+    }
+    double accel_step = max_accel > 0.0 ? max_accel * dt : HUGE_VAL;
+    if (std::fabs(error) < kArrivalEpsilon && std::fabs(velocity) <= accel_step) {
+        position = target;
+        velocity = 0.0;
+        return true;
+    }
+
+    double direction = error > 0.0 ? 1.0 : -1.0;
+    // Fastest speed from which the axis can still stop exactly on target.
+    double speed = max_accel > 0.0 ? std::sqrt(2.0 * max_accel * std::fabs(error)) : HUGE_VAL;
+    if (max_rate > 0.0) speed = std::min(speed, max_rate);
+    if (!std::isfinite(speed)) {
+        position = target;
+        velocity = 0.0;
+        return true;
+    }
+
+    double desired = direction * speed;
+    velocity += std::clamp(desired - velocity, -accel_step, accel_step);
+    position += velocity * dt;
+
+    if ((target - position) * direction <= 0.0) {
+        position = target;
+        velocity = 0.0;
+        return true;
+    }
+    return false;
+}
+
+void GimbalTrajectory::reset(const GimbalPose& pose) {
+    current_ = pose;
+    target_ = pose;
+    waypoints_.clear();
+    yaw_axis_ = Axis{};
+    pitch_axis_ = Axis{};
+    roll_axis_ = Axis{};
+    zoom_axis_ = Axis{};
+    active_ = false;
+}
+
+void GimbalTrajectory::set_target(const GimbalPose& target, const TrajectoryLimits& limits) {
+    waypoints_.clear();
+    target_ = target;
+    limits_ = limits;
+    active_ = true;
+}
+
+void GimbalTrajectory::set_waypoints(std::vector<GimbalPose> waypoints, const TrajectoryLimits& limits) {
+    waypoints_.assign(waypoints.begin(), waypoints.end());
+    limits_ = limits;
+    if (waypoints_.empty()) {
+        hold();
+        return;
+    }
+    target_ = waypoints_.front();
+    waypoints_.pop_front();
+    active_ = true;
+}
+
+void GimbalTrajectory::hold() {
+    waypoints_.clear();
+    target_ = current_;
+    yaw_axis_.velocity = 0.0;
+    pitch_axis_.velocity = 0.0;
+    roll_axis_.velocity = 0.0;
+    zoom_axis_.velocity = 0.0;
+    active_ = false;
+}
+
+const GimbalPose& GimbalTrajectory::step(double dt_seconds) {
+    if (!active_ || dt_seconds <= 0.0) {
+        return current_;
+    }
+
+    bool arrived = true;
+    arrived &= yaw_axis_.advance(current_.yaw, target_.yaw, limits_.max_rate, limits_.max_accel, dt_seconds);
+    arrived &= pitch_axis_.advance(current_.pitch, target_.pitch, limits_.max_rate, limits_.max_accel, dt_seconds);
+    arrived &= roll_axis_.advance(current_.roll, target_.roll, limits_.max_rate, limits_.max_accel, dt_seconds);
+    arrived &= zoom_axis_.advance(current_.zoom, target_.zoom, limits_.max_zoom_rate, limits_.max_zoom_accel,
+                                  dt_seconds);
+
+    if (arrived) {
+        if (waypoints_.empty()) {
+            active_ = false;
+        } else {
+            target_ = waypoints_.front();
+            waypoints_.pop_front();
+        }
+    }
+    return current_;
+}
+
+}  // namespace core
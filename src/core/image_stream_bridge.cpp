@@ -11,71 +11,208 @@ using ssize_t = SSIZE_T;
 #include <unistd.h>
 #endif
 
+#include <algorithm>
 #include <chrono>
 #include <cstring>
+#include <limits>
 #include <vector>
 
+#include "core/pose_history.hpp"
 #include "network/socket_utils.hpp"
 
 namespace core {
 
-ImageStreamBridge::ImageStreamBridge(const settings::BridgeSettings& cfg, logging::Logger& logger)
-    : config_(cfg), logger_(logger) {}
+namespace {
+
+// Frames handled per readiness event before other registrations get a turn.
+constexpr int kMaxBatch = 64;
+// Each viewer is sent the newest frame at this interval.
+constexpr auto kViewerInterval = std::chrono::milliseconds(30);
+
+std::int64_t steady_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+}  // namespace
+
+ImageStreamBridge::ImageStreamBridge(const settings::BridgeSettings& cfg, network::Reactor& reactor,
+                                     logging::Logger& logger)
+    : config_(cfg),
+      logger_(logger),
+      reactor_(reactor),
+      loop_(reactor.next_loop()),
+      buffer_(2 * 1024 * 1024),
+      frames_received_(metrics::default_registry().counter("image_frames_received", "Frames received over UDP")),
+      bytes_received_(metrics::default_registry().counter("image_bytes_received", "Frame bytes received over UDP")),
+      receive_errors_(metrics::default_registry().counter("image_receive_errors", "Failed UDP frame receives")),
+      bytes_sent_(metrics::default_registry().counter("image_bytes_sent", "Frame bytes sent to TCP viewers")),
+      tcp_clients_(metrics::default_registry().gauge("image_tcp_clients", "Connected TCP viewers")),
+      frame_interval_(metrics::default_registry().histogram("image_frame_interval",
+                                                            "Time between consecutive UDP frames")) {
+    frame_age_ = metrics::default_registry().observe(
+        "image_last_frame_age_seconds", "Seconds since the newest UDP frame arrived (NaN before the first)", {},
+        metrics::MetricType::Gauge, [this] {
+            std::int64_t last = last_frame_steady_ns_.load(std::memory_order_relaxed);
+            if (last == 0) return std::numeric_limits<double>::quiet_NaN();
+            std::int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                   std::chrono::steady_clock::now().time_since_epoch())
+                                   .count();
+            return static_cast<double>(now - last) / 1e9;
+        });
+}
 
 ImageStreamBridge::~ImageStreamBridge() { stop(); }
 
 void ImageStreamBridge::start() {
+    std::lock_guard<std::mutex> lock(control_mutex_);
     if (running_) return;
-    running_ = true;
 
-    udp_socket_ = network::create_udp_socket();
-    sockaddr_in addr = network::make_address(config_.ip, static_cast<std::uint16_t>(config_.udp_port));
-    if (bind(udp_socket_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+    int udp = open_udp(config_.ip, config_.udp_port);
+    if (udp < 0) {
         logger_.error("Failed to bind UDP socket for image stream");
-        network::close_socket(udp_socket_);
-        udp_socket_ = -1;
-        running_ = false;
         return;
     }
-
-    tcp_socket_ = network::create_tcp_socket();
-    int opt = 1;
-#ifdef _WIN32
-    setsockopt(tcp_socket_, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&opt), sizeof(opt));
-#else
-    setsockopt(tcp_socket_, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
-#endif
-    sockaddr_in tcp_addr = network::make_address(config_.ip, static_cast<std::uint16_t>(config_.tcp_port));
-    if (bind(tcp_socket_, reinterpret_cast<sockaddr*>(&tcp_addr), sizeof(tcp_addr)) < 0 ||
-        listen(tcp_socket_, 5) < 0) {
+    int tcp = open_tcp(config_.ip, config_.tcp_port);
+    if (tcp < 0) {
         logger_.error("Failed to bind TCP socket for image stream");
-        network::close_socket(tcp_socket_);
-        tcp_socket_ = -1;
-        running_ = false;
+        network::close_socket(udp);
         return;
     }
 
-    udp_thread_ = std::thread(&ImageStreamBridge::udp_loop, this);
-    tcp_thread_ = std::thread(&ImageStreamBridge::tcp_loop, this);
-    logger_.infof("Image stream bridge started on UDP {} and TCP {}", config_.udp_port, config_.tcp_port);
+    running_ = true;
+    start_udp(udp);
+    start_tcp(tcp);
+    BRIDGE_LOG_INFOF(logger_, "Image stream bridge started on UDP {} and TCP {}", config_.udp_port, config_.tcp_port);
 }
 
 void ImageStreamBridge::stop() {
+    std::lock_guard<std::mutex> lock(control_mutex_);
     if (!running_) return;
     running_ = false;
+    stop_udp();
+    stop_tcp();
+    close_viewers();
+    logger_.info("Image stream bridge stopped");
+}
+
+bool ImageStreamBridge::apply_settings(const settings::BridgeSettings& cfg) {
+    std::lock_guard<std::mutex> lock(control_mutex_);
+    if (cfg == config_) return false;
+    const bool udp_changed = cfg.ip != config_.ip || cfg.udp_port != config_.udp_port;
+    const bool tcp_changed = cfg.ip != config_.ip || cfg.tcp_port != config_.tcp_port;
+
+    const settings::BridgeSettings previous = config_;
+    config_ = cfg;
+    if (!running_) return true;
+
+    // The old socket is released first so the new address may reuse its
+    // port; if the new bind fails the previous address is restored.
+    bool rebind_failed = false;
+    if (udp_changed) {
+        stop_udp();
+        int sock = open_udp(cfg.ip, cfg.udp_port);
+        if (sock < 0) {
+            BRIDGE_LOG_ERRORF(logger_, "Image stream UDP rebind to {} failed; keeping {}",
+                              network::describe_endpoint(cfg.ip, static_cast<std::uint16_t>(cfg.udp_port)),
+                              network::describe_endpoint(previous.ip, static_cast<std::uint16_t>(previous.udp_port)));
+            rebind_failed = true;
+            sock = open_udp(previous.ip, previous.udp_port);
+        } else {
+            BRIDGE_LOG_INFOF(logger_, "Image stream UDP rebound to {}",
+                             network::describe_endpoint(cfg.ip, static_cast<std::uint16_t>(cfg.udp_port)));
+        }
+        if (sock >= 0) start_udp(sock);
+    }
+    if (tcp_changed) {
+        stop_tcp();
+        int sock = open_tcp(cfg.ip, cfg.tcp_port);
+        if (sock < 0) {
+            BRIDGE_LOG_ERRORF(logger_, "Image stream TCP rebind to {} failed; keeping {}",
+                              network::describe_endpoint(cfg.ip, static_cast<std::uint16_t>(cfg.tcp_port)),
+                              network::describe_endpoint(previous.ip, static_cast<std::uint16_t>(previous.tcp_port)));
+            rebind_failed = true;
+            sock = open_tcp(previous.ip, previous.tcp_port);
+        } else {
+            BRIDGE_LOG_INFOF(logger_, "Image stream TCP listener rebound to {}",
+                             network::describe_endpoint(cfg.ip, static_cast<std::uint16_t>(cfg.tcp_port)));
+        }
+        if (sock >= 0) start_tcp(sock);
+    }
+    if (rebind_failed) {
+        // Keep describing the old addresses so the next apply retries.
+        config_.ip = previous.ip;
+        config_.udp_port = previous.udp_port;
+        config_.tcp_port = previous.tcp_port;
+    }
+    return true;
+}
 
-    if (udp_socket_ >= 0) {
-        network::close_socket(udp_socket_);
-        udp_socket_ = -1;
+int ImageStreamBridge::open_udp(const std::string& ip, int port) {
+    int sock = network::create_udp_socket();
+    sockaddr_in addr = network::make_address(ip, static_cast<std::uint16_t>(port));
+    if (bind(sock, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+        network::close_socket(sock);
+        return -1;
     }
-    if (tcp_socket_ >= 0) {
-        network::close_socket(tcp_socket_);
-        tcp_socket_ = -1;
+    network::set_nonblocking(sock);
+    return sock;
+}
+
+int ImageStreamBridge::open_tcp(const std::string& ip, int port) {
+    int sock = network::create_tcp_socket();
+    int opt = 1;
+#ifdef _WIN32
+    setsockopt(sock, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&opt), sizeof(opt));
+#else
+    setsockopt(sock, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
+#endif
+    sockaddr_in addr = network::make_address(ip, static_cast<std::uint16_t>(port));
+    if (bind(sock, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 || listen(sock, 5) < 0) {
+        network::close_socket(sock);
+        return -1;
     }
+    network::set_nonblocking(sock);
+    return sock;
+}
 
-    if (udp_thread_.joinable()) udp_thread_.join();
-    if (tcp_thread_.joinable()) tcp_thread_.join();
-    logger_.info("Image stream bridge stopped");
+void ImageStreamBridge::start_udp(int sock) {
+    reactor_.run_sync(loop_, [&] {
+        udp_socket_ = sock;
+        udp_event_ = reactor_.add_socket(loop_, sock, network::Reactor::kReadable,
+                                         [this](std::uint32_t) { on_udp_readable(); });
+    });
+}
+
+void ImageStreamBridge::start_tcp(int sock) {
+    reactor_.run_sync(loop_, [&] {
+        tcp_socket_ = sock;
+        tcp_event_ = reactor_.add_socket(loop_, sock, network::Reactor::kReadable,
+                                         [this](std::uint32_t) { on_tcp_accept(); });
+    });
+}
+
+// Removal is synchronous, so the sockets can be closed as soon as the
+// registration is gone.
+void ImageStreamBridge::stop_udp() {
+    reactor_.run_sync(loop_, [&] {
+        udp_event_.reset();
+        network::close_socket(udp_socket_.exchange(-1));
+    });
+}
+
+void ImageStreamBridge::stop_tcp() {
+    reactor_.run_sync(loop_, [&] {
+        tcp_event_.reset();
+        network::close_socket(tcp_socket_.exchange(-1));
+    });
+}
+
+void ImageStreamBridge::close_viewers() {
+    reactor_.run_sync(loop_, [&] {
+        while (!viewers_.empty()) close_viewer(viewers_.back().get());
+    });
 }
 
 ImageStreamStatus ImageStreamBridge::status() const {
@@ -83,75 +220,208 @@ ImageStreamStatus ImageStreamBridge::status() const {
     ImageStreamStatus st;
     st.udp_running = running_ && udp_socket_ >= 0;
     st.tcp_running = running_ && tcp_socket_ >= 0;
-    st.last_frame_bytes = last_frame_.size();
-    st.last_frame_time = last_frame_time_;
-    st.clients = tcp_clients_;
+    st.last_frame_bytes = last_frame_ ? last_frame_->size() : 0;
+    st.last_frame_time = last_frame_meta_.received_at;
+    st.clients = static_cast<std::size_t>(std::max<std::int64_t>(tcp_clients_.value(), 0));
+    st.last_frame_meta = last_frame_meta_;
     return st;
 }
 
-void ImageStreamBridge::udp_loop() {
-    std::vector<std::uint8_t> buffer(2 * 1024 * 1024);
-    while (running_) {
+void ImageStreamBridge::set_status_feed(StatusFeed* feed) {
+    reactor_.run_sync(loop_, [&] {
+        feed_timer_.reset();
+        feed_ = feed;
+        if (!feed_) return;
+        published_ns_ = steady_ns();
+        published_frames_ = frames_received_.value();
+        published_bytes_ = bytes_received_.value();
+        feed_timer_ = reactor_.add_timer(loop_, StatusFeed::kPublishPeriod, [this] { publish_status(); });
+    });
+}
+
+void ImageStreamBridge::publish_status() {
+    StatusDelta delta;
+    delta.source = StatusDelta::Source::Image;
+    delta.running = running_;
+    delta.steady_ns = steady_ns();
+    delta.interval_ns = delta.steady_ns - published_ns_;
+    const std::uint64_t frames = frames_received_.value();
+    const std::uint64_t bytes = bytes_received_.value();
+    delta.packets = frames - published_frames_;
+    delta.bytes = bytes - published_bytes_;
+    const std::int64_t last = last_frame_steady_ns_.load(std::memory_order_relaxed);
+    delta.frame_age_ns = last == 0 ? -1 : delta.steady_ns - last;
+    published_ns_ = delta.steady_ns;
+    published_frames_ = frames;
+    published_bytes_ = bytes;
+    feed_->publish(delta);
+}
+
+void ImageStreamBridge::set_pose_source(const PoseHistory* history) {
+    pose_source_.store(history, std::memory_order_release);
+}
+
+FrameMetadata ImageStreamBridge::latest_frame(std::vector<std::uint8_t>& out) const {
+    std::lock_guard<std::mutex> lock(frame_mutex_);
+    if (last_frame_) {
+        out = *last_frame_;
+    } else {
+        out.clear();
+    }
+    return last_frame_meta_;
+}
+
+FrameMetadata ImageStreamBridge::latest_frame(std::shared_ptr<const std::vector<std::uint8_t>>& out) const {
+    std::lock_guard<std::mutex> lock(frame_mutex_);
+    out = last_frame_;
+    return last_frame_meta_;
+}
+
+void ImageStreamBridge::on_udp_readable() {
+    const int sock = udp_socket_;
+    for (int i = 0; i < kMaxBatch; ++i) {
         sockaddr_in src{};
         socklen_t len = sizeof(src);
-        ssize_t received = recvfrom(udp_socket_, reinterpret_cast<char*>(buffer.data()), static_cast<int>(buffer.size()),
+        ssize_t received = recvfrom(sock, reinterpret_cast<char*>(buffer_.data()), static_cast<int>(buffer_.size()),
                                     0, reinterpret_cast<sockaddr*>(&src), &len);
         if (received < 0) {
-            if (!running_) break;
-            continue;
+            auto error = network::last_socket_error();
+            if (network::would_block(error)) return;
+            receive_errors_.add();
+            BRIDGE_LOG_WARNF_LIMITED(logger_, "Image stream UDP receive failed: {}", error);
+            return;
+        }
+
+        FrameMetadata meta;
+        meta.received_at = std::chrono::system_clock::now();
+        meta.received_steady_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                      std::chrono::steady_clock::now().time_since_epoch())
+                                      .count();
+        if (const PoseHistory* history = pose_source_.load(std::memory_order_acquire)) {
+            meta.has_pose = history->pose_at(meta.received_steady_ns, meta.pose);
         }
 
+        auto bytes = static_cast<std::size_t>(received);
+        auto frame = std::make_shared<const std::vector<std::uint8_t>>(
+            buffer_.begin(), buffer_.begin() + static_cast<std::ptrdiff_t>(bytes));
+        std::int64_t previous_ns = 0;
         {
             std::lock_guard<std::mutex> lock(frame_mutex_);
-            auto bytes = static_cast<std::size_t>(received);
-            last_frame_.assign(buffer.begin(), buffer.begin() + bytes);
-            last_frame_time_ = std::chrono::system_clock::now();
+            last_frame_ = std::move(frame);
+            meta.sequence = last_frame_meta_.sequence + 1;
+            previous_ns = last_frame_meta_.received_steady_ns;
+            last_frame_meta_ = meta;
+        }
+        last_frame_steady_ns_.store(meta.received_steady_ns, std::memory_order_relaxed);
+        frames_received_.add();
+        bytes_received_.add(bytes);
+        if (previous_ns > 0 && meta.received_steady_ns > previous_ns) {
+            frame_interval_.record(static_cast<std::uint64_t>(meta.received_steady_ns - previous_ns));
         }
     }
 }
 
-void ImageStreamBridge::tcp_loop() {
-    while (running_) {
+void ImageStreamBridge::on_tcp_accept() {
+    const int sock = tcp_socket_;
+    while (true) {
         sockaddr_in cli{};
         socklen_t len = sizeof(cli);
-        int client_fd = accept(tcp_socket_, reinterpret_cast<sockaddr*>(&cli), &len);
-        if (client_fd < 0) {
-            if (!running_) break;
-            continue;
+        int client_fd = static_cast<int>(accept(sock, reinterpret_cast<sockaddr*>(&cli), &len));
+        if (client_fd < 0) return;
+
+        network::set_nonblocking(client_fd);
+        auto viewer = std::make_unique<Viewer>();
+        Viewer* raw = viewer.get();
+        viewer->fd = client_fd;
+        viewer->event = reactor_.add_socket(loop_, client_fd, network::Reactor::kReadable,
+                                            [this, raw](std::uint32_t events) { on_viewer_event(raw, events); });
+        viewers_.push_back(std::move(viewer));
+        tcp_clients_.add(1);
+        logger_.info("TCP viewer connected");
+
+        if (!viewer_timer_.active()) {
+            viewer_timer_ = reactor_.add_timer(loop_, kViewerInterval, [this] { on_viewer_tick(); });
         }
+    }
+}
 
-        {
-            std::lock_guard<std::mutex> lock(frame_mutex_);
-            ++tcp_clients_;
+void ImageStreamBridge::on_viewer_event(Viewer* viewer, std::uint32_t events) {
+    if (events & network::Reactor::kReadable) {
+        // Viewers never send anything; readability means EOF or an error.
+        char scratch[256];
+        ssize_t received = recv(viewer->fd, scratch, sizeof(scratch), 0);
+        if (received == 0 || (received < 0 && !network::would_block(network::last_socket_error()))) {
+            close_viewer(viewer);
+            return;
         }
+    }
+    if ((events & network::Reactor::kWritable) && !flush_viewer(*viewer)) {
+        close_viewer(viewer);
+    }
+}
 
-        std::thread([this, client_fd]() {
-            logger_.info("TCP viewer connected");
-            while (running_) {
-                std::vector<std::uint8_t> frame_copy;
-                {
-                    std::lock_guard<std::mutex> lock(frame_mutex_);
-                    frame_copy = last_frame_;
-                }
-                if (frame_copy.empty()) {
-                    std::this_thread::sleep_for(std::chrono::milliseconds(50));
-                    continue;
-                }
-                ssize_t sent = send(client_fd, reinterpret_cast<const char*>(frame_copy.data()),
-                                     static_cast<int>(frame_copy.size()), 0);
-                if (sent < 0) {
-                    break;
-                }
-                std::this_thread::sleep_for(std::chrono::milliseconds(30));
-            }
-            network::close_socket(client_fd);
-            {
-                std::lock_guard<std::mutex> lock(frame_mutex_);
-                if (tcp_clients_ > 0) --tcp_clients_;
+void ImageStreamBridge::on_viewer_tick() {
+    std::shared_ptr<const std::vector<std::uint8_t>> frame;
+    {
+        std::lock_guard<std::mutex> lock(frame_mutex_);
+        frame = last_frame_;
+    }
+    if (!frame || frame->empty()) return;
+
+    // Iterate by index: close_viewer() erases from viewers_.
+    for (std::size_t i = 0; i < viewers_.size();) {
+        Viewer& viewer = *viewers_[i];
+        if (viewer.frame) {
+            // Still writing the previous frame; the writable event finishes it.
+            ++i;
+            continue;
+        }
+        viewer.frame = frame;
+        viewer.offset = 0;
+        if (flush_viewer(viewer)) {
+            ++i;
+        } else {
+            close_viewer(&viewer);
+        }
+    }
+}
+
+// Writes as much of the pending frame as the socket takes. Returns false when
+// the viewer has gone away.
+bool ImageStreamBridge::flush_viewer(Viewer& viewer) {
+    while (viewer.frame && viewer.offset < viewer.frame->size()) {
+        const auto& data = *viewer.frame;
+        ssize_t sent = send(viewer.fd, reinterpret_cast<const char*>(data.data() + viewer.offset),
+                            static_cast<int>(data.size() - viewer.offset), network::kStreamSendFlags);
+        if (sent < 0) {
+            if (!network::would_block(network::last_socket_error())) return false;
+            if (!viewer.want_write) {
+                reactor_.set_events(viewer.event, network::Reactor::kReadable | network::Reactor::kWritable);
+                viewer.want_write = true;
             }
-            logger_.info("TCP viewer disconnected");
-        }).detach();
+            return true;
+        }
+        viewer.offset += static_cast<std::size_t>(sent);
+        bytes_sent_.add(static_cast<std::uint64_t>(sent));
+    }
+    viewer.frame.reset();
+    if (viewer.want_write) {
+        reactor_.set_events(viewer.event, network::Reactor::kReadable);
+        viewer.want_write = false;
     }
+    return true;
+}
+
+void ImageStreamBridge::close_viewer(Viewer* viewer) {
+    auto it = std::find_if(viewers_.begin(), viewers_.end(),
+                           [viewer](const std::unique_ptr<Viewer>& v) { return v.get() == viewer; });
+    if (it == viewers_.end()) return;
+    viewer->event.reset();
+    network::close_socket(viewer->fd);
+    viewers_.erase(it);
+    tcp_clients_.sub(1);
+    logger_.info("TCP viewer disconnected");
+    if (viewers_.empty()) viewer_timer_.reset();
 }
 
 }  // namespace core
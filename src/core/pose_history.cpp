@@ -0,0 +1,98 @@
+#include "core/pose_history.hpp"
+
+namespace core {
+
+namespace {
+double lerp(double a, double b, double f) { return a + (b - a) * f; }
+}
+
+void PoseHistory::push(std::int64_t time_ns, const GimbalPose& pose) {
+    std::uint64_t index = head_.load(std::memory_order_relaxed);
+    Slot& slot = slots_[index % kCapacity];
+    slot.sequence.store(2 * index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.time_ns.store(time_ns, std::memory_order_relaxed);
+    slot.yaw.store(pose.yaw, std::memory_order_relaxed);
+    slot.pitch.store(pose.pitch, std::memory_order_relaxed);
+    slot.roll.store(pose.roll, std::memory_order_relaxed);
+    slot.zoom.store(pose.zoom, std::memory_order_relaxed);
+    slot.sequence.store(2 * index + 2, std::memory_order_release);
+    head_.store(index + 1, std::memory_order_release);
+}
+
+PoseHistory::ReadResult PoseHistory::read(std::uint64_t index, PoseSample& out) const {
+    const Slot& slot = slots_[index % kCapacity];
+    const std::uint64_t expected = 2 * index + 2;
+    while (true) {
+        std::uint64_t before = slot.sequence.load(std::memory_order_acquire);
+        if (before != expected) {
+            // Published slots below head only change when the writer laps them.
+            return ReadResult::Overwritten;
+        }
+        out.time_ns = slot.time_ns.load(std::memory_order_relaxed);
+        out.pose.yaw = slot.yaw.load(std::memory_order_relaxed);
+        out.pose.pitch = slot.pitch.load(std::memory_order_relaxed);
+        out.pose.roll = slot.roll.load(std::memory_order_relaxed);
+        out.pose.zoom = slot.zoom.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.sequence.load(std::memory_order_relaxed) == before) {
+            return ReadResult::Ok;
+        }
+    }
+}
+
+bool PoseHistory::latest(PoseSample& out) const {
+    std::uint64_t head = head_.load(std::memory_order_acquire);
+    return head > 0 && read(head - 1, out) == ReadResult::Ok;
+}
+
+std::size_t PoseHistory::size() const {
+    std::uint64_t head = head_.load(std::memory_order_acquire);
+    return static_cast<std::size_t>(head < kCapacity ? head : kCapacity);
+}
+
+void PoseHistory::set_max_extrapolation(std::int64_t age_ns) {
+    max_extrapolation_ns_.store(age_ns, std::memory_order_relaxed);
+}
+
+bool PoseHistory::pose_at(std::int64_t time_ns, GimbalPose& out) const {
+    std::uint64_t head = head_.load(std::memory_order_acquire);
+    if (head == 0) return false;
+
+    PoseSample newest;
+    if (read(head - 1, newest) != ReadResult::Ok) return false;
+    if (time_ns >= newest.time_ns) {
+        if (time_ns - newest.time_ns > max_extrapolation_ns_.load(std::memory_order_relaxed)) return false;
+        out = newest.pose;
+        return true;
+    }
+
+    // First index whose timestamp is later than time_ns.
+    std::uint64_t lo = head > kCapacity ? head - kCapacity : 0;
+    std::uint64_t hi = head - 1;
+    while (lo < hi) {
+        std::uint64_t mid = lo + (hi - lo) / 2;
+        PoseSample sample;
+        if (read(mid, sample) != ReadResult::Ok || sample.time_ns <= time_ns) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    if (lo == 0) return false;
+    PoseSample before;
+    PoseSample after;
+    if (read(lo - 1, before) != ReadResult::Ok || read(lo, after) != ReadResult::Ok) return false;
+    if (before.time_ns > time_ns) return false;
+
+    std::int64_t span = after.time_ns - before.time_ns;
+    double f = span > 0 ? static_cast<double>(time_ns - before.time_ns) / static_cast<double>(span) : 1.0;
+    out.yaw = lerp(before.pose.yaw, after.pose.yaw, f);
+    out.pitch = lerp(before.pose.pitch, after.pose.pitch, f);
+    out.roll = lerp(before.pose.roll, after.pose.roll, f);
+    out.zoom = lerp(before.pose.zoom, after.pose.zoom, f);
+    return true;
+}
+
+}  // namespace core
@@ -0,0 +1,13 @@
+#include "core/status_feed.hpp"
+
+namespace core {
+
+StatusFeed::StatusFeed(std::size_t capacity) : queue_(capacity) {}
+
+bool StatusFeed::publish(const StatusDelta& delta) {
+    if (queue_.try_push(delta)) return true;
+    dropped_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+}  // namespace core
@@ -11,144 +11,776 @@ using ssize_t = SSIZE_T;
 #include <unistd.h>
 #endif
 
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <charconv>
 #include <chrono>
+#include <cstring>
+#include <ctime>
 #include <filesystem>
-#include <iomanip>
 #include <sstream>
+#include <stdexcept>
 #include <vector>
 
+#ifdef BRIDGE_HAVE_IO_URING
+#include "network/io_uring.hpp"
+#endif
+
 #include "network/socket_utils.hpp"
+#include "utils/hex_encode.hpp"
+#include "utils/thread_tuning.hpp"
+#include "utils/timestamp.hpp"
 
 namespace core {
 
 namespace {
-std::string hex_dump(const std::vector<std::uint8_t>& data) {
-    std::ostringstream oss;
-    for (std::size_t i = 0; i < data.size(); ++i) {
-        if (i > 0) oss << ' ';
-        oss << std::hex << std::setw(2) << std::setfill('0')
-            << static_cast<int>(data[i]);
-    }
-    return oss.str();
-}
 
-std::string timestamp_string() {
-    auto now = std::chrono::system_clock::now();
-    auto tt = std::chrono::system_clock::to_time_t(now);
-    std::tm tm{};
+// Datagrams handled per readiness event before other registrations on the
+// loop get a turn.
+constexpr int kMaxBatch = 64;
+
+// Packet log writer: ~2 MiB of queued records, 64 KiB write batches.
+constexpr std::size_t kPacketLogQueue = 4096;
+constexpr std::size_t kPacketLogBatchBytes = 64 * 1024;
+constexpr auto kPacketLogFlushInterval = std::chrono::milliseconds(200);
+constexpr auto kPacketLogIdleSleep = std::chrono::milliseconds(5);
+
+// A connected UDP socket reports an ICMP error from an earlier datagram on
+// the next send, which then fails without being sent.
+bool connection_refused(const network::SocketError& error) {
 #ifdef _WIN32
-    localtime_s(&tm, &tt);
+    return error.code == WSAECONNRESET;
 #else
-    localtime_r(&tt, &tm);
+    return error.code == ECONNREFUSED;
 #endif
-    char buf[32];
-    std::strftime(buf, sizeof(buf), "%Y-%m-%d %H:%M:%S", &tm);
-    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()) % 1000;
-    std::ostringstream oss;
-    oss << buf << '.' << std::setw(3) << std::setfill('0') << ms.count();
-    return oss.str();
 }
+
+std::int64_t steady_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+}  // namespace
+
+// One forwarding target. Its socket is connect()ed, so the kernel resolves
+// the route once instead of per datagram and ICMP errors only ever surface
+// on this destination. The backlog is a ring of reusable buffers that fills
+// only while the socket buffer is full; writable interest is registered just
+// for as long as it is non-empty.
+struct UdpRelay::Destination {
+    Destination(const char* role, const std::string& ip, int port, int queue, const std::string& policy,
+                DestinationMetrics& metrics)
+        : ip(ip),
+          port(port),
+          queue(queue),
+          policy(policy),
+          name(std::string(role) + ' ' + network::describe_endpoint(ip, static_cast<std::uint16_t>(port))),
+          drop_newest(policy == "drop_newest"),
+          metrics(metrics),
+          backlog(static_cast<std::size_t>(std::max(queue, 0))) {
+        sockaddr_in addr = network::make_address(ip, static_cast<std::uint16_t>(port));
+        fd = network::create_udp_socket();
+        if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 || !network::set_nonblocking(fd)) {
+            std::ostringstream message;
+            message << "Failed to connect relay socket to " << name << ": " << network::last_socket_error();
+            network::close_socket(fd);
+            throw std::runtime_error(message.str());
+        }
+        metrics.queued.set(0);
+    }
+
+    ~Destination() {
+        event.reset();
+        network::close_socket(fd);
+        metrics.queued.set(0);
+    }
+
+    bool matches(const std::string& other_ip, int other_port, int other_queue, const std::string& other_policy) const {
+        return ip == other_ip && port == other_port && queue == other_queue && policy == other_policy;
+    }
+
+    const std::string ip;
+    const int port;
+    const int queue;
+    const std::string policy;  // "drop_oldest" (default) or "drop_newest"
+    const std::string name;    // "raw 127.0.0.1:10708", for logs
+    const bool drop_newest;
+    DestinationMetrics& metrics;
+    int fd = -1;
+    std::vector<std::vector<std::uint8_t>> backlog;
+    std::size_t head = 0;
+    std::size_t count = 0;
+    network::EventHandle event;
+};
+
+UdpRelay::DestinationMetrics UdpRelay::destination_metrics(const char* role) {
+    auto& registry = metrics::default_registry();
+    const metrics::Labels labels{{"destination", role}};
+    return DestinationMetrics{
+        registry.counter("relay_destination_sent_packets", "Datagrams handed to the kernel per destination", labels),
+        registry.counter("relay_destination_sent_bytes", "Payload bytes handed to the kernel per destination", labels),
+        registry.counter("relay_destination_dropped", "Datagrams dropped because the destination backlog was full",
+                         labels),
+        registry.counter("relay_destination_send_errors", "Failed sends per destination", labels),
+        registry.gauge("relay_destination_queued", "Datagrams waiting for the destination socket", labels)};
 }
 
-UdpRelay::UdpRelay(const settings::RelaySettings& cfg, logging::Logger& logger, RoverRelayLogger* rover_logger)
-    : config_(cfg), logger_(logger), rover_logger_(rover_logger) {}
+UdpRelay::UdpRelay(const settings::RelaySettings& cfg, network::Reactor& reactor, logging::Logger& logger,
+                   RoverRelayLogger* rover_logger)
+    : config_(cfg),
+      logger_(logger),
+      rover_logger_(rover_logger),
+      reactor_(reactor),
+      loop_(reactor.next_loop()),
+      buffer_(64 * 1024),
+      forwarded_packets_(metrics::default_registry().counter("relay_forwarded_packets",
+                                                             "Datagrams received and forwarded by the UDP relay")),
+      forwarded_bytes_(metrics::default_registry().counter("relay_forwarded_bytes",
+                                                           "Payload bytes forwarded by the UDP relay")),
+      receive_errors_(metrics::default_registry().counter("relay_receive_errors", "Failed recvfrom calls")),
+      send_errors_(metrics::default_registry().counter("relay_send_errors", "Failed sends to either destination")),
+      destination_metrics_{{destination_metrics("raw"), destination_metrics("proc")}} {}
 
 UdpRelay::~UdpRelay() { stop(); }
 
 void UdpRelay::start() {
-    if (running_ || !config_.enable) return;
-    running_ = true;
-    worker_thread_ = std::thread(&UdpRelay::worker, this);
-    logger_.info("UDP relay started");
+    std::lock_guard<std::mutex> lock(control_mutex_);
+    settings::RelaySettings cfg = config_snapshot();
+    if (running_ || !cfg.enable) return;
+    if (open_socket(cfg)) logger_.info("UDP relay started");
 }
 
 void UdpRelay::stop() {
+    std::lock_guard<std::mutex> lock(control_mutex_);
     if (!running_) return;
-    running_ = false;
-    if (worker_thread_.joinable()) worker_thread_.join();
+    close_socket();
     logger_.info("UDP relay stopped");
 }
 
-RelayStatus UdpRelay::status() const {
-    std::lock_guard<std::mutex> lock(stats_mutex_);
-    return RelayStatus{running_, forwarded_packets_, forwarded_bytes_};
+bool UdpRelay::apply_settings(const settings::RelaySettings& cfg) {
+    std::lock_guard<std::mutex> lock(control_mutex_);
+    settings::RelaySettings previous = config_snapshot();
+    if (cfg == previous) {
+        // Nothing changed, but a destination that failed to open gets
+        // another try.
+        if (running_) reactor_.run_sync(loop_, [&] { load_destinations(cfg); });
+        return false;
+    }
+    {
+        std::lock_guard<std::mutex> config_lock(config_mutex_);
+        config_ = cfg;
+    }
+
+    const bool bind_changed = cfg.bind_ip != previous.bind_ip || cfg.bind_port != previous.bind_port;
+    if (!cfg.enable) {
+        if (running_) {
+            close_socket();
+            logger_.info("UDP relay disabled");
+        }
+    } else if (!running_) {
+        if (open_socket(cfg)) logger_.info("UDP relay started");
+    } else if (bind_changed) {
+        close_socket();
+        if (open_socket(cfg)) {
+            BRIDGE_LOG_INFOF(logger_, "UDP relay rebound to {}",
+                             network::describe_endpoint(cfg.bind_ip, static_cast<std::uint16_t>(cfg.bind_port)));
+        }
+    } else {
+        try {
+            reactor_.run_sync(loop_, [&] { load_destinations(cfg); });
+            logger_.info("UDP relay destinations updated");
+        } catch (const std::exception& ex) {
+            logger_.error(std::string("UDP relay error: ") + ex.what());
+        }
+    }
+    return true;
 }
 
-void UdpRelay::worker() {
+bool UdpRelay::open_socket(const settings::RelaySettings& cfg) {
     int sock = -1;
     try {
         sock = network::create_udp_socket();
-        sockaddr_in bind_addr = network::make_address(config_.bind_ip, static_cast<std::uint16_t>(config_.bind_port));
+        sockaddr_in bind_addr = network::make_address(cfg.bind_ip, static_cast<std::uint16_t>(cfg.bind_port));
         if (bind(sock, reinterpret_cast<sockaddr*>(&bind_addr), sizeof(bind_addr)) < 0) {
             logger_.error("Failed to bind UDP relay socket");
-            running_ = false;
             network::close_socket(sock);
+            return false;
+        }
+        network::set_nonblocking(sock);
+        reactor_.run_sync(loop_, [&] {
+            load_destinations(cfg);
+            socket_ = sock;
+            if (reactor_.io_backend() == network::IoBackend::IoUring && open_uring()) return;
+            event_ = reactor_.add_socket(loop_, sock, network::Reactor::kReadable,
+                                         [this](std::uint32_t) { on_readable(); });
+        });
+    } catch (const std::exception& ex) {
+        logger_.error(std::string("UDP relay error: ") + ex.what());
+        network::close_socket(sock);
+        return false;
+    }
+    running_ = true;
+    return true;
+}
+
+// Deregistering is synchronous, so the socket can be closed right away.
+void UdpRelay::close_socket() {
+    running_ = false;
+    reactor_.run_sync(loop_, [&] {
+        if (uring_) close_uring();
+        event_.reset();
+        network::close_socket(socket_);
+        socket_ = -1;
+        for (auto& dest : destinations_) dest.reset();
+    });
+}
+
+// Reopens only the destinations whose settings changed (dropping their
+// backlog) and retries any that failed to open earlier. A destination that
+// cannot be opened, e.g. ENETUNREACH before its interface is up, is logged
+// and left disabled; the other one keeps forwarding.
+void UdpRelay::load_destinations(const settings::RelaySettings& cfg) {
+    struct Target {
+        const char* role;
+        const std::string& ip;
+        int port;
+        int queue;
+        const std::string& policy;
+    };
+    const Target targets[2] = {{"raw", cfg.raw_ip, cfg.raw_port, cfg.raw_queue, cfg.raw_drop_policy},
+                               {"proc", cfg.proc_ip, cfg.proc_port, cfg.proc_queue, cfg.proc_drop_policy}};
+    for (std::size_t i = 0; i < destinations_.size(); ++i) {
+        const Target& t = targets[i];
+        if (destinations_[i] && destinations_[i]->matches(t.ip, t.port, t.queue, t.policy)) continue;
+        destinations_[i].reset();
+        try {
+            destinations_[i] =
+                std::make_unique<Destination>(t.role, t.ip, t.port, t.queue, t.policy, destination_metrics_[i]);
+        } catch (const std::exception& ex) {
+            logger_.error(std::string("UDP relay destination disabled until settings are applied again: ") +
+                          ex.what());
+        }
+    }
+}
+
+settings::RelaySettings UdpRelay::config_snapshot() const {
+    std::lock_guard<std::mutex> lock(config_mutex_);
+    return config_;
+}
+
+RelayStatus UdpRelay::status() const {
+    RelayStatus st;
+    st.running = running_;
+    st.forwarded_packets = static_cast<std::size_t>(forwarded_packets_.value());
+    st.forwarded_bytes = static_cast<std::size_t>(forwarded_bytes_.value());
+    auto destination = [](const DestinationMetrics& m) {
+        return RelayDestinationStatus{static_cast<std::size_t>(m.sent_packets.value()),
+                                      static_cast<std::size_t>(m.dropped.value()),
+                                      static_cast<std::size_t>(m.send_errors.value()),
+                                      static_cast<std::size_t>(std::max<std::int64_t>(m.queued.value(), 0))};
+    };
+    st.raw = destination(destination_metrics_[0]);
+    st.proc = destination(destination_metrics_[1]);
+    return st;
+}
+
+void UdpRelay::set_status_feed(StatusFeed* feed) {
+    reactor_.run_sync(loop_, [&] {
+        feed_timer_.reset();
+        feed_ = feed;
+        if (!feed_) return;
+        published_ns_ = steady_ns();
+        published_packets_ = forwarded_packets_.value();
+        published_bytes_ = forwarded_bytes_.value();
+        feed_timer_ = reactor_.add_timer(loop_, StatusFeed::kPublishPeriod, [this] { publish_status(); });
+    });
+}
+
+void UdpRelay::publish_status() {
+    StatusDelta delta;
+    delta.source = StatusDelta::Source::Relay;
+    delta.running = running_;
+    delta.steady_ns = steady_ns();
+    delta.interval_ns = delta.steady_ns - published_ns_;
+    const std::uint64_t packets = forwarded_packets_.value();
+    const std::uint64_t bytes = forwarded_bytes_.value();
+    delta.packets = packets - published_packets_;
+    delta.bytes = bytes - published_bytes_;
+    published_ns_ = delta.steady_ns;
+    published_packets_ = packets;
+    published_bytes_ = bytes;
+    feed_->publish(delta);
+}
+
+void UdpRelay::on_readable() {
+    for (int i = 0; i < kMaxBatch; ++i) {
+        sockaddr_in src{};
+        socklen_t len = sizeof(src);
+        ssize_t received = recvfrom(socket_, reinterpret_cast<char*>(buffer_.data()), static_cast<int>(buffer_.size()),
+                                    0, reinterpret_cast<sockaddr*>(&src), &len);
+        if (received < 0) {
+            auto error = network::last_socket_error();
+            if (network::would_block(error)) return;
+            receive_errors_.add();
+            BRIDGE_LOG_WARNF_LIMITED(logger_, "UDP relay receive failed: {}", error);
             return;
         }
 
-        sockaddr_in raw_addr = network::make_address(config_.raw_ip, static_cast<std::uint16_t>(config_.raw_port));
-        sockaddr_in proc_addr = network::make_address(config_.proc_ip, static_cast<std::uint16_t>(config_.proc_port));
+        auto bytes = static_cast<std::size_t>(received);
+        for (auto& dest : destinations_) {
+            if (dest) forward(*dest, buffer_.data(), bytes);
+        }
 
-        std::vector<std::uint8_t> buffer(64 * 1024);
-        while (running_) {
-            sockaddr_in src{};
-            socklen_t len = sizeof(src);
-            ssize_t received = recvfrom(sock, reinterpret_cast<char*>(buffer.data()), static_cast<int>(buffer.size()), 0,
-                                        reinterpret_cast<sockaddr*>(&src), &len);
-            if (received < 0) {
-                if (!running_) break;
-                continue;
+        if (rover_logger_ && rover_logger_->active()) {
+            rover_logger_->log_packet(buffer_.data(), bytes);
+        }
+
+        forwarded_packets_.add();
+        forwarded_bytes_.add(bytes);
+    }
+}
+
+void UdpRelay::forward(Destination& dest, const std::uint8_t* data, std::size_t bytes) {
+    // Behind a backlog the datagram has to queue to keep its order.
+    if (dest.count == 0 && send_now(dest, data, bytes)) return;
+    enqueue(dest, data, bytes);
+}
+
+// Returns false only when the socket buffer is full; any other failure is
+// counted and the datagram given up.
+bool UdpRelay::send_now(Destination& dest, const std::uint8_t* data, std::size_t bytes) {
+    for (int attempt = 0; attempt < 2; ++attempt) {
+        if (::send(dest.fd, reinterpret_cast<const char*>(data), static_cast<int>(bytes), 0) >= 0) {
+            dest.metrics.sent_packets.add();
+            dest.metrics.sent_bytes.add(bytes);
+            return true;
+        }
+        auto error = network::last_socket_error();
+        if (network::would_block(error)) return false;
+        // The refusal belonged to an earlier datagram and is now cleared.
+        if (attempt == 0 && connection_refused(error)) continue;
+        dest.metrics.send_errors.add();
+        send_errors_.add();
+        BRIDGE_LOG_WARNF_LIMITED(logger_, "UDP relay send to {} failed: {}", dest.name, error);
+        return true;
+    }
+    return true;
+}
+
+void UdpRelay::enqueue(Destination& dest, const std::uint8_t* data, std::size_t bytes) {
+    const std::size_t capacity = dest.backlog.size();
+    if (dest.count == capacity) {
+        dest.metrics.dropped.add();
+        if (dest.drop_newest || capacity == 0) return;
+        dest.head = (dest.head + 1) % capacity;
+        --dest.count;
+    }
+    dest.backlog[(dest.head + dest.count) % capacity].assign(data, data + bytes);
+    ++dest.count;
+    dest.metrics.queued.set(static_cast<std::int64_t>(dest.count));
+    if (!dest.event.active()) {
+        Destination* target = &dest;
+        dest.event = reactor_.add_socket(loop_, dest.fd, network::Reactor::kWritable,
+                                         [this, target](std::uint32_t) { flush(*target); });
+    }
+}
+
+void UdpRelay::flush(Destination& dest) {
+    while (dest.count > 0) {
+        const auto& packet = dest.backlog[dest.head];
+        if (!send_now(dest, packet.data(), packet.size())) break;
+        dest.head = (dest.head + 1) % dest.backlog.size();
+        --dest.count;
+    }
+    dest.metrics.queued.set(static_cast<std::int64_t>(dest.count));
+    if (dest.count == 0) dest.event.reset();
+}
+
+#ifdef BRIDGE_HAVE_IO_URING
+
+namespace {
+
+constexpr std::uint64_t kRecvTag = ~std::uint64_t{0};
+constexpr std::uint64_t kCancelTag = kRecvTag - 1;
+// Send completions carry (position in the destination's batch << 1) |
+// destination, 0 = raw, 1 = proc.
+
+}  // namespace
+
+// One multishot receive keeps the socket armed; the kernel drops each
+// datagram into a provided buffer and the relay forwards it with one SEND
+// SQE per destination pointing at that buffer, so nothing is copied. A
+// buffer goes back to the kernel once its sends complete. All SQEs queued
+// during one reactor wake go out with a single io_uring_enter.
+struct UdpRelay::UringPath {
+    static constexpr unsigned kBuffers = 64;
+    static constexpr std::size_t kBufferSize = 64 * 1024;
+
+    struct Slot {
+        std::size_t bytes = 0;
+        int pending = 0;  // sends queued or in flight, plus holds
+    };
+
+    // Send ordering per destination. Datagrams are held by buffer id until
+    // the end of the wake, then sent as one batch; a destination has at
+    // most one batch in flight and what arrives meanwhile stays held. Once
+    // the whole batch has completed, failed sends (EAGAIN, ICMP refusal)
+    // after the last successful one go to the backlog in order; one that a
+    // later datagram already overtook is dropped instead of resent out of
+    // order. (Linking the SQEs would stop the overtaking but costs about a
+    // third of the throughput.)
+    struct DestinationRing {
+        unsigned inflight = 0;
+        std::vector<std::uint16_t> held;
+        std::vector<std::uint16_t> batch;  // buffer ids in send order
+        std::vector<std::int32_t> results;
+    };
+
+    network::IoUring ring{256};
+    network::BufferRing buffers{ring, 0, kBuffers, kBufferSize};
+    std::array<Slot, kBuffers> slots{};
+    std::array<DestinationRing, 2> destinations{};  // raw, proc
+    network::EventHandle event;
+    bool recv_armed = false;
+    bool recv_unsupported = false;
+    unsigned inflight_sends = 0;
+};
+
+bool UdpRelay::open_uring() {
+    try {
+        uring_ = std::make_unique<UringPath>();
+    } catch (const std::exception& ex) {
+        BRIDGE_LOG_WARNF(logger_, "io_uring unavailable ({}); UDP relay uses epoll", ex.what());
+        return false;
+    }
+    uring_->event = reactor_.add_socket(loop_, uring_->ring.fd(), network::Reactor::kReadable,
+                                        [this](std::uint32_t) { on_uring_ready(); });
+    arm_uring_recv();
+    uring_->ring.submit();
+    BRIDGE_LOG_INFOF(logger_, "UDP relay using io_uring ({} x {} KiB provided buffers)", UringPath::kBuffers,
+                     UringPath::kBufferSize / 1024);
+    return true;
+}
+
+// Cancels the receive and waits out every in-flight operation so no buffer
+// is released while the kernel may still touch it.
+void UdpRelay::close_uring() {
+    UringPath& u = *uring_;
+    u.event.reset();
+    // Held buffers never reached the kernel.
+    for (auto& d : u.destinations) {
+        for (std::uint16_t buffer : d.held) {
+            if (--u.slots[buffer].pending == 0) u.buffers.recycle(buffer);
+        }
+        d.held.clear();
+    }
+    if (u.recv_armed) {
+        if (io_uring_sqe* sqe = u.ring.get_sqe()) {
+            sqe->opcode = IORING_OP_ASYNC_CANCEL;
+            sqe->addr = kRecvTag;
+            sqe->user_data = kCancelTag;
+        }
+    }
+    while (u.recv_armed || u.inflight_sends > 0) {
+        if (u.ring.submit_and_wait(1) < 0) break;
+        u.ring.drain([this](const io_uring_cqe& cqe) {
+            handle_uring_completion(cqe.user_data, cqe.res, cqe.flags, false);
+        });
+    }
+    uring_.reset();
+}
+
+void UdpRelay::arm_uring_recv() {
+    io_uring_sqe* sqe = uring_->ring.get_sqe();
+    if (!sqe) {
+        uring_->ring.submit();
+        sqe = uring_->ring.get_sqe();
+    }
+    sqe->opcode = IORING_OP_RECV;
+    sqe->fd = socket_;
+    sqe->ioprio = IORING_RECV_MULTISHOT;
+    sqe->flags = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = uring_->buffers.group();
+    sqe->user_data = kRecvTag;
+    uring_->recv_armed = true;
+}
+
+void UdpRelay::on_uring_ready() {
+    uring_->ring.drain([this](const io_uring_cqe& cqe) {
+        handle_uring_completion(cqe.user_data, cqe.res, cqe.flags, true);
+    });
+    if (uring_->recv_unsupported) {
+        logger_.warn("Kernel lacks io_uring multishot receive; UDP relay falls back to epoll");
+        close_uring();
+        event_ = reactor_.add_socket(loop_, socket_, network::Reactor::kReadable,
+                                     [this](std::uint32_t) { on_readable(); });
+        return;
+    }
+    // The multishot receive ends on errors and when the buffer ring runs
+    // dry (ENOBUFS); buffers recycled above make re-arming worthwhile.
+    if (!uring_->recv_armed) arm_uring_recv();
+    send_held();
+    uring_->ring.submit();
+}
+
+void UdpRelay::handle_uring_completion(std::uint64_t user_data, std::int32_t res, std::uint32_t flags,
+                                       bool forward) {
+    UringPath& u = *uring_;
+    if (user_data == kCancelTag) return;
+    if (user_data == kRecvTag) {
+        if (!(flags & IORING_CQE_F_MORE)) u.recv_armed = false;
+        if (res < 0) {
+            if (res == -EINVAL) {
+                u.recv_unsupported = true;
+            } else if (res != -ENOBUFS && res != -ECANCELED) {
+                receive_errors_.add();
+                BRIDGE_LOG_WARNF_LIMITED(logger_, "UDP relay receive failed: {}", network::SocketError{-res});
             }
+            return;
+        }
+        if (!(flags & IORING_CQE_F_BUFFER)) return;
+        auto buffer = static_cast<std::uint16_t>(flags >> IORING_CQE_BUFFER_SHIFT);
+        if (forward) {
+            forward_uring(buffer, static_cast<std::size_t>(res));
+        } else {
+            u.buffers.recycle(buffer);
+        }
+        return;
+    }
 
-            auto bytes = static_cast<std::size_t>(received);
-            std::vector<std::uint8_t> packet(buffer.begin(), buffer.begin() + bytes);
-            sendto(sock, reinterpret_cast<const char*>(packet.data()), static_cast<int>(packet.size()), 0,
-                   reinterpret_cast<sockaddr*>(&raw_addr), sizeof(raw_addr));
-            sendto(sock, reinterpret_cast<const char*>(packet.data()), static_cast<int>(packet.size()), 0,
-                   reinterpret_cast<sockaddr*>(&proc_addr), sizeof(proc_addr));
+    const std::size_t index = user_data & 1;
+    UringPath::DestinationRing& ring = u.destinations[index];
+    ring.results[user_data >> 1] = res;
+    --u.inflight_sends;
+    if (--ring.inflight == 0) finish_uring_batch(index, forward);
+}
 
-            if (rover_logger_ && rover_logger_->active()) {
-                rover_logger_->log_packet(packet);
+// Accounts a completed batch and releases its buffers.
+void UdpRelay::finish_uring_batch(std::size_t index, bool forward) {
+    UringPath& u = *uring_;
+    UringPath::DestinationRing& ring = u.destinations[index];
+    std::size_t resend_from = 0;  // failures before this were overtaken
+    for (std::size_t i = 0; i < ring.results.size(); ++i) {
+        if (ring.results[i] >= 0) resend_from = i + 1;
+    }
+    // A destination that failed to reopen after a settings change is null.
+    Destination* dest = destinations_[index].get();
+    for (std::size_t i = 0; i < ring.batch.size(); ++i) {
+        const std::uint16_t buffer = ring.batch[i];
+        const std::int32_t res = ring.results[i];
+        if (dest && res >= 0) {
+            dest->metrics.sent_packets.add();
+            dest->metrics.sent_bytes.add(static_cast<std::uint64_t>(res));
+        } else if (dest && (res == -EAGAIN || res == -ECONNREFUSED)) {
+            // Full socket buffer, or an earlier ICMP error reported on this
+            // send: retry through the backlog unless that would reorder.
+            if (forward && i >= resend_from) {
+                enqueue(*dest, u.buffers.data(buffer), u.slots[buffer].bytes);
+            } else if (forward) {
+                dest->metrics.dropped.add();
             }
+        } else if (dest) {
+            dest->metrics.send_errors.add();
+            send_errors_.add();
+            BRIDGE_LOG_WARNF_LIMITED(logger_, "UDP relay send to {} failed: {}", dest->name,
+                                     network::SocketError{-res});
+        }
+        if (--u.slots[buffer].pending == 0) u.buffers.recycle(buffer);
+    }
+    ring.batch.clear();
+    ring.results.clear();
+}
 
-            {
-                std::lock_guard<std::mutex> lock(stats_mutex_);
-                forwarded_packets_++;
-                forwarded_bytes_ += static_cast<std::size_t>(packet.size());
+// Sends the held datagrams of every destination with no batch in flight,
+// or moves them behind the backlog a failed batch left. With 64 buffers a
+// batch never outgrows the submission queue.
+void UdpRelay::send_held() {
+    UringPath& u = *uring_;
+    for (std::size_t index = 0; index < u.destinations.size(); ++index) {
+        UringPath::DestinationRing& ring = u.destinations[index];
+        if (ring.inflight > 0 || ring.held.empty()) continue;
+        Destination* dest = destinations_[index].get();
+        std::size_t done = 0;
+        for (; done < ring.held.size(); ++done) {
+            const std::uint16_t buffer = ring.held[done];
+            if (dest && dest->count == 0) {
+                io_uring_sqe* sqe = u.ring.get_sqe();
+                if (!sqe) break;  // the rest waits for this batch
+                sqe->opcode = IORING_OP_SEND;
+                sqe->fd = dest->fd;
+                sqe->addr = reinterpret_cast<std::uint64_t>(u.buffers.data(buffer));
+                sqe->len = static_cast<std::uint32_t>(u.slots[buffer].bytes);
+                // Without MSG_DONTWAIT io_uring would park a send to a full
+                // socket until it drains, pinning the buffer and eventually
+                // starving the receive for both destinations.
+                sqe->msg_flags = MSG_DONTWAIT;
+                sqe->user_data = (static_cast<std::uint64_t>(ring.batch.size()) << 1) | index;
+                ring.batch.push_back(buffer);  // keeps the hold's reference
+                ring.results.push_back(0);
+                ++ring.inflight;
+                ++u.inflight_sends;
+                continue;
             }
+            // Queued behind the backlog, or the destination is gone.
+            if (dest) enqueue(*dest, u.buffers.data(buffer), u.slots[buffer].bytes);
+            if (--u.slots[buffer].pending == 0) u.buffers.recycle(buffer);
+        }
+        ring.held.erase(ring.held.begin(), ring.held.begin() + static_cast<std::ptrdiff_t>(done));
+    }
+}
+
+void UdpRelay::forward_uring(std::uint16_t buffer, std::size_t bytes) {
+    UringPath& u = *uring_;
+    UringPath::Slot& slot = u.slots[buffer];
+    const std::uint8_t* data = u.buffers.data(buffer);
+    slot.bytes = bytes;
+    slot.pending = 0;
+    for (std::size_t index = 0; index < destinations_.size(); ++index) {
+        if (!destinations_[index]) continue;
+        Destination& dest = *destinations_[index];
+        UringPath::DestinationRing& ring = u.destinations[index];
+        if (dest.count > 0 && ring.held.empty()) {
+            enqueue(dest, data, bytes);
+        } else {
+            ring.held.push_back(buffer);
+            ++slot.pending;
         }
-    } catch (const std::exception& ex) {
-        logger_.error(std::string("UDP relay error: ") + ex.what());
     }
-    network::close_socket(sock);
+
+    if (rover_logger_ && rover_logger_->active()) {
+        rover_logger_->log_packet(data, bytes);
+    }
+
+    forwarded_packets_.add();
+    forwarded_bytes_.add(bytes);
+    if (slot.pending == 0) u.buffers.recycle(buffer);
+}
+
+#else
+
+struct UdpRelay::UringPath {};
+
+bool UdpRelay::open_uring() {
+    logger_.warn("This build has no io_uring support; UDP relay uses epoll");
+    return false;
 }
 
-RoverRelayLogger::RoverRelayLogger(logging::Logger& logger, std::string directory)
-    : logger_(logger), directory_(std::move(directory)) {}
+void UdpRelay::close_uring() { uring_.reset(); }
+
+#endif
+
+RoverRelayLogger::RoverRelayLogger(logging::Logger& logger, std::string directory,
+                                   std::function<void()> on_thread_start)
+    : logger_(logger),
+      directory_(std::move(directory)),
+      on_thread_start_(std::move(on_thread_start)),
+      queue_(kPacketLogQueue),
+      dropped_total_(metrics::default_registry().counter("relay_packet_log_dropped",
+                                                         "Packets left out of the packet log on a full queue")) {
+    batch_.reserve(kPacketLogBatchBytes * 2);
+}
 
 RoverRelayLogger::~RoverRelayLogger() { stop(); }
 
 void RoverRelayLogger::start() {
-    if (active_) return;
-    active_ = true;
+    if (running_) return;
     open_file();
+    if (!file_) return;
+    running_ = true;
+    last_flush_ = std::chrono::steady_clock::now();
+    thread_ = std::thread(&RoverRelayLogger::run, this);
+    active_ = true;
 }
 
 void RoverRelayLogger::stop() {
-    if (!active_) return;
+    if (!running_) return;
     active_ = false;
+    running_ = false;
+    if (thread_.joinable()) thread_.join();
+    // Pick up anything pushed while the writer was shutting down.
+    while (drain()) write_batch(false);
+    write_batch(true);
     close_file();
 }
 
-void RoverRelayLogger::log_packet(const std::vector<std::uint8_t>& packet) {
-    if (!active_ || !file_) return;
-    file_ << timestamp_string() << "\tlen=" << packet.size() << '\t' << hex_dump(packet) << '\n';
-    ++lines_;
+// Relay loop. Copies the datagram and returns; never blocks.
+void RoverRelayLogger::log_packet(const std::uint8_t* data, std::size_t size) {
+    if (!active_) return;
+    const auto now = std::chrono::system_clock::now();
+    const bool pushed = queue_.try_emplace([&](PacketRecord& record) {
+        record.time = now;
+        record.size = size;
+        if (size <= PacketRecord::kInlineCapacity) {
+            std::memcpy(record.inline_bytes, data, size);
+            record.overflow.clear();
+        } else {
+            record.overflow.assign(data, data + size);
+        }
+    });
+    if (!pushed) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        dropped_total_.add();
+    }
 }
 
 bool RoverRelayLogger::active() const { return active_; }
 std::size_t RoverRelayLogger::lines_written() const { return lines_.load(); }
 
+void RoverRelayLogger::run() {
+    utils::set_current_thread_name("packet-log");
+    if (on_thread_start_) on_thread_start_();
+    while (running_) {
+        const bool got = drain();
+        const bool due = std::chrono::steady_clock::now() - last_flush_ >= kPacketLogFlushInterval;
+        if (batch_.size() >= kPacketLogBatchBytes || due) write_batch(due);
+        if (!got) std::this_thread::sleep_for(kPacketLogIdleSleep);
+    }
+}
+
+bool RoverRelayLogger::drain() {
+    bool any = false;
+    PacketRecord record;
+    while (batch_.size() < kPacketLogBatchBytes && queue_.try_pop(record)) {
+        append(record);
+        any = true;
+    }
+    queue_.publish_consumer_position();
+
+    const std::size_t dropped_now = dropped_.load(std::memory_order_relaxed);
+    if (dropped_now != reported_drops_) {
+        timestamp::append_local(batch_, std::chrono::system_clock::now());
+        batch_ += "\tdropped=" + std::to_string(dropped_now - reported_drops_) + " (queue full)\n";
+        reported_drops_ = dropped_now;
+    }
+    return any;
+}
+
+// "<timestamp>\tlen=N\t<hex bytes>\n"
+void RoverRelayLogger::append(const PacketRecord& record) {
+    timestamp::append_local(batch_, record.time);
+    batch_ += "\tlen=";
+    char len_text[24];
+    auto len_end = std::to_chars(len_text, len_text + sizeof(len_text), record.size).ptr;
+    batch_.append(len_text, len_end);
+    batch_ += '\t';
+    utils::append_hex_spaced(batch_, record.data(), record.size);
+    batch_ += '\n';
+    ++lines_;
+}
+
+void RoverRelayLogger::write_batch(bool force_flush) {
+    if (!batch_.empty()) {
+        file_.write(batch_.data(), static_cast<std::streamsize>(batch_.size()));
+        batch_.clear();
+    }
+    if (force_flush) {
+        file_.flush();
+        last_flush_ = std::chrono::steady_clock::now();
+    }
+}
+
 void RoverRelayLogger::open_file() {
     namespace fs = std::filesystem;
     fs::create_directories(directory_);
@@ -166,7 +798,6 @@ void RoverRelayLogger::open_file() {
     file_.open(path, std::ios::out | std::ios::app);
     if (!file_) {
         logger_.error("Failed to open rover relay log file");
-        active_ = false;
     } else {
         logger_.info(std::string("Logging rover relay to ") + path.string());
     }
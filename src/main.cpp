@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <atomic>
 #include <csignal>
 #include <chrono>
@@ -7,20 +8,36 @@
 #include <optional>
 #include <sstream>
 #include <thread>
+#include <vector>
 #include <stdexcept>
+
+#ifdef BRIDGE_WITH_GUI
 #include <QApplication>
+#include <QMetaObject>
+#include <QTimer>
+#endif
 
 #ifdef _WIN32
 #include <winsock2.h>
 #include <ws2tcpip.h>
 #endif
 
+#include "core/console_hud.hpp"
 #include "core/gimbal_control.hpp"
+#include "core/gimbal_echo.hpp"
 #include "core/image_stream_bridge.hpp"
-#include "ui/main_window.hpp"
 #include "core/udp_relay.hpp"
+#include "network/metrics_server.hpp"
+#include "network/reactor.hpp"
+#include "utils/async_log_writer.hpp"
+#include "utils/config_watcher.hpp"
 #include "utils/logger.hpp"
 #include "utils/settings.hpp"
+#include "utils/thread_tuning.hpp"
+
+#ifdef BRIDGE_WITH_GUI
+#include "ui/main_window.hpp"
+#endif
 
 namespace {
 
@@ -34,6 +51,7 @@ struct CliOptions {
     bool no_gui = false;
     std::optional<bool> console_hud;
     std::optional<double> hud_interval;
+    std::optional<std::vector<double>> hud_windows;
 
     std::optional<std::string> bridge_ip;
     std::optional<int> bridge_tcp;
@@ -50,6 +68,13 @@ struct CliOptions {
     std::optional<int> sensor_id;
     std::optional<std::string> control_method;
     std::optional<bool> show_packets;
+    std::optional<std::string> gimbal_packet_format;
+    std::optional<double> gimbal_rate_hz;
+    std::optional<double> gimbal_max_rate;
+    std::optional<double> gimbal_max_accel;
+    std::optional<bool> gimbal_measure_latency;
+    bool gimbal_echo = false;
+    int gimbal_echo_delay_ms = 0;
 
     std::optional<std::string> relay_bind_ip;
     std::optional<int> relay_bind_port;
@@ -58,8 +83,20 @@ struct CliOptions {
     std::optional<std::string> relay_proc_ip;
     std::optional<int> relay_proc_port;
     std::optional<bool> relay_log;
+    std::optional<int> relay_queue;
+    std::optional<std::string> relay_raw_drop;
+    std::optional<std::string> relay_proc_drop;
 
     std::optional<bool> rover_logging;
+
+    std::optional<bool> async_log;
+    std::optional<std::string> log_file;
+
+    std::optional<int> metrics_port;
+    std::optional<std::string> metrics_bind_ip;
+
+    std::optional<int> loop_threads;
+    std::optional<std::string> io_backend;
 };
 
 bool parse_cli(int argc, char** argv, CliOptions& out, std::string& error) {
@@ -81,6 +118,11 @@ bool parse_cli(int argc, char** argv, CliOptions& out, std::string& error) {
                 out.console_hud = false;
             } else if (arg == "--hud-interval") {
                 out.hud_interval = std::stod(require_value(arg));
+            } else if (arg == "--hud-windows") {
+                std::vector<double> windows;
+                std::stringstream list(require_value(arg));
+                for (std::string item; std::getline(list, item, ',');) windows.push_back(std::stod(item));
+                out.hud_windows = std::move(windows);
             } else if (arg == "--bridge-ip") {
                 out.bridge_ip = require_value(arg);
             } else if (arg == "--bridge-tcp") {
@@ -109,6 +151,22 @@ bool parse_cli(int argc, char** argv, CliOptions& out, std::string& error) {
                 out.control_method = require_value(arg);
             } else if (arg == "--show-gimbal-packets") {
                 out.show_packets = true;
+            } else if (arg == "--gimbal-packet-format") {
+                out.gimbal_packet_format = require_value(arg);
+            } else if (arg == "--gimbal-rate-hz") {
+                out.gimbal_rate_hz = std::stod(require_value(arg));
+            } else if (arg == "--gimbal-max-rate") {
+                out.gimbal_max_rate = std::stod(require_value(arg));
+            } else if (arg == "--gimbal-max-accel") {
+                out.gimbal_max_accel = std::stod(require_value(arg));
+            } else if (arg == "--gimbal-measure-latency") {
+                out.gimbal_measure_latency = true;
+            } else if (arg == "--no-gimbal-measure-latency") {
+                out.gimbal_measure_latency = false;
+            } else if (arg == "--gimbal-echo") {
+                out.gimbal_echo = true;
+            } else if (arg == "--gimbal-echo-delay-ms") {
+                out.gimbal_echo_delay_ms = std::stoi(require_value(arg));
             } else if (arg == "--relay-bind-ip") {
                 out.relay_bind_ip = require_value(arg);
             } else if (arg == "--relay-port") {
@@ -125,10 +183,41 @@ bool parse_cli(int argc, char** argv, CliOptions& out, std::string& error) {
                 out.relay_log = true;
             } else if (arg == "--no-relay-log") {
                 out.relay_log = false;
+            } else if (arg == "--relay-queue") {
+                out.relay_queue = std::stoi(require_value(arg));
+                if (*out.relay_queue < 0 || *out.relay_queue > settings::RelaySettings::kMaxQueue) {
+                    error = "Relay queue must be between 0 and " + std::to_string(settings::RelaySettings::kMaxQueue);
+                    return false;
+                }
+            } else if (arg == "--relay-raw-drop" || arg == "--relay-proc-drop") {
+                auto& policy = arg == "--relay-raw-drop" ? out.relay_raw_drop : out.relay_proc_drop;
+                policy = require_value(arg);
+                if (*policy != "drop_oldest" && *policy != "drop_newest") {
+                    error = "Invalid drop policy: " + *policy;
+                    return false;
+                }
             } else if (arg == "--enable-rover-logging") {
                 out.rover_logging = true;
             } else if (arg == "--disable-rover-logging") {
                 out.rover_logging = false;
+            } else if (arg == "--async-log") {
+                out.async_log = true;
+            } else if (arg == "--sync-log") {
+                out.async_log = false;
+            } else if (arg == "--log-file") {
+                out.log_file = require_value(arg);
+            } else if (arg == "--metrics-port") {
+                out.metrics_port = std::stoi(require_value(arg));
+            } else if (arg == "--metrics-bind-ip") {
+                out.metrics_bind_ip = require_value(arg);
+            } else if (arg == "--loop-threads") {
+                out.loop_threads = std::stoi(require_value(arg));
+            } else if (arg == "--io-backend") {
+                out.io_backend = require_value(arg);
+                if (*out.io_backend != "epoll" && *out.io_backend != "io_uring") {
+                    error = "Invalid io backend: " + *out.io_backend;
+                    return false;
+                }
             } else if (arg == "--help" || arg == "-h") {
                 return false;
             } else {
@@ -150,6 +239,7 @@ void print_usage() {
               << "  --console-hud           Enable console HUD\n"
               << "  --no-console-hud        Disable console HUD\n"
               << "  --hud-interval <sec>    HUD update interval\n"
+              << "  --hud-windows <s,s,..>  HUD sliding windows in seconds (default 1,10,60)\n"
               << "  --bridge-ip <ip>        Bridge bind IP\n"
               << "  --bridge-tcp <port>     Bridge TCP port\n"
               << "  --bridge-udp <port>     Bridge UDP port\n"
@@ -164,6 +254,14 @@ void print_usage() {
               << "  --sensor-id <int>       Sensor identifier\n"
               << "  --gimbal-control-method <tcp|mavlink>\n"
               << "  --show-gimbal-packets   Print raw packets\n"
+              << "  --gimbal-packet-format <pose|sensor>\n"
+              << "  --gimbal-rate-hz <hz>   Gimbal command send rate\n"
+              << "  --gimbal-max-rate <deg/s> Gimbal slew rate limit\n"
+              << "  --gimbal-max-accel <deg/s^2> Gimbal acceleration limit\n"
+              << "  --gimbal-measure-latency Tag gimbal commands and measure round-trip latency\n"
+              << "  --no-gimbal-measure-latency\n"
+              << "  --gimbal-echo           Run a local generator echo stand-in\n"
+              << "  --gimbal-echo-delay-ms <ms> Artificial delay for the echo stand-in\n"
               << "  --relay-bind-ip <ip>    Relay bind IP\n"
               << "  --relay-port <port>     Relay bind port\n"
               << "  --relay-raw-ip <ip>     Relay RAW target IP\n"
@@ -172,14 +270,25 @@ void print_usage() {
               << "  --relay-proc-port <port> Relay PROC target port\n"
               << "  --relay-log             Enable Gazebo packet logging\n"
               << "  --no-relay-log          Disable Gazebo packet logging\n"
+              << "  --relay-queue <n>       Datagrams held per relay destination while it is busy (0-65536, default 1024)\n"
+              << "  --relay-raw-drop <p>    RAW backlog overflow policy: drop_oldest | drop_newest\n"
+              << "  --relay-proc-drop <p>   PROC backlog overflow policy: drop_oldest | drop_newest\n"
               << "  --enable-rover-logging  Enable rover relay logging\n"
               << "  --disable-rover-logging Disable rover relay logging\n"
+              << "  --async-log             Write logs from a background thread\n"
+              << "  --sync-log              Write logs on the calling thread\n"
+              << "  --log-file <path>       Also write (rotated) logs to a file in async mode\n"
+              << "  --metrics-port <port>   Serve OpenMetrics on http://<bind>:<port>/metrics (0 disables)\n"
+              << "  --metrics-bind-ip <ip>  Metrics endpoint bind IP (default 127.0.0.1)\n"
+              << "  --loop-threads <n>      Event loop threads shared by relay, image and gimbal (default 1)\n"
+              << "  --io-backend <name>     UDP relay I/O path: epoll | io_uring (default epoll)\n"
               << std::endl;
 }
 
 void apply_cli(const CliOptions& cli, settings::AppConfig& cfg) {
     if (cli.console_hud) cfg.console_hud = *cli.console_hud;
     if (cli.hud_interval) cfg.hud_interval = *cli.hud_interval;
+    if (cli.hud_windows) cfg.hud_windows = *cli.hud_windows;
 
     if (cli.bridge_ip) cfg.bridge.ip = *cli.bridge_ip;
     if (cli.bridge_tcp) cfg.bridge.tcp_port = *cli.bridge_tcp;
@@ -196,6 +305,11 @@ void apply_cli(const CliOptions& cli, settings::AppConfig& cfg) {
     if (cli.sensor_id) cfg.gimbal.sensor_id = *cli.sensor_id;
     if (cli.control_method) cfg.gimbal.control_method = *cli.control_method;
     if (cli.show_packets) cfg.gimbal.show_packets = *cli.show_packets;
+    if (cli.gimbal_packet_format) cfg.gimbal.packet_format = *cli.gimbal_packet_format;
+    if (cli.gimbal_rate_hz) cfg.gimbal.send_rate_hz = *cli.gimbal_rate_hz;
+    if (cli.gimbal_max_rate) cfg.gimbal.max_rate_dps = *cli.gimbal_max_rate;
+    if (cli.gimbal_max_accel) cfg.gimbal.max_accel_dps2 = *cli.gimbal_max_accel;
+    if (cli.gimbal_measure_latency) cfg.gimbal.measure_latency = *cli.gimbal_measure_latency;
 
     if (cli.relay_bind_ip) cfg.relay.bind_ip = *cli.relay_bind_ip;
     if (cli.relay_bind_port) cfg.relay.bind_port = *cli.relay_bind_port;
@@ -204,8 +318,68 @@ void apply_cli(const CliOptions& cli, settings::AppConfig& cfg) {
     if (cli.relay_proc_ip) cfg.relay.proc_ip = *cli.relay_proc_ip;
     if (cli.relay_proc_port) cfg.relay.proc_port = *cli.relay_proc_port;
     if (cli.relay_log) cfg.relay.log_packets = *cli.relay_log;
+    if (cli.relay_queue) cfg.relay.raw_queue = cfg.relay.proc_queue = *cli.relay_queue;
+    if (cli.relay_raw_drop) cfg.relay.raw_drop_policy = *cli.relay_raw_drop;
+    if (cli.relay_proc_drop) cfg.relay.proc_drop_policy = *cli.relay_proc_drop;
 
     if (cli.rover_logging) cfg.rover.enable_logging = *cli.rover_logging;
+
+    if (cli.async_log) cfg.logging.async = *cli.async_log;
+    if (cli.log_file) cfg.logging.file_path = *cli.log_file;
+
+    if (cli.metrics_port) {
+        cfg.metrics.enable = *cli.metrics_port > 0;
+        if (cfg.metrics.enable) cfg.metrics.port = *cli.metrics_port;
+    }
+    if (cli.metrics_bind_ip) cfg.metrics.bind_ip = *cli.metrics_bind_ip;
+
+    if (cli.loop_threads) cfg.runtime.loop_threads = *cli.loop_threads;
+    if (cli.io_backend) cfg.runtime.io_backend = *cli.io_backend;
+}
+
+void tune_current_thread(const std::string& role, const settings::ThreadSettings& thread, logging::Logger& logger) {
+    std::string error;
+    if (!utils::apply_current_thread_policy(thread.cpus, thread.priority, error)) {
+        BRIDGE_LOG_WARNF(logger, "Thread settings for {} not applied: {}", role, error);
+    }
+}
+
+// Each reactor loop takes the settings of the modules placed on it (the
+// highest priority wins when they share one). A loop carrying a single
+// module is renamed after it so top -H and perf show "relay", "gimbal", ...
+void tune_reactor_loops(network::Reactor& reactor, const settings::RuntimeSettings& runtime,
+                        const core::ImageStreamBridge& image_bridge, const core::GimbalControl& gimbal,
+                        const core::UdpRelay& relay, logging::Logger& logger) {
+    struct Placement {
+        std::vector<std::string> modules;
+        settings::ThreadSettings thread;
+    };
+    std::vector<Placement> loops(reactor.loop_count());
+    auto place = [&](std::size_t loop, const char* name, const settings::ThreadSettings& thread) {
+        Placement& placement = loops[loop];
+        if (!thread.cpus.empty()) {
+            if (placement.thread.cpus.empty()) {
+                placement.thread.cpus = thread.cpus;
+            } else if (placement.thread.cpus != thread.cpus) {
+                BRIDGE_LOG_WARNF(logger, "{} shares event loop {} with {}; keeping cpus {}", name, loop,
+                                 placement.modules.front(), placement.thread.cpus);
+            }
+        }
+        placement.thread.priority = std::max(placement.thread.priority, thread.priority);
+        placement.modules.emplace_back(name);
+    };
+    place(image_bridge.loop(), "image", runtime.image);
+    place(gimbal.loop(), "gimbal", runtime.gimbal);
+    place(relay.loop(), "relay", runtime.relay);
+
+    for (std::size_t loop = 0; loop < loops.size(); ++loop) {
+        const Placement& placement = loops[loop];
+        if (placement.modules.empty()) continue;
+        reactor.run_sync(loop, [&] {
+            if (placement.modules.size() == 1) utils::set_current_thread_name(placement.modules.front());
+            tune_current_thread("event loop " + std::to_string(loop), placement.thread, logger);
+        });
+    }
 }
 
 }  // namespace
@@ -243,10 +417,14 @@ int main(int argc, char** argv) {
     settings::set_program_directory(program_dir.string());
 
     logging::Logger logger("UnifiedBridge");
-    if (!settings::has_display()) {
+#ifdef BRIDGE_WITH_GUI
+    if (!cli.no_gui && !settings::has_display()) {
         logger.warn("DISPLAY not detected. Running in headless mode.");
         cli.no_gui = true;
     }
+#else
+    cli.no_gui = true;  // unified_bridge_headless is built without Qt
+#endif
 
     settings::ConfigManager config_manager(program_dir.string());
     auto config = config_manager.load();
@@ -259,6 +437,25 @@ int main(int argc, char** argv) {
 
     config_manager.save(config);
 
+    // Threads inherit affinity and scheduling from their creator, so the main
+    // thread takes the service settings before anything else is started.
+    if (config.runtime.mlockall) {
+        std::string lock_error;
+        if (!utils::lock_process_memory(lock_error)) BRIDGE_LOG_WARNF(logger, "mlockall failed: {}", lock_error);
+    }
+    tune_current_thread("service", config.runtime.service, logger);
+
+    if (config.logging.async) {
+        logging::AsyncOptions log_options;
+        log_options.queue_capacity = static_cast<std::size_t>(std::max(config.logging.queue_capacity, 64));
+        log_options.flush_interval = std::chrono::milliseconds(std::max(config.logging.flush_interval_ms, 1));
+        log_options.file_path = config.logging.file_path;
+        log_options.max_file_bytes = static_cast<std::size_t>(std::max(config.logging.max_file_mb, 1)) * 1024 * 1024;
+        log_options.max_files = std::max(config.logging.max_files, 1);
+        log_options.on_thread_start = [&] { tune_current_thread("logging", config.runtime.logging, logger); };
+        logger.start_async(log_options);
+    }
+
     std::unique_ptr<core::RoverRelayLogger> packet_logger;
     if (config.relay.log_packets || config.rover.enable_logging) {
         std::filesystem::path base = config.rover.log_directory.empty()
@@ -269,13 +466,29 @@ int main(int argc, char** argv) {
         } else {
             base /= "rover";
         }
-        packet_logger = std::make_unique<core::RoverRelayLogger>(logger, base.string());
+        packet_logger = std::make_unique<core::RoverRelayLogger>(
+            logger, base.string(), [&] { tune_current_thread("logging", config.runtime.logging, logger); });
         packet_logger->start();
     }
 
-    core::ImageStreamBridge image_bridge(config.bridge, logger);
-    core::GimbalControl gimbal(config.gimbal, logger);
-    core::UdpRelay relay(config.relay, logger, packet_logger.get());
+    // Declared before the modules so it outlives them; their sockets and
+    // timers all run on its loops.
+    network::Reactor reactor(static_cast<std::size_t>(std::max(config.runtime.loop_threads, 1)),
+                             network::parse_io_backend(config.runtime.io_backend));
+    reactor.start();
+
+    core::ImageStreamBridge image_bridge(config.bridge, reactor, logger);
+    core::GimbalControl gimbal(config.gimbal, reactor, logger);
+    core::UdpRelay relay(config.relay, reactor, logger, packet_logger.get());
+    tune_reactor_loops(reactor, config.runtime, image_bridge, gimbal, relay, logger);
+    image_bridge.set_pose_source(&gimbal.pose_history());
+
+    std::unique_ptr<core::GimbalEcho> gimbal_echo;
+    if (cli.gimbal_echo) {
+        gimbal_echo = std::make_unique<core::GimbalEcho>(config.gimbal.generator_ip, config.gimbal.generator_port,
+                                                         cli.gimbal_echo_delay_ms, logger);
+        gimbal_echo->start();
+    }
 
     if (config.bridge.show_hud || config.console_hud) {
         logger.info("Console HUD enabled");
@@ -285,77 +498,98 @@ int main(int argc, char** argv) {
     gimbal.start();
     relay.start();
 
+    std::unique_ptr<network::MetricsServer> metrics_server;
+    if (config.metrics.enable) {
+        metrics_server = std::make_unique<network::MetricsServer>(config.metrics.bind_ip, config.metrics.port,
+                                                                  metrics::default_registry(), logger);
+        metrics_server->start();
+    }
+
     std::signal(SIGINT, signal_handler);
     std::signal(SIGTERM, signal_handler);
 
-    std::atomic<bool> hud_running{false};
-    std::thread hud_thread;
+    std::unique_ptr<core::ConsoleHud> hud;
     if (config.console_hud) {
-        hud_running = true;
-        hud_thread = std::thread([&]() {
-            while (!g_should_exit && hud_running.load()) {
-                auto img = image_bridge.status();
-                auto gib = gimbal.status();
-                auto rel = relay.status();
-
-                auto now = std::chrono::system_clock::now();
-                double age_ms = 0.0;
-                if (img.last_frame_time.time_since_epoch().count() > 0) {
-                    age_ms = std::chrono::duration_cast<std::chrono::milliseconds>(now - img.last_frame_time).count();
-                } else {
-                    age_ms = -1.0;
-                }
-
-                std::ostringstream oss;
-                oss << "HUD | UDP:" << (img.udp_running ? "on" : "off")
-                    << " TCP:" << (img.tcp_running ? "on" : "off")
-                    << " Clients:" << img.clients
-                    << " LastFrame:" << img.last_frame_bytes << "B";
-                if (age_ms >= 0) {
-                    oss << " (" << static_cast<int>(age_ms) << "ms ago)";
-                } else {
-                    oss << " (n/a)";
-                }
-                oss << " | Gimbal yaw:" << gib.yaw << " pitch:" << gib.pitch
-                    << " roll:" << gib.roll << " zoom:" << gib.zoom
-                    << " | Relay packets:" << rel.forwarded_packets
-                    << " bytes:" << rel.forwarded_bytes;
-
-                std::cout << oss.str() << std::endl;
-                std::this_thread::sleep_for(std::chrono::milliseconds(static_cast<int>(config.hud_interval * 1000)));
-            }
-        });
+        core::HudOptions hud_options;
+        hud_options.interval_s = config.hud_interval;
+        hud_options.windows_s = config.hud_windows;
+        hud = std::make_unique<core::ConsoleHud>(hud_options, metrics::default_registry(), image_bridge, gimbal, relay,
+                                                 std::cout);
+        hud->start();
     }
 
     int exit_code = 0;
     if (cli.no_gui) {
+        // Edits to config.json are applied to the running modules; relay
+        // packet logging and the logging section still need a restart.
+        settings::ConfigWatcher config_watcher(
+            config_manager.config_path(),
+            [&] {
+                auto loaded = config_manager.try_load();
+                if (!loaded) {
+                    logger.warn("Config file changed but could not be parsed; keeping current settings");
+                    return;
+                }
+                bool changed = image_bridge.apply_settings(loaded->bridge);
+                changed = gimbal.apply_settings(loaded->gimbal) || changed;
+                changed = relay.apply_settings(loaded->relay) || changed;
+                if (changed) logger.info("Configuration reloaded");
+            },
+            logger);
+        config_watcher.start();
         logger.info("Unified Bridge running. Press Ctrl+C to exit.");
         while (!g_should_exit) {
             std::this_thread::sleep_for(std::chrono::milliseconds(200));
+            logging::report_suppressed();
         }
-    } else {
+        config_watcher.stop();
+    }
+#ifdef BRIDGE_WITH_GUI
+    else {
         QApplication app(argc, argv);
         ui::MainWindow window(config_manager, config, image_bridge, gimbal, relay);
         window.show();
+        // The watcher thread only posts; the reload runs on the GUI thread so
+        // it cannot race the settings dialogs. Declared after `window`, so it
+        // is stopped before the window goes away.
+        settings::ConfigWatcher config_watcher(
+            config_manager.config_path(),
+            [&window] { QMetaObject::invokeMethod(&window, &ui::MainWindow::reload_config, Qt::QueuedConnection); },
+            logger);
+        config_watcher.start();
+        QTimer suppressed_timer;
+        QObject::connect(&suppressed_timer, &QTimer::timeout, [] { logging::report_suppressed(); });
+        suppressed_timer.start(1000);
         logger.info("Unified Bridge GUI initialized. Close the window to exit.");
         exit_code = app.exec();
         g_should_exit = true;
     }
+#endif
 
-    hud_running = false;
-    if (hud_thread.joinable()) hud_thread.join();
+    if (hud) {
+        hud->stop();
+    }
 
+    if (metrics_server) {
+        metrics_server->stop();
+    }
     relay.stop();
     gimbal.stop();
+    if (gimbal_echo) {
+        gimbal_echo->stop();
+    }
     image_bridge.stop();
+    reactor.stop();
 
     if (packet_logger) {
         packet_logger->stop();
     }
+    logging::report_suppressed();
 
 #ifdef _WIN32
     WSACleanup();
 #endif
     logger.info("Shutdown complete");
+    logger.stop_async();
     return exit_code;
 }
@@ -0,0 +1,159 @@
+#include "network/io_uring.hpp"
+
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+namespace network {
+
+namespace {
+
+std::runtime_error sys_error(const char* what) {
+    return std::runtime_error(std::string(what) + " failed: " + std::strerror(errno));
+}
+
+}  // namespace
+
+IoUring::IoUring(unsigned entries) {
+    io_uring_params params{};
+    fd_ = static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params));
+    if (fd_ < 0) throw sys_error("io_uring_setup");
+
+    sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    const bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (single_mmap) sq_ring_size_ = cq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+
+    sq_ring_ = ::mmap(nullptr, sq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_,
+                      IORING_OFF_SQ_RING);
+    if (sq_ring_ == MAP_FAILED) {
+        sq_ring_ = nullptr;
+        auto error = sys_error("io_uring SQ mmap");
+        ::close(fd_);
+        throw error;
+    }
+    if (single_mmap) {
+        cq_ring_ = sq_ring_;
+    } else {
+        cq_ring_ = ::mmap(nullptr, cq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_,
+                          IORING_OFF_CQ_RING);
+        if (cq_ring_ == MAP_FAILED) {
+            cq_ring_ = nullptr;
+            auto error = sys_error("io_uring CQ mmap");
+            ::munmap(sq_ring_, sq_ring_size_);
+            ::close(fd_);
+            throw error;
+        }
+    }
+    sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+    void* sqes = ::mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_SQES);
+    if (sqes == MAP_FAILED) {
+        auto error = sys_error("io_uring SQE mmap");
+        if (cq_ring_ != sq_ring_) ::munmap(cq_ring_, cq_ring_size_);
+        ::munmap(sq_ring_, sq_ring_size_);
+        ::close(fd_);
+        throw error;
+    }
+    sqes_ = static_cast<io_uring_sqe*>(sqes);
+
+    auto* sq = static_cast<char*>(sq_ring_);
+    sq_head_ = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+    sq_tail_ = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+    sq_mask_ = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+    sq_array_ = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+    sq_entries_ = params.sq_entries;
+    sqe_tail_ = *sq_tail_;
+
+    auto* cq = static_cast<char*>(cq_ring_);
+    cq_head_ = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+    cq_tail_ = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+    cq_mask_ = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+    cqes_ = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+}
+
+IoUring::~IoUring() {
+    ::munmap(sqes_, sqes_size_);
+    if (cq_ring_ != sq_ring_) ::munmap(cq_ring_, cq_ring_size_);
+    ::munmap(sq_ring_, sq_ring_size_);
+    ::close(fd_);
+}
+
+io_uring_sqe* IoUring::get_sqe() {
+    const unsigned head = __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE);
+    if (sqe_tail_ - head >= sq_entries_) return nullptr;
+    const unsigned index = sqe_tail_ & *sq_mask_;
+    io_uring_sqe* sqe = &sqes_[index];
+    std::memset(sqe, 0, sizeof(*sqe));
+    sq_array_[index] = index;
+    ++sqe_tail_;
+    return sqe;
+}
+
+int IoUring::submit() { return submit_and_wait(0); }
+
+int IoUring::submit_and_wait(unsigned min_complete) {
+    const unsigned pending = sqe_tail_ - *sq_tail_;
+    __atomic_store_n(sq_tail_, sqe_tail_, __ATOMIC_RELEASE);
+    if (pending == 0 && min_complete == 0) return 0;
+    return enter(pending, min_complete, min_complete > 0 ? IORING_ENTER_GETEVENTS : 0);
+}
+
+int IoUring::enter(unsigned to_submit, unsigned min_complete, unsigned flags) {
+    while (true) {
+        long result = ::syscall(__NR_io_uring_enter, fd_, to_submit, min_complete, flags, nullptr, 0);
+        if (result >= 0) return static_cast<int>(result);
+        if (errno != EINTR) return -errno;
+    }
+}
+
+BufferRing::BufferRing(IoUring& ring, std::uint16_t group, unsigned count, std::size_t buffer_size)
+    : ring_(ring), group_(group), count_(count), buffer_size_(buffer_size), storage_(count * buffer_size) {
+    // The ring itself must be page aligned; anonymous mmap guarantees that.
+    buf_ring_size_ = count * sizeof(io_uring_buf);
+    void* mem = ::mmap(nullptr, buf_ring_size_, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE, -1, 0);
+    if (mem == MAP_FAILED) throw sys_error("buffer ring mmap");
+    bufs_ = static_cast<io_uring_buf*>(mem);
+
+    io_uring_buf_reg reg{};
+    reg.ring_addr = reinterpret_cast<std::uint64_t>(bufs_);
+    reg.ring_entries = count;
+    reg.bgid = group;
+    if (::syscall(__NR_io_uring_register, ring_.fd(), IORING_REGISTER_PBUF_RING, &reg, 1) < 0) {
+        auto error = sys_error("IORING_REGISTER_PBUF_RING");
+        ::munmap(bufs_, buf_ring_size_);
+        throw error;
+    }
+    for (unsigned id = 0; id < count; ++id) add(static_cast<std::uint16_t>(id));
+    publish();
+}
+
+BufferRing::~BufferRing() {
+    io_uring_buf_reg reg{};
+    reg.bgid = group_;
+    ::syscall(__NR_io_uring_register, ring_.fd(), IORING_UNREGISTER_PBUF_RING, &reg, 1);
+    ::munmap(bufs_, buf_ring_size_);
+}
+
+void BufferRing::add(std::uint16_t id) {
+    io_uring_buf& buf = bufs_[tail_ & (count_ - 1)];
+    buf.addr = reinterpret_cast<std::uint64_t>(data(id));
+    buf.len = static_cast<std::uint32_t>(buffer_size_);
+    buf.bid = id;
+    ++tail_;
+}
+
+void BufferRing::recycle(std::uint16_t id) {
+    add(id);
+    publish();
+}
+
+// The shared tail overlays the reserved field of the first entry.
+void BufferRing::publish() { __atomic_store_n(&bufs_[0].resv, tail_, __ATOMIC_RELEASE); }
+
+}  // namespace network
@@ -0,0 +1,139 @@
+#include "network/metrics_server.hpp"
+
+#ifdef _WIN32
+#include <BaseTsd.h>
+#include <winsock2.h>
+#include <ws2tcpip.h>
+using ssize_t = SSIZE_T;
+#else
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#include <string_view>
+
+#include "network/socket_utils.hpp"
+#include "utils/openmetrics.hpp"
+#include "utils/thread_tuning.hpp"
+
+namespace network {
+
+namespace {
+
+constexpr std::size_t kMaxRequestBytes = 8 * 1024;
+constexpr int kClientTimeoutMs = 1000;
+
+bool send_all(int fd, const std::string& data) {
+    std::size_t offset = 0;
+    while (offset < data.size()) {
+        ssize_t sent = send(fd, data.data() + offset, static_cast<int>(data.size() - offset), kStreamSendFlags);
+        if (sent <= 0) return false;
+        offset += static_cast<std::size_t>(sent);
+    }
+    return true;
+}
+
+}  // namespace
+
+MetricsServer::MetricsServer(std::string bind_ip, int port, metrics::Registry& registry, logging::Logger& logger)
+    : bind_ip_(std::move(bind_ip)), port_(port), registry_(registry), logger_(logger) {}
+
+MetricsServer::~MetricsServer() { stop(); }
+
+bool MetricsServer::start() {
+    if (running_) return true;
+    int sock = create_tcp_socket();
+    int opt = 1;
+#ifdef _WIN32
+    setsockopt(sock, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&opt), sizeof(opt));
+#else
+    setsockopt(sock, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
+#endif
+    sockaddr_in addr = make_address(bind_ip_, static_cast<std::uint16_t>(port_));
+    if (bind(sock, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 || listen(sock, 8) < 0) {
+        BRIDGE_LOG_ERRORF(logger_, "Failed to bind metrics endpoint on {}: {}",
+                          describe_endpoint(bind_ip_, static_cast<std::uint16_t>(port_)), last_socket_error());
+        close_socket(sock);
+        return false;
+    }
+    socket_ = sock;
+    running_ = true;
+    thread_ = std::thread(&MetricsServer::serve, this);
+    BRIDGE_LOG_INFOF(logger_, "Serving metrics on http://{}/metrics", describe_endpoint(bind_ip_, static_cast<std::uint16_t>(port_)));
+    return true;
+}
+
+void MetricsServer::stop() {
+    if (!running_) return;
+    running_ = false;
+    int sock = socket_.exchange(-1);
+    shutdown_socket(sock);
+    if (thread_.joinable()) thread_.join();
+    close_socket(sock);
+}
+
+void MetricsServer::serve() {
+    utils::set_current_thread_name("metrics-http");
+    const int sock = socket_;
+    while (running_) {
+        sockaddr_in cli{};
+        socklen_t len = sizeof(cli);
+        int client_fd = accept(sock, reinterpret_cast<sockaddr*>(&cli), &len);
+        if (client_fd < 0) {
+            if (!running_) break;
+            continue;
+        }
+        handle_client(client_fd);
+        close_socket(client_fd);
+    }
+}
+
+void MetricsServer::handle_client(int client_fd) {
+    set_receive_timeout(client_fd, kClientTimeoutMs);
+    char request[kMaxRequestBytes];
+    std::size_t used = 0;
+    // Only the request line matters; read until the header block ends.
+    while (used < sizeof(request)) {
+        ssize_t received = recv(client_fd, request + used, static_cast<int>(sizeof(request) - used), 0);
+        if (received <= 0) break;
+        used += static_cast<std::size_t>(received);
+        if (std::string_view(request, used).find("\r\n\r\n") != std::string_view::npos) break;
+    }
+    std::string_view text(request, used);
+    std::string_view line = text.substr(0, text.find("\r\n"));
+
+    std::string_view status = "404 Not Found";
+    std::string_view content_type = "text/plain; charset=utf-8";
+    body_.clear();
+    if (line.substr(0, 4) != "GET " && line.substr(0, 5) != "HEAD ") {
+        status = "405 Method Not Allowed";
+        body_ = "only GET is supported\n";
+    } else {
+        std::string_view target = line.substr(line.find(' ') + 1);
+        target = target.substr(0, target.find(' '));
+        target = target.substr(0, target.find('?'));
+        if (target == "/metrics") {
+            status = "200 OK";
+            content_type = metrics::kOpenMetricsContentType;
+            metrics::render_openmetrics(registry_.snapshot(), body_);
+        } else {
+            body_ = "try /metrics\n";
+        }
+    }
+
+    response_.clear();
+    response_ += "HTTP/1.1 ";
+    response_ += status;
+    response_ += "\r\nContent-Type: ";
+    response_ += content_type;
+    response_ += "\r\nContent-Length: ";
+    response_ += std::to_string(body_.size());
+    response_ += "\r\nConnection: close\r\n\r\n";
+    if (line.substr(0, 5) != "HEAD ") response_ += body_;
+    if (!send_all(client_fd, response_)) {
+        BRIDGE_LOG_WARNF_LIMITED(logger_, "Metrics response send failed: {}", last_socket_error());
+    }
+}
+
+}  // namespace network
@@ -0,0 +1,446 @@
+#include "network/reactor.hpp"
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#elif defined(__linux__)
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+#else
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#endif
+
+#include <cerrno>
+#include <condition_variable>
+#include <future>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+#include "network/socket_utils.hpp"
+#include "utils/thread_tuning.hpp"
+
+namespace network {
+
+namespace {
+
+constexpr std::uint64_t kWakeId = 0;
+constexpr unsigned kLoopBits = 8;  // loop index lives in the low bits of an id
+constexpr std::size_t kMaxLoops = std::size_t{1} << kLoopBits;
+constexpr int kMaxEvents = 64;
+
+}  // namespace
+
+EventHandle& EventHandle::operator=(EventHandle&& other) noexcept {
+    if (this != &other) {
+        reset();
+        reactor_ = other.reactor_;
+        id_ = other.id_;
+        other.reactor_ = nullptr;
+    }
+    return *this;
+}
+
+void EventHandle::reset() {
+    if (reactor_) {
+        Reactor* reactor = reactor_;
+        reactor_ = nullptr;
+        reactor->remove(id_);
+    }
+}
+
+struct Reactor::Entry {
+    int fd = -1;
+    bool timer = false;
+    std::uint32_t events = 0;
+    IoCallback io;
+    Task tick;
+#ifndef __linux__
+    std::chrono::steady_clock::duration period{};
+    std::chrono::steady_clock::time_point due{};
+#endif
+};
+
+struct Reactor::Loop {
+    std::size_t index = 0;
+    int poll_fd = -1;  // epoll instance (Linux only)
+    int wake_fd = -1;  // eventfd, or a self-connected UDP socket elsewhere
+    std::thread thread;
+    std::atomic<std::thread::id> thread_id{};
+
+    // Held while starting/stopping and by run_sync() while deciding whether
+    // to run inline, so a task is never queued to a loop that is gone.
+    // Stopping lasts until the thread is joined: callbacks and the final
+    // run_tasks() may still be running, so run_sync() keeps queueing.
+    enum class State { Stopped, Running, Stopping };
+    std::recursive_mutex state_mutex;
+    State state = State::Stopped;
+
+    std::mutex task_mutex;
+    std::vector<Task> tasks;
+
+    // Touched only by the loop thread, or by whoever holds state_mutex once
+    // the loop thread has been joined.
+    std::unordered_map<std::uint64_t, std::shared_ptr<Entry>> entries;
+};
+
+IoBackend parse_io_backend(const std::string& name) {
+    return name == "io_uring" ? IoBackend::IoUring : IoBackend::Epoll;
+}
+
+const char* io_backend_name(IoBackend backend) { return backend == IoBackend::IoUring ? "io_uring" : "epoll"; }
+
+Reactor::Reactor(std::size_t loop_threads, IoBackend io_backend) : io_backend_(io_backend) {
+    if (loop_threads == 0) loop_threads = 1;
+    if (loop_threads > kMaxLoops) loop_threads = kMaxLoops;
+    for (std::size_t i = 0; i < loop_threads; ++i) {
+        auto loop = std::make_unique<Loop>();
+        loop->index = i;
+#ifdef __linux__
+        loop->poll_fd = ::epoll_create1(EPOLL_CLOEXEC);
+        loop->wake_fd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (loop->poll_fd < 0 || loop->wake_fd < 0) {
+            throw std::runtime_error("Failed to create epoll/eventfd for reactor");
+        }
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.u64 = kWakeId;
+        ::epoll_ctl(loop->poll_fd, EPOLL_CTL_ADD, loop->wake_fd, &ev);
+#else
+        // A UDP socket connected to itself: send() wakes poll(), recv() drains.
+        int fd = create_udp_socket();
+        sockaddr_in addr = make_address("127.0.0.1", 0);
+        socklen_t len = sizeof(addr);
+        if (::bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 ||
+            ::getsockname(fd, reinterpret_cast<sockaddr*>(&addr), &len) < 0 ||
+            ::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+            close_socket(fd);
+            throw std::runtime_error("Failed to create reactor wake socket");
+        }
+        set_nonblocking(fd);
+        loop->wake_fd = fd;
+#endif
+        loops_.push_back(std::move(loop));
+    }
+}
+
+Reactor::~Reactor() {
+    stop();
+    for (auto& loop : loops_) {
+        for (auto& [id, entry] : loop->entries) {
+#ifdef __linux__
+            if (entry->timer) ::close(entry->fd);
+#endif
+        }
+#ifdef __linux__
+        ::close(loop->wake_fd);
+        ::close(loop->poll_fd);
+#else
+        close_socket(loop->wake_fd);
+#endif
+    }
+}
+
+void Reactor::start() {
+    for (auto& loop : loops_) {
+        std::lock_guard<std::recursive_mutex> lock(loop->state_mutex);
+        if (loop->state != Loop::State::Stopped) continue;
+        loop->state = Loop::State::Running;
+        Loop* raw = loop.get();
+        loop->thread = std::thread([this, raw] { run_loop(*raw); });
+    }
+}
+
+void Reactor::stop() {
+    for (auto& loop : loops_) {
+        {
+            std::lock_guard<std::recursive_mutex> lock(loop->state_mutex);
+            if (loop->state != Loop::State::Running) continue;
+            loop->state = Loop::State::Stopping;
+        }
+        wake(*loop);
+        if (loop->thread.joinable()) loop->thread.join();
+        std::lock_guard<std::recursive_mutex> lock(loop->state_mutex);
+        loop->state = Loop::State::Stopped;
+        // Tasks queued after the loop's final run_tasks(); their callers
+        // are still waiting.
+        run_tasks(*loop);
+    }
+}
+
+std::size_t Reactor::next_loop() {
+    return next_loop_.fetch_add(1, std::memory_order_relaxed) % loops_.size();
+}
+
+bool Reactor::in_loop(std::size_t loop) const {
+    return loops_[loop]->thread_id.load(std::memory_order_acquire) == std::this_thread::get_id();
+}
+
+Reactor::Loop& Reactor::loop_of(std::uint64_t id) const { return *loops_[id & (kMaxLoops - 1)]; }
+
+EventHandle Reactor::add_socket(std::size_t loop, int fd, std::uint32_t events, IoCallback callback) {
+    const std::uint64_t id = (next_id_.fetch_add(1, std::memory_order_relaxed) << kLoopBits) | loop;
+    auto entry = std::make_shared<Entry>();
+    entry->fd = fd;
+    entry->events = events;
+    entry->io = std::move(callback);
+    Loop& target = *loops_[loop];
+    run_sync(loop, [&] {
+#ifdef __linux__
+        epoll_event ev{};
+        ev.events = ((events & kReadable) ? EPOLLIN : 0u) | ((events & kWritable) ? EPOLLOUT : 0u);
+        ev.data.u64 = id;
+        if (::epoll_ctl(target.poll_fd, EPOLL_CTL_ADD, fd, &ev) < 0) {
+            throw std::runtime_error("epoll_ctl(ADD) failed");
+        }
+#endif
+        target.entries.emplace(id, entry);
+    });
+    return EventHandle(this, id);
+}
+
+void Reactor::set_events(const EventHandle& handle, std::uint32_t events) {
+    if (!handle.active()) return;
+    const std::uint64_t id = handle.id();
+    Loop& target = loop_of(id);
+    run_sync(target.index, [&] {
+        auto it = target.entries.find(id);
+        if (it == target.entries.end() || it->second->events == events) return;
+        it->second->events = events;
+#ifdef __linux__
+        epoll_event ev{};
+        ev.events = ((events & kReadable) ? EPOLLIN : 0u) | ((events & kWritable) ? EPOLLOUT : 0u);
+        ev.data.u64 = id;
+        ::epoll_ctl(target.poll_fd, EPOLL_CTL_MOD, it->second->fd, &ev);
+#endif
+    });
+}
+
+EventHandle Reactor::add_timer(std::size_t loop, std::chrono::nanoseconds period, Task callback) {
+    if (period.count() <= 0) period = std::chrono::milliseconds(1);
+    const std::uint64_t id = (next_id_.fetch_add(1, std::memory_order_relaxed) << kLoopBits) | loop;
+    auto entry = std::make_shared<Entry>();
+    entry->timer = true;
+    entry->tick = std::move(callback);
+#ifdef __linux__
+    entry->fd = ::timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (entry->fd < 0) throw std::runtime_error("timerfd_create failed");
+    itimerspec spec{};
+    spec.it_interval.tv_sec = static_cast<time_t>(period.count() / 1'000'000'000);
+    spec.it_interval.tv_nsec = static_cast<long>(period.count() % 1'000'000'000);
+    spec.it_value = spec.it_interval;
+    ::timerfd_settime(entry->fd, 0, &spec, nullptr);
+#else
+    entry->period = std::chrono::duration_cast<std::chrono::steady_clock::duration>(period);
+    entry->due = std::chrono::steady_clock::now() + entry->period;
+#endif
+    Loop& target = *loops_[loop];
+    run_sync(loop, [&] {
+#ifdef __linux__
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.u64 = id;
+        ::epoll_ctl(target.poll_fd, EPOLL_CTL_ADD, entry->fd, &ev);
+#endif
+        target.entries.emplace(id, entry);
+    });
+    return EventHandle(this, id);
+}
+
+void Reactor::remove(std::uint64_t id) {
+    Loop& target = loop_of(id);
+    run_sync(target.index, [&] {
+        auto it = target.entries.find(id);
+        if (it == target.entries.end()) return;
+#ifdef __linux__
+        ::epoll_ctl(target.poll_fd, EPOLL_CTL_DEL, it->second->fd, nullptr);
+        if (it->second->timer) ::close(it->second->fd);
+#endif
+        target.entries.erase(it);
+    });
+}
+
+void Reactor::post(std::size_t loop, Task task) {
+    Loop& target = *loops_[loop];
+    {
+        std::lock_guard<std::mutex> lock(target.task_mutex);
+        target.tasks.push_back(std::move(task));
+    }
+    wake(target);
+}
+
+void Reactor::run_sync(std::size_t loop, const Task& task) {
+    Loop& target = *loops_[loop];
+    if (in_loop(loop)) {
+        task();
+        return;
+    }
+    std::future<void> done;
+    {
+        std::unique_lock<std::recursive_mutex> lock(target.state_mutex);
+        if (target.state == Loop::State::Stopped) {
+            task();
+            return;
+        }
+        auto promise = std::make_shared<std::promise<void>>();
+        done = promise->get_future();
+        std::lock_guard<std::mutex> task_lock(target.task_mutex);
+        target.tasks.push_back([&task, promise] {
+            try {
+                task();
+                promise->set_value();
+            } catch (...) {
+                promise->set_exception(std::current_exception());
+            }
+        });
+    }
+    wake(target);
+    done.get();
+}
+
+void Reactor::wake(Loop& loop) {
+#ifdef __linux__
+    std::uint64_t one = 1;
+    [[maybe_unused]] auto written = ::write(loop.wake_fd, &one, sizeof(one));
+#else
+    char byte = 0;
+    ::send(loop.wake_fd, &byte, 1, 0);
+#endif
+}
+
+void Reactor::run_tasks(Loop& loop) {
+    std::vector<Task> tasks;
+    {
+        std::lock_guard<std::mutex> lock(loop.task_mutex);
+        tasks.swap(loop.tasks);
+    }
+    for (auto& task : tasks) task();
+}
+
+void Reactor::run_loop(Loop& loop) {
+    utils::set_current_thread_name("bridge-loop" + std::to_string(loop.index));
+    loop.thread_id.store(std::this_thread::get_id(), std::memory_order_release);
+    auto is_running = [&] {
+        std::lock_guard<std::recursive_mutex> lock(loop.state_mutex);
+        return loop.state == Loop::State::Running;
+    };
+#ifdef __linux__
+    epoll_event events[kMaxEvents];
+    while (is_running()) {
+        int count = ::epoll_wait(loop.poll_fd, events, kMaxEvents, -1);
+        if (count < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        for (int i = 0; i < count; ++i) {
+            const std::uint64_t id = events[i].data.u64;
+            if (id == kWakeId) {
+                std::uint64_t value = 0;
+                [[maybe_unused]] auto drained = ::read(loop.wake_fd, &value, sizeof(value));
+                continue;
+            }
+            // Looked up per event: an earlier callback in this batch may
+            // have removed it.
+            auto it = loop.entries.find(id);
+            if (it == loop.entries.end()) continue;
+            std::shared_ptr<Entry> entry = it->second;
+            if (entry->timer) {
+                std::uint64_t expirations = 0;
+                if (::read(entry->fd, &expirations, sizeof(expirations)) > 0) entry->tick();
+                continue;
+            }
+            std::uint32_t mask = 0;
+            if (events[i].events & (EPOLLERR | EPOLLHUP)) mask = kReadable | kWritable;
+            if (events[i].events & EPOLLIN) mask |= kReadable;
+            if (events[i].events & EPOLLOUT) mask |= kWritable;
+            entry->io(mask);
+        }
+        run_tasks(loop);
+    }
+#else
+#ifdef _WIN32
+    using PollFd = WSAPOLLFD;
+#else
+    using PollFd = pollfd;
+#endif
+    using clock = std::chrono::steady_clock;
+    std::vector<PollFd> fds;
+    std::vector<std::uint64_t> ids;
+    while (is_running()) {
+        fds.clear();
+        ids.clear();
+        fds.push_back(PollFd{});
+        fds.back().fd = loop.wake_fd;
+        fds.back().events = POLLIN;
+        ids.push_back(kWakeId);
+        auto now = clock::now();
+        int timeout_ms = -1;
+        for (auto& [id, entry] : loop.entries) {
+            if (entry->timer) {
+                auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(entry->due - now).count();
+                int ms = wait <= 0 ? 0 : static_cast<int>(wait + 1);
+                if (timeout_ms < 0 || ms < timeout_ms) timeout_ms = ms;
+                continue;
+            }
+            PollFd pfd{};
+            pfd.fd = entry->fd;
+            pfd.events = static_cast<short>(((entry->events & kReadable) ? POLLIN : 0) |
+                                            ((entry->events & kWritable) ? POLLOUT : 0));
+            fds.push_back(pfd);
+            ids.push_back(id);
+        }
+#ifdef _WIN32
+        int count = ::WSAPoll(fds.data(), static_cast<ULONG>(fds.size()), timeout_ms);
+#else
+        int count = ::poll(fds.data(), static_cast<nfds_t>(fds.size()), timeout_ms);
+#endif
+        if (count < 0) {
+#ifndef _WIN32
+            if (errno == EINTR) continue;
+#endif
+            break;
+        }
+        for (std::size_t i = 0; count > 0 && i < fds.size(); ++i) {
+            if (fds[i].revents == 0) continue;
+            if (ids[i] == kWakeId) {
+                char drain[64];
+                while (::recv(loop.wake_fd, drain, sizeof(drain), 0) > 0) {
+                }
+                continue;
+            }
+            auto it = loop.entries.find(ids[i]);
+            if (it == loop.entries.end()) continue;
+            std::shared_ptr<Entry> entry = it->second;
+            std::uint32_t mask = 0;
+            if (fds[i].revents & (POLLERR | POLLHUP)) mask = kReadable | kWritable;
+            if (fds[i].revents & POLLIN) mask |= kReadable;
+            if (fds[i].revents & POLLOUT) mask |= kWritable;
+            entry->io(mask);
+        }
+        now = clock::now();
+        ids.clear();
+        for (auto& [id, entry] : loop.entries) {
+            if (entry->timer && entry->due <= now) ids.push_back(id);
+        }
+        for (std::uint64_t id : ids) {
+            // Skip timers removed by an earlier callback in this round.
+            auto it = loop.entries.find(id);
+            if (it == loop.entries.end()) continue;
+            std::shared_ptr<Entry> entry = it->second;
+            entry->due = now + entry->period;
+            entry->tick();
+        }
+        run_tasks(loop);
+    }
+#endif
+    run_tasks(loop);  // nobody waiting in run_sync() is left hanging
+    loop.thread_id.store(std::thread::id{}, std::memory_order_release);
+}
+
+}  // namespace network
@@ -5,11 +5,18 @@
 #include <ws2tcpip.h>
 #else
 #include <arpa/inet.h>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/time.h>
 #include <unistd.h>
 #endif
 
+#include <cerrno>
+#include <cstring>
+#include <ostream>
 #include <sstream>
 #include <stdexcept>
+#include <type_traits>
 
 namespace network {
 
@@ -39,6 +46,38 @@ void close_socket(int fd) {
     }
 }
 
+void shutdown_socket(int fd) {
+    if (fd >= 0) {
+#ifdef _WIN32
+        ::shutdown(fd, SD_BOTH);
+#else
+        ::shutdown(fd, SHUT_RDWR);
+#endif
+    }
+}
+
+bool set_receive_timeout(int fd, int timeout_ms) {
+#ifdef _WIN32
+    DWORD timeout = static_cast<DWORD>(timeout_ms);
+    return ::setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, reinterpret_cast<const char*>(&timeout), sizeof(timeout)) == 0;
+#else
+    timeval tv{};
+    tv.tv_sec = timeout_ms / 1000;
+    tv.tv_usec = (timeout_ms % 1000) * 1000;
+    return ::setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv)) == 0;
+#endif
+}
+
+bool set_nonblocking(int fd) {
+#ifdef _WIN32
+    u_long mode = 1;
+    return ::ioctlsocket(fd, FIONBIO, &mode) == 0;
+#else
+    int flags = ::fcntl(fd, F_GETFL, 0);
+    return flags >= 0 && ::fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+#endif
+}
+
 sockaddr_in make_address(const std::string& ip, std::uint16_t port) {
     sockaddr_in addr{};
     addr.sin_family = AF_INET;
@@ -55,4 +94,37 @@ std::string describe_endpoint(const std::string& ip, std::uint16_t port) {
     return oss.str();
 }
 
+SocketError last_socket_error() {
+#ifdef _WIN32
+    return SocketError{::WSAGetLastError()};
+#else
+    return SocketError{errno};
+#endif
+}
+
+bool would_block(const SocketError& error) {
+#ifdef _WIN32
+    return error.code == WSAEWOULDBLOCK;
+#else
+    return error.code == EAGAIN || error.code == EWOULDBLOCK;
+#endif
+}
+
+std::ostream& operator<<(std::ostream& os, const SocketError& error) {
+#ifdef _WIN32
+    return os << "WSA error " << error.code;
+#else
+    char buf[128];
+    // GNU strerror_r may return a static string instead of filling buf.
+    auto text = [&](auto result) -> const char* {
+        if constexpr (std::is_same_v<decltype(result), int>) {
+            return result == 0 ? buf : "unknown error";
+        } else {
+            return result;
+        }
+    };
+    return os << text(::strerror_r(error.code, buf, sizeof(buf))) << " (" << error.code << ')';
+#endif
+}
+
 }  // namespace network
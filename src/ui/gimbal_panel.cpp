@@ -0,0 +1,250 @@
+#include "ui/gimbal_panel.hpp"
+
+#include <cmath>
+
+#include <QFocusEvent>
+#include <QGridLayout>
+#include <QHBoxLayout>
+#include <QKeyEvent>
+#include <QLabel>
+#include <QPushButton>
+#include <QSignalBlocker>
+#include <QSlider>
+#include <QTimer>
+#include <QVBoxLayout>
+
+namespace ui {
+
+namespace {
+
+// Sliders work in hundredths of a degree (or of a zoom level), fine enough
+// that one jog step at the slowest rate still moves them.
+constexpr double kSliderScale = 100.0;
+constexpr int kJogIntervalMs = 20;
+constexpr int kSyncIntervalMs = 100;
+
+struct AxisSpec {
+    const char* name;
+    double min;
+    double max;
+    const char* unit;
+    double jog_rate;  // per second while a key is held; tripled with Shift
+};
+
+constexpr AxisSpec kAxes[] = {
+    {"Yaw", -180.0, 180.0, "°", 30.0},
+    {"Pitch", -90.0, 90.0, "°", 30.0},
+    {"Roll", -90.0, 90.0, "°", 30.0},
+    {"Zoom", 1.0, 20.0, "x", 1.0},
+};
+
+int to_slider(double value) { return static_cast<int>(std::lround(value * kSliderScale)); }
+
+double from_slider(int value) { return static_cast<double>(value) / kSliderScale; }
+
+}  // namespace
+
+GimbalPanel::GimbalPanel(core::GimbalControl& gimbal, QWidget* parent)
+    : QGroupBox(tr("짐벌 조종"), parent), gimbal_(gimbal) {
+    // The panel takes the keyboard; the sliders stay mouse-only so arrow
+    // keys always jog instead of nudging whichever slider has focus.
+    setFocusPolicy(Qt::StrongFocus);
+
+    auto* layout = new QVBoxLayout(this);
+    auto* grid = new QGridLayout();
+    for (int axis = 0; axis < kAxisCount; ++axis) {
+        const AxisSpec& spec = kAxes[axis];
+        auto* slider = new QSlider(Qt::Horizontal, this);
+        slider->setRange(to_slider(spec.min), to_slider(spec.max));
+        slider->setSingleStep(to_slider(1.0));
+        slider->setPageStep(to_slider(10.0));
+        slider->setFocusPolicy(Qt::NoFocus);
+        auto* value = new QLabel(this);
+        value->setMinimumWidth(64);
+        value->setAlignment(Qt::AlignRight | Qt::AlignVCenter);
+        connect(slider, &QSlider::valueChanged, this, &GimbalPanel::on_slider_changed);
+
+        grid->addWidget(new QLabel(QString::fromLatin1(spec.name), this), axis, 0);
+        grid->addWidget(slider, axis, 1);
+        grid->addWidget(value, axis, 2);
+        sliders_[axis] = slider;
+        values_[axis] = value;
+    }
+    grid->setColumnStretch(1, 1);
+    layout->addLayout(grid);
+
+    auto* buttons = new QHBoxLayout();
+    auto* center_button = new QPushButton(tr("중앙"), this);
+    auto* stop_button = new QPushButton(tr("정지"), this);
+    center_button->setFocusPolicy(Qt::NoFocus);
+    stop_button->setFocusPolicy(Qt::NoFocus);
+    connect(center_button, &QPushButton::clicked, this, &GimbalPanel::center);
+    connect(stop_button, &QPushButton::clicked, this, &GimbalPanel::stop_motion);
+    buttons->addWidget(center_button);
+    buttons->addWidget(stop_button);
+    layout->addLayout(buttons);
+
+    auto* hint = new QLabel(tr("패널을 클릭한 뒤 ←→ Yaw, ↑↓ Pitch, Q/E Roll, +/- 줌, Shift 가속, "
+                               "Space 정지, Home 중앙"),
+                            this);
+    hint->setWordWrap(true);
+    hint->setStyleSheet("color: #808080;");
+    layout->addWidget(hint);
+    layout->addStretch(1);
+
+    jog_timer_ = new QTimer(this);
+    jog_timer_->setInterval(kJogIntervalMs);
+    connect(jog_timer_, &QTimer::timeout, this, &GimbalPanel::jog);
+
+    seen_overrides_ = gimbal_.pose_overrides();
+    sync_timer_ = new QTimer(this);
+    sync_timer_->setInterval(kSyncIntervalMs);
+    connect(sync_timer_, &QTimer::timeout, this, &GimbalPanel::check_overrides);
+    sync_timer_->start();
+
+    sync_from_gimbal();
+}
+
+void GimbalPanel::sync_from_gimbal() {
+    const auto st = gimbal_.status();
+    set_sliders(core::GimbalPose{st.yaw, st.pitch, st.roll, st.zoom});
+}
+
+core::GimbalPose GimbalPanel::slider_pose() const {
+    return core::GimbalPose{from_slider(sliders_[Yaw]->value()), from_slider(sliders_[Pitch]->value()),
+                            from_slider(sliders_[Roll]->value()), from_slider(sliders_[Zoom]->value())};
+}
+
+void GimbalPanel::set_sliders(const core::GimbalPose& pose) {
+    const double values[kAxisCount] = {pose.yaw, pose.pitch, pose.roll, pose.zoom};
+    for (int axis = 0; axis < kAxisCount; ++axis) {
+        const QSignalBlocker blocker(sliders_[axis]);
+        sliders_[axis]->setValue(to_slider(values[axis]));
+    }
+    update_value_labels();
+}
+
+void GimbalPanel::update_value_labels() {
+    for (int axis = 0; axis < kAxisCount; ++axis) {
+        values_[axis]->setText(QString::number(from_slider(sliders_[axis]->value()), 'f', 1) +
+                               QString::fromUtf8(kAxes[axis].unit));
+    }
+}
+
+void GimbalPanel::steer_to_sliders() {
+    following_ = false;
+    gimbal_.steer(slider_pose());
+}
+
+void GimbalPanel::on_slider_changed() {
+    update_value_labels();
+    steer_to_sliders();
+}
+
+void GimbalPanel::center() {
+    set_sliders(core::GimbalPose{});
+    steer_to_sliders();
+}
+
+void GimbalPanel::stop_motion() {
+    jog_direction_.fill(0);
+    jog_timer_->stop();
+    gimbal_.hold();
+    sync_from_gimbal();
+}
+
+void GimbalPanel::jog() {
+    const auto now = std::chrono::steady_clock::now();
+    const double dt = std::chrono::duration<double>(now - last_jog_).count();
+    last_jog_ = now;
+
+    bool moved = false;
+    for (int axis = 0; axis < kAxisCount; ++axis) {
+        if (jog_direction_[axis] == 0) continue;
+        const double rate = kAxes[axis].jog_rate * (jog_fast_ ? 3.0 : 1.0);
+        QSlider* slider = sliders_[axis];
+        const QSignalBlocker blocker(slider);
+        const int before = slider->value();
+        slider->setValue(before + to_slider(jog_direction_[axis] * rate * dt));
+        moved = moved || slider->value() != before;
+    }
+    // One steer() for all jogged axes rather than one per slider.
+    if (moved) {
+        update_value_labels();
+        steer_to_sliders();
+    }
+}
+
+// Someone other than this panel moved the gimbal: follow the commanded pose
+// until the trajectory settles, unless the user takes over again.
+void GimbalPanel::check_overrides() {
+    const std::uint64_t overrides = gimbal_.pose_overrides();
+    if (overrides != seen_overrides_) {
+        seen_overrides_ = overrides;
+        following_ = true;
+    }
+    if (!following_ || jog_timer_->isActive()) return;
+    for (const QSlider* slider : sliders_) {
+        if (slider->isSliderDown()) return;
+    }
+    const auto st = gimbal_.status();
+    set_sliders(core::GimbalPose{st.yaw, st.pitch, st.roll, st.zoom});
+    if (!st.moving) following_ = false;
+}
+
+bool GimbalPanel::set_jog(QKeyEvent* event, bool pressed) {
+    const int direction = pressed ? 1 : 0;
+    switch (event->key()) {
+    case Qt::Key_Left: jog_direction_[Yaw] = -direction; break;
+    case Qt::Key_Right: jog_direction_[Yaw] = direction; break;
+    case Qt::Key_Down: jog_direction_[Pitch] = -direction; break;
+    case Qt::Key_Up: jog_direction_[Pitch] = direction; break;
+    case Qt::Key_Q: jog_direction_[Roll] = -direction; break;
+    case Qt::Key_E: jog_direction_[Roll] = direction; break;
+    case Qt::Key_Minus: jog_direction_[Zoom] = -direction; break;
+    case Qt::Key_Plus:
+    case Qt::Key_Equal: jog_direction_[Zoom] = direction; break;
+    default: return false;
+    }
+    jog_fast_ = (event->modifiers() & Qt::ShiftModifier) != 0;
+    return true;
+}
+
+void GimbalPanel::keyPressEvent(QKeyEvent* event) {
+    if (event->key() == Qt::Key_Space) {
+        stop_motion();
+        return;
+    }
+    if (event->key() == Qt::Key_Home) {
+        center();
+        return;
+    }
+    // Auto-repeat presses are harmless: jog() integrates held keys itself.
+    if (!set_jog(event, true)) {
+        QGroupBox::keyPressEvent(event);
+        return;
+    }
+    if (!jog_timer_->isActive()) {
+        last_jog_ = std::chrono::steady_clock::now();
+        jog_timer_->start();
+    }
+}
+
+void GimbalPanel::keyReleaseEvent(QKeyEvent* event) {
+    if (event->isAutoRepeat() || !set_jog(event, false)) {
+        QGroupBox::keyReleaseEvent(event);
+        return;
+    }
+    bool any = false;
+    for (int direction : jog_direction_) any = any || direction != 0;
+    if (!any) jog_timer_->stop();
+}
+
+void GimbalPanel::focusOutEvent(QFocusEvent* event) {
+    // A key released while another window had focus never reaches us.
+    jog_direction_.fill(0);
+    jog_timer_->stop();
+    QGroupBox::focusOutEvent(event);
+}
+
+}  // namespace ui
@@ -2,14 +2,20 @@
 #include <utility>
 
 #include <chrono>
+#include <cstdint>
+#include <limits>
 #include <QtGlobal>
 
 #include <QFormLayout>
+#include <QGridLayout>
 #include <QGroupBox>
 #include <QHBoxLayout>
 #include <QLabel>
+#include <QPixmap>
 #include <QPushButton>
+#include <QSizePolicy>
 #include <QStatusBar>
+#include <QThread>
 #include <QTimer>
 #include <QVBoxLayout>
 #include <QWidget>
@@ -18,6 +24,18 @@
 
 namespace ui {
 
+namespace {
+
+// Charts take one point per drain and keep the last three minutes.
+constexpr int kChartIntervalMs = 250;
+constexpr std::size_t kChartPoints = 180 * 1000 / kChartIntervalMs;
+
+double per_second(std::uint64_t count, std::int64_t interval_ns) {
+    return interval_ns > 0 ? static_cast<double>(count) * 1e9 / static_cast<double>(interval_ns) : 0.0;
+}
+
+}  // namespace
+
 MainWindow::MainWindow(settings::ConfigManager& config_manager,
                        settings::AppConfig config,
                        core::ImageStreamBridge& image_bridge,
@@ -39,18 +57,80 @@ MainWindow::MainWindow(settings::ConfigManager& config_manager,
     connect(status_timer_, &QTimer::timeout, this, &MainWindow::refresh_status);
     status_timer_->start();
 
+    feed_timer_ = new QTimer(this);
+    feed_timer_->setInterval(kChartIntervalMs);
+    connect(feed_timer_, &QTimer::timeout, this, &MainWindow::drain_status_feed);
+    feed_timer_->start();
+    image_bridge_.set_status_feed(&status_feed_);
+    gimbal_control_.set_status_feed(&status_feed_);
+    udp_relay_.set_status_feed(&status_feed_);
+
+    start_preview();
+
     statusBar()->showMessage(tr("상태 정보를 수집하는 중입니다."), 2000);
     refresh_status();
 }
 
+MainWindow::~MainWindow() {
+    image_bridge_.set_status_feed(nullptr);
+    gimbal_control_.set_status_feed(nullptr);
+    udp_relay_.set_status_feed(nullptr);
+    preview_thread_->quit();
+    preview_thread_->wait();
+}
+
+void MainWindow::start_preview() {
+    preview_thread_ = new QThread(this);
+    preview_thread_->setObjectName("preview-decode");
+    preview_decoder_ = new PreviewDecoder(image_bridge_);
+    preview_decoder_->moveToThread(preview_thread_);
+    connect(preview_thread_, &QThread::started, preview_decoder_, &PreviewDecoder::start);
+    connect(preview_thread_, &QThread::finished, preview_decoder_, &QObject::deleteLater);
+    connect(preview_decoder_, &PreviewDecoder::frame_ready, this, &MainWindow::show_preview, Qt::QueuedConnection);
+    update_preview_size();
+    preview_thread_->start(QThread::LowPriority);
+}
+
+void MainWindow::update_preview_size() {
+    if (preview_decoder_ && image_preview_) {
+        preview_decoder_->set_target_size(image_preview_->contentsRect().size());
+    }
+}
+
+void MainWindow::resizeEvent(QResizeEvent* event) {
+    QMainWindow::resizeEvent(event);
+    update_preview_size();
+}
+
+void MainWindow::showEvent(QShowEvent* event) {
+    QMainWindow::showEvent(event);
+    update_preview_size();
+}
+
+void MainWindow::show_preview(const QImage& image, quint64 sequence) {
+    image_preview_->setPixmap(QPixmap::fromImage(image));
+    image_preview_->setToolTip(tr("프레임 #%1, %2x%3")
+                                   .arg(static_cast<qulonglong>(sequence))
+                                   .arg(image.width())
+                                   .arg(image.height()));
+    has_preview_ = true;
+    preview_decoder_->frame_shown();
+}
+
 QWidget* MainWindow::build_central_widget() {
     auto* central = new QWidget(this);
     auto* layout = new QVBoxLayout(central);
     layout->setContentsMargins(16, 16, 16, 16);
     layout->setSpacing(16);
 
-    layout->addWidget(build_image_panel());
+    auto* top = new QHBoxLayout();
+    top->setSpacing(16);
+    top->addWidget(build_image_panel(), 2);
+    gimbal_panel_ = new GimbalPanel(gimbal_control_, central);
+    top->addWidget(gimbal_panel_, 1);
+    layout->addLayout(top);
     layout->addWidget(build_status_panel());
+    layout->addWidget(build_trend_panel());
     layout->addWidget(build_navigation_panel());
 
     return central;
@@ -63,6 +143,9 @@ QWidget* MainWindow::build_image_panel() {
     image_preview_->setAlignment(Qt::AlignCenter);
     image_preview_->setMinimumHeight(260);
     image_preview_->setStyleSheet("background-color: #202020; color: #f0f0f0; border: 1px solid #404040;");
+    // The pixmap is scaled to the label, not the other way round; without
+    // this every frame would grow the window to its own size hint.
+    image_preview_->setSizePolicy(QSizePolicy::Ignored, QSizePolicy::Ignored);
 
     last_frame_info_ = new QLabel(tr("마지막 프레임: 수신 대기"), group);
     last_frame_info_->setAlignment(Qt::AlignCenter);
@@ -91,6 +174,79 @@ QWidget* MainWindow::build_status_panel() {
     return group;
 }
 
+QWidget* MainWindow::build_trend_panel() {
+    auto* group = new QGroupBox(tr("실시간 추이 (최근 3분)"), this);
+    auto* grid = new QGridLayout(group);
+    grid->setSpacing(8);
+
+    relay_pps_chart_ = new Sparkline(tr("릴레이"), tr("pps"), kChartPoints, group);
+    relay_pps_chart_->add_series(QString(), QColor(0x4f, 0xc3, 0xf7));
+    relay_pps_chart_->set_precision(0);
+    relay_mbps_chart_ = new Sparkline(tr("릴레이"), tr("Mbps"), kChartPoints, group);
+    relay_mbps_chart_->add_series(QString(), QColor(0x81, 0xc7, 0x84));
+    relay_mbps_chart_->set_precision(2);
+    frame_fps_chart_ = new Sparkline(tr("이미지 수신"), tr("fps"), kChartPoints, group);
+    frame_fps_chart_->add_series(QString(), QColor(0xff, 0xb7, 0x4d));
+    frame_age_chart_ = new Sparkline(tr("마지막 프레임 경과"), tr("ms"), kChartPoints, group);
+    frame_age_chart_->add_series(QString(), QColor(0xe5, 0x73, 0x73));
+    frame_age_chart_->set_precision(0);
+    pose_chart_ = new Sparkline(tr("짐벌 자세"), tr("°"), kChartPoints, group);
+    pose_chart_->add_series(tr("Yaw"), QColor(0x4f, 0xc3, 0xf7));
+    pose_chart_->add_series(tr("Pitch"), QColor(0x81, 0xc7, 0x84));
+    pose_chart_->add_series(tr("Roll"), QColor(0xff, 0xb7, 0x4d));
+    pose_chart_->set_zero_based(false);
+
+    grid->addWidget(relay_pps_chart_, 0, 0);
+    grid->addWidget(relay_mbps_chart_, 1, 0);
+    grid->addWidget(frame_fps_chart_, 0, 1);
+    grid->addWidget(frame_age_chart_, 1, 1);
+    grid->addWidget(pose_chart_, 0, 2, 2, 1);
+    for (int column = 0; column < 3; ++column) grid->setColumnStretch(column, 1);
+    return group;
+}
+
+void MainWindow::drain_status_feed() {
+    struct Totals {
+        std::int64_t interval_ns = 0;
+        std::uint64_t packets = 0;
+        std::uint64_t bytes = 0;
+    };
+    Totals relay;
+    Totals image;
+    status_feed_.drain([&](const core::StatusDelta& delta) {
+        switch (delta.source) {
+        case core::StatusDelta::Source::Relay:
+            relay.interval_ns += delta.interval_ns;
+            relay.packets += delta.packets;
+            relay.bytes += delta.bytes;
+            break;
+        case core::StatusDelta::Source::Image:
+            image.interval_ns += delta.interval_ns;
+            image.packets += delta.packets;
+            frame_age_ms_ = delta.frame_age_ns < 0 ? std::numeric_limits<double>::quiet_NaN()
+                                                    : static_cast<double>(delta.frame_age_ns) / 1e6;
+            break;
+        case core::StatusDelta::Source::Gimbal:
+            if (delta.running) {
+                pose_ = delta.pose;
+                have_pose_ = true;
+            }
+            break;
+        }
+    });
+
+    // A tick without deltas (a busy loop) still gets a point, so every chart
+    // advances at the same pace.
+    relay_pps_chart_->append(0, per_second(relay.packets, relay.interval_ns));
+    relay_mbps_chart_->append(0, per_second(relay.bytes, relay.interval_ns) * 8.0 / 1e6);
+    frame_fps_chart_->append(0, per_second(image.packets, image.interval_ns));
+    frame_age_chart_->append(0, frame_age_ms_);
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    pose_chart_->append(0, have_pose_ ? pose_.yaw : nan);
+    pose_chart_->append(1, have_pose_ ? pose_.pitch : nan);
+    pose_chart_->append(2, have_pose_ ? pose_.roll : nan);
+}
+
 QWidget* MainWindow::build_navigation_panel() {
     auto* group = new QGroupBox(tr("주요 모듈 설정"), this);
     auto* layout = new QHBoxLayout(group);
@@ -127,27 +283,49 @@ void MainWindow::refresh_status() {
                                    .arg(static_cast<qulonglong>(img.clients)));
 
     if (img.last_frame_bytes == 0 || img.last_frame_time.time_since_epoch().count() == 0) {
-        image_preview_->setText(tr("아직 수신된 이미지가 없습니다."));
+        if (!has_preview_) {
+            image_preview_->setText(tr("아직 수신된 이미지가 없습니다."));
+        }
         last_frame_info_->setText(tr("마지막 프레임: 수신 대기"));
     } else {
         const auto now = std::chrono::system_clock::now();
         const auto age = std::chrono::duration_cast<std::chrono::milliseconds>(now - img.last_frame_time).count();
-        image_preview_->setText(tr("최근 프레임 크기: %1 바이트").arg(static_cast<qulonglong>(img.last_frame_bytes)));
-        last_frame_info_->setText(tr("마지막 프레임: %1 ms 전")
-                                      .arg(age >= 0 ? age : -1));
+        if (!has_preview_) {
+            image_preview_->setText(tr("프레임을 디코딩하는 중입니다."));
+        }
+        last_frame_info_->setText(tr("마지막 프레임: %1 ms 전, %2 바이트")
+                                      .arg(age >= 0 ? age : -1)
+                                      .arg(static_cast<qulonglong>(img.last_frame_bytes)));
     }
 
     gimbal_status_->setText(gimbal.running ? tr("동작 중") : tr("중지"));
-    gimbal_status_->setToolTip(tr("Yaw %1°, Pitch %2°, Roll %3°, Zoom %4x")
-                                   .arg(QString::number(gimbal.yaw, 'f', 1))
-                                   .arg(QString::number(gimbal.pitch, 'f', 1))
-                                   .arg(QString::number(gimbal.roll, 'f', 1))
-                                   .arg(QString::number(gimbal.zoom, 'f', 1)));
+    QString gimbal_tooltip = tr("Yaw %1°, Pitch %2°, Roll %3°, Zoom %4x")
+                                 .arg(QString::number(gimbal.yaw, 'f', 1))
+                                 .arg(QString::number(gimbal.pitch, 'f', 1))
+                                 .arg(QString::number(gimbal.roll, 'f', 1))
+                                 .arg(QString::number(gimbal.zoom, 'f', 1));
+    if (gimbal.measuring_latency) {
+        gimbal_tooltip += tr("\n왕복 지연 (%1회): p50 %2 ms, p99 %3 ms, 최대 %4 ms")
+                              .arg(static_cast<qulonglong>(gimbal.latency_samples))
+                              .arg(QString::number(gimbal.latency_p50_ms, 'f', 2))
+                              .arg(QString::number(gimbal.latency_p99_ms, 'f', 2))
+                              .arg(QString::number(gimbal.latency_max_ms, 'f', 2));
+    }
+    gimbal_status_->setToolTip(gimbal_tooltip);
 
     relay_status_->setText(relay.running ? tr("동작 중") : tr("중지"));
-    relay_status_->setToolTip(tr("전달된 패킷 %1개 / %2바이트")
+    relay_status_->setToolTip(tr("전달된 패킷 %1개 / %2바이트\nRAW: 전송 %3, 대기 %4, 버림 %5, 오류 %6\n"
+                                 "PROC: 전송 %7, 대기 %8, 버림 %9, 오류 %10")
                                   .arg(static_cast<qulonglong>(relay.forwarded_packets))
-                                  .arg(static_cast<qulonglong>(relay.forwarded_bytes)));
+                                  .arg(static_cast<qulonglong>(relay.forwarded_bytes))
+                                  .arg(static_cast<qulonglong>(relay.raw.sent_packets))
+                                  .arg(static_cast<qulonglong>(relay.raw.queued_packets))
+                                  .arg(static_cast<qulonglong>(relay.raw.dropped_packets))
+                                  .arg(static_cast<qulonglong>(relay.raw.send_errors))
+                                  .arg(static_cast<qulonglong>(relay.proc.sent_packets))
+                                  .arg(static_cast<qulonglong>(relay.proc.queued_packets))
+                                  .arg(static_cast<qulonglong>(relay.proc.dropped_packets))
+                                  .arg(static_cast<qulonglong>(relay.proc.send_errors)));
 }
 
 void MainWindow::open_image_settings() {
@@ -177,7 +355,8 @@ void MainWindow::open_image_settings() {
         config_.bridge.realtime_dir = values.at("realtime").toStdString();
         config_.bridge.predefined_dir = values.at("predefined").toStdString();
         config_manager_.save(config_);
-        show_status_message(tr("이미지 스트리밍 설정을 저장했습니다."));
+        image_bridge_.apply_settings(config_.bridge);
+        show_status_message(tr("이미지 스트리밍 설정을 저장하고 적용했습니다."));
     }
 }
 
@@ -204,7 +383,8 @@ void MainWindow::open_gimbal_settings() {
         config_.gimbal.generator_ip = values.at("generator_ip").toStdString();
         config_.gimbal.generator_port = values.at("generator_port").toInt();
         config_manager_.save(config_);
-        show_status_message(tr("짐벌 제어 설정을 저장했습니다."));
+        gimbal_control_.apply_settings(config_.gimbal);
+        show_status_message(tr("짐벌 제어 설정을 저장하고 적용했습니다."));
     }
 }
 
@@ -239,7 +419,23 @@ void MainWindow::open_relay_settings() {
         config_.relay.proc_ip = values.at("proc_ip").toStdString();
         config_.relay.proc_port = values.at("proc_port").toInt();
         config_manager_.save(config_);
-        show_status_message(tr("UDP 릴레이 설정을 저장했습니다."));
+        udp_relay_.apply_settings(config_.relay);
+        show_status_message(tr("UDP 릴레이 설정을 저장하고 적용했습니다."));
+    }
+}
+
+void MainWindow::reload_config() {
+    auto loaded = config_manager_.try_load();
+    if (!loaded) {
+        show_status_message(tr("설정 파일을 읽을 수 없어 기존 설정을 유지합니다."));
+        return;
+    }
+    bool changed = image_bridge_.apply_settings(loaded->bridge);
+    changed = gimbal_control_.apply_settings(loaded->gimbal) || changed;
+    changed = udp_relay_.apply_settings(loaded->relay) || changed;
+    config_ = std::move(*loaded);
+    if (changed) {
+        show_status_message(tr("변경된 설정 파일을 다시 적용했습니다."));
     }
 }
 
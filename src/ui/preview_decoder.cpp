@@ -0,0 +1,75 @@
+#include "ui/preview_decoder.hpp"
+
+#include <memory>
+#include <vector>
+
+#include <QBuffer>
+#include <QByteArray>
+#include <QImageReader>
+#include <QTimer>
+
+namespace ui {
+
+PreviewDecoder::PreviewDecoder(core::ImageStreamBridge& image_bridge, QObject* parent)
+    : QObject(parent), image_bridge_(image_bridge) {}
+
+void PreviewDecoder::set_target_size(const QSize& size) {
+    target_width_.store(size.width(), std::memory_order_relaxed);
+    target_height_.store(size.height(), std::memory_order_relaxed);
+}
+
+void PreviewDecoder::start() {
+    // Created here rather than in the constructor so the timer belongs to
+    // the decoder thread.
+    poll_timer_ = new QTimer(this);
+    poll_timer_->setInterval(kPollIntervalMs);
+    connect(poll_timer_, &QTimer::timeout, this, &PreviewDecoder::poll);
+    poll_timer_->start();
+}
+
+void PreviewDecoder::poll() {
+    if (in_flight_.load(std::memory_order_acquire)) {
+        return;
+    }
+    const QSize target(target_width_.load(std::memory_order_relaxed),
+                       target_height_.load(std::memory_order_relaxed));
+    if (target.isEmpty()) {
+        return;
+    }
+
+    std::shared_ptr<const std::vector<std::uint8_t>> frame;
+    const auto meta = image_bridge_.latest_frame(frame);
+    if (!frame || frame->empty()) {
+        return;
+    }
+    if (meta.sequence == last_sequence_ && target == decoded_for_) {
+        return;
+    }
+    last_sequence_ = meta.sequence;
+    decoded_for_ = target;
+
+    // `frame` stays pinned until the decode is done, so the bytes can be
+    // borrowed instead of copied.
+    const QByteArray bytes = QByteArray::fromRawData(reinterpret_cast<const char*>(frame->data()),
+                                                     static_cast<qsizetype>(frame->size()));
+    QBuffer buffer;
+    buffer.setData(bytes);
+    buffer.open(QIODevice::ReadOnly);
+    QImageReader reader(&buffer);
+    QSize size = reader.size();
+    if (size.isValid()) {
+        // The JPEG plugin turns this into a DCT-scaled decode, which is far
+        // cheaper than decoding at full resolution and scaling afterwards.
+        size.scale(target, Qt::KeepAspectRatio);
+        reader.setScaledSize(size);
+    }
+    QImage image = reader.read();
+    if (image.isNull()) {
+        return;
+    }
+
+    in_flight_.store(true, std::memory_order_release);
+    emit frame_ready(image, static_cast<quint64>(meta.sequence));
+}
+
+}  // namespace ui
@@ -0,0 +1,114 @@
+#include "ui/sparkline.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+#include <QPainter>
+#include <QPainterPath>
+#include <QPen>
+
+namespace ui {
+
+Sparkline::Sparkline(const QString& title, const QString& unit, std::size_t capacity, QWidget* parent)
+    : QWidget(parent), title_(title), unit_(unit), capacity_(std::max<std::size_t>(capacity, 2)) {
+    setAttribute(Qt::WA_OpaquePaintEvent);
+}
+
+int Sparkline::add_series(const QString& name, const QColor& color) {
+    Series series;
+    series.name = name;
+    series.color = color;
+    series.values.assign(capacity_, std::numeric_limits<double>::quiet_NaN());
+    series_.push_back(std::move(series));
+    return static_cast<int>(series_.size()) - 1;
+}
+
+void Sparkline::append(int series, double value) {
+    if (series < 0 || static_cast<std::size_t>(series) >= series_.size()) return;
+    Series& s = series_[static_cast<std::size_t>(series)];
+    s.values[s.next] = value;
+    s.next = (s.next + 1) % capacity_;
+    s.count = std::min(s.count + 1, capacity_);
+    update();
+}
+
+double Sparkline::Series::at(std::size_t i) const {
+    const std::size_t capacity = values.size();
+    return values[(next + capacity - count + i) % capacity];
+}
+
+double Sparkline::Series::latest() const {
+    return count == 0 ? std::numeric_limits<double>::quiet_NaN() : at(count - 1);
+}
+
+QSize Sparkline::sizeHint() const { return QSize(280, 72); }
+
+QSize Sparkline::minimumSizeHint() const { return QSize(160, 56); }
+
+void Sparkline::paintEvent(QPaintEvent* /*event*/) {
+    QPainter painter(this);
+    painter.fillRect(rect(), QColor(0x20, 0x20, 0x20));
+    painter.setPen(QColor(0x40, 0x40, 0x40));
+    painter.drawRect(rect().adjusted(0, 0, -1, -1));
+
+    // Header: title and the newest value of every series.
+    QString header = title_;
+    for (const auto& s : series_) {
+        const double value = s.latest();
+        header += QStringLiteral("  ");
+        if (!s.name.isEmpty()) header += s.name + QLatin1Char(' ');
+        header += std::isfinite(value) ? QString::number(value, 'f', precision_) : QStringLiteral("-");
+    }
+    if (!unit_.isEmpty()) header += QLatin1Char(' ') + unit_;
+    const int text_height = fontMetrics().height();
+    painter.setPen(QColor(0xf0, 0xf0, 0xf0));
+    painter.drawText(QRect(6, 2, width() - 12, text_height), Qt::AlignLeft | Qt::AlignVCenter, header);
+
+    const QRectF plot(4.0, text_height + 6.0, width() - 8.0, height() - text_height - 10.0);
+    if (plot.height() <= 0.0) return;
+
+    double low = zero_based_ ? 0.0 : std::numeric_limits<double>::infinity();
+    double high = zero_based_ ? 0.0 : -std::numeric_limits<double>::infinity();
+    for (const auto& s : series_) {
+        for (std::size_t i = 0; i < s.count; ++i) {
+            const double value = s.at(i);
+            if (!std::isfinite(value)) continue;
+            low = std::min(low, value);
+            high = std::max(high, value);
+        }
+    }
+    if (!std::isfinite(low) || !std::isfinite(high)) return;
+    if (high - low < 1e-9) {
+        high += 1.0;
+        if (!zero_based_) low -= 1.0;
+    }
+
+    // Newest sample on the right edge; the chart fills up from the right.
+    const double step = plot.width() / static_cast<double>(capacity_ - 1);
+    painter.setRenderHint(QPainter::Antialiasing);
+    for (const auto& s : series_) {
+        QPainterPath path;
+        bool drawing = false;
+        for (std::size_t i = 0; i < s.count; ++i) {
+            const double value = s.at(i);
+            if (!std::isfinite(value)) {
+                drawing = false;
+                continue;
+            }
+            const double x = plot.right() - static_cast<double>(s.count - 1 - i) * step;
+            const double y = plot.bottom() - (value - low) / (high - low) * plot.height();
+            if (drawing) {
+                path.lineTo(x, y);
+            } else {
+                path.moveTo(x, y);
+                drawing = true;
+            }
+        }
+        painter.setPen(QPen(s.color, 1.5));
+        painter.drawPath(path);
+    }
+}
+
+}  // namespace ui
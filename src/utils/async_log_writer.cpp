@@ -0,0 +1,194 @@
+#include "utils/async_log_writer.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <system_error>
+
+#include "utils/logger.hpp"
+#include "utils/metrics.hpp"
+#include "utils/thread_tuning.hpp"
+#include "utils/timestamp.hpp"
+
+namespace logging {
+
+namespace {
+constexpr std::size_t kBatchFlushBytes = 64 * 1024;
+constexpr auto kIdleSleep = std::chrono::milliseconds(5);
+}
+
+void LogRecord::set_message(std::string_view message) {
+    if (message.size() <= kInlineCapacity) {
+        std::memcpy(inline_text, message.data(), message.size());
+        inline_length = static_cast<std::uint16_t>(message.size());
+        overflow.clear();
+    } else {
+        inline_length = 0;
+        overflow.assign(message.data(), message.size());
+    }
+}
+
+std::string_view LogRecord::message() const {
+    if (!overflow.empty()) {
+        return overflow;
+    }
+    return std::string_view(inline_text, inline_length);
+}
+
+AsyncLogWriter::AsyncLogWriter(std::string name, AsyncOptions options)
+    : name_(std::move(name)), options_(std::move(options)), queue_(options_.queue_capacity) {
+    batch_.reserve(kBatchFlushBytes * 2);
+}
+
+AsyncLogWriter::~AsyncLogWriter() { stop(); }
+
+void AsyncLogWriter::start() {
+    if (running_) return;
+    if (!options_.file_path.empty()) {
+        open_file();
+    }
+    running_ = true;
+    last_flush_ = std::chrono::steady_clock::now();
+    thread_ = std::thread(&AsyncLogWriter::run, this);
+}
+
+void AsyncLogWriter::stop() {
+    if (!running_) return;
+    running_ = false;
+    if (thread_.joinable()) thread_.join();
+    // Pick up anything pushed while the writer was shutting down.
+    bool drained = true;
+    while (drained) {
+        drained = drain();
+        write_batch(false);
+    }
+    write_batch(true);
+    if (file_.is_open()) file_.close();
+}
+
+bool AsyncLogWriter::push(Level level, std::string_view message) {
+    auto now = std::chrono::system_clock::now();
+    bool pushed = queue_.try_emplace([&](LogRecord& record) {
+        record.time = now;
+        record.level = level;
+        record.set_message(message);
+    });
+    if (!pushed) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        static metrics::Counter& dropped_total =
+            metrics::default_registry().counter("log_records_dropped", "Async log records dropped on a full queue");
+        dropped_total.add();
+    }
+    return pushed;
+}
+
+void AsyncLogWriter::run() {
+    utils::set_current_thread_name("log-writer");
+    if (options_.on_thread_start) options_.on_thread_start();
+    while (running_) {
+        bool got = drain();
+        auto now = std::chrono::steady_clock::now();
+        bool due = now - last_flush_ >= options_.flush_interval;
+        if (!batch_.empty() || due) {
+            write_batch(due || batch_has_error_);
+        }
+        if (!got) {
+            std::this_thread::sleep_for(std::min<std::chrono::milliseconds>(kIdleSleep, options_.flush_interval));
+        }
+    }
+}
+
+bool AsyncLogWriter::drain() {
+    bool any = false;
+    LogRecord record;
+    while (batch_.size() < kBatchFlushBytes && queue_.try_pop(record)) {
+        append(record);
+        any = true;
+    }
+    queue_.publish_consumer_position();
+
+    std::size_t dropped_now = dropped_.load(std::memory_order_relaxed);
+    if (dropped_now != reported_drops_) {
+        batch_ += '[' + format_timestamp(std::chrono::system_clock::now()) + "] [WARN] " + name_ + ": dropped " +
+                  std::to_string(dropped_now - reported_drops_) + " log records (queue full)\n";
+        reported_drops_ = dropped_now;
+    }
+    return any;
+}
+
+void AsyncLogWriter::append(const LogRecord& record) {
+    batch_ += '[';
+    timestamp::append_local(batch_, record.time);
+    batch_ += "] [";
+    batch_ += level_to_string(record.level);
+    batch_ += "] ";
+    batch_ += name_;
+    batch_ += ": ";
+    batch_ += record.message();
+    batch_ += '\n';
+    if (record.level == Level::Error) {
+        batch_has_error_ = true;
+    }
+    written_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void AsyncLogWriter::write_batch(bool force_flush) {
+    if (!batch_.empty()) {
+        if (options_.console) {
+            std::cout.write(batch_.data(), static_cast<std::streamsize>(batch_.size()));
+        }
+        if (file_.is_open()) {
+            if (options_.max_file_bytes > 0 && file_bytes_ + batch_.size() > options_.max_file_bytes && file_bytes_ > 0) {
+                rotate_file();
+            }
+            if (file_.is_open()) {
+                file_.write(batch_.data(), static_cast<std::streamsize>(batch_.size()));
+                file_bytes_ += batch_.size();
+            }
+        }
+        batch_.clear();
+    }
+    if (force_flush) {
+        if (options_.console) std::cout.flush();
+        if (file_.is_open()) file_.flush();
+        last_flush_ = std::chrono::steady_clock::now();
+        batch_has_error_ = false;
+    }
+}
+
+void AsyncLogWriter::open_file() {
+    namespace fs = std::filesystem;
+    fs::path path(options_.file_path);
+    std::error_code ec;
+    if (path.has_parent_path()) {
+        fs::create_directories(path.parent_path(), ec);
+    }
+    file_.open(path, std::ios::out | std::ios::app | std::ios::binary);
+    file_bytes_ = 0;
+    if (file_) {
+        auto size = fs::file_size(path, ec);
+        if (!ec) file_bytes_ = static_cast<std::size_t>(size);
+    } else {
+        std::cerr << "Failed to open log file " << options_.file_path << std::endl;
+    }
+}
+
+void AsyncLogWriter::rotate_file() {
+    namespace fs = std::filesystem;
+    file_.close();
+    std::error_code ec;
+    const std::string base = options_.file_path;
+    if (options_.max_files > 1) {
+        fs::remove(base + "." + std::to_string(options_.max_files - 1), ec);
+        for (int i = options_.max_files - 2; i >= 1; --i) {
+            fs::rename(base + "." + std::to_string(i), base + "." + std::to_string(i + 1), ec);
+        }
+        fs::rename(base, base + ".1", ec);
+    } else {
+        fs::remove(base, ec);
+    }
+    open_file();
+}
+
+}  // namespace logging
@@ -0,0 +1,110 @@
+#include "utils/config_watcher.hpp"
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+#include <filesystem>
+#include <system_error>
+
+#include "utils/thread_tuning.hpp"
+
+namespace fs = std::filesystem;
+
+namespace settings {
+
+namespace {
+constexpr auto kDebounce = std::chrono::milliseconds(200);
+constexpr auto kPollInterval = std::chrono::seconds(1);
+constexpr int kWakeIntervalMs = 250;  // how quickly stop() is noticed
+}
+
+ConfigWatcher::ConfigWatcher(std::string path, std::function<void()> on_change, logging::Logger& logger)
+    : path_(std::move(path)), on_change_(std::move(on_change)), logger_(logger) {}
+
+ConfigWatcher::~ConfigWatcher() { stop(); }
+
+void ConfigWatcher::start() {
+    if (running_) return;
+    running_ = true;
+#ifdef __linux__
+    const fs::path file(path_);
+    const std::string dir = file.has_parent_path() ? file.parent_path().string() : std::string(".");
+    inotify_fd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotify_fd_ >= 0 && inotify_add_watch(inotify_fd_, dir.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0) {
+        ::close(inotify_fd_);
+        inotify_fd_ = -1;
+    }
+    if (inotify_fd_ >= 0) {
+        thread_ = std::thread(&ConfigWatcher::run_inotify, this);
+        logger_.info("Watching " + path_ + " for changes");
+        return;
+    }
+    logger_.warn("inotify unavailable; polling " + path_ + " for changes");
+#endif
+    thread_ = std::thread(&ConfigWatcher::run_polling, this);
+}
+
+void ConfigWatcher::stop() {
+    if (!running_) return;
+    running_ = false;
+    if (thread_.joinable()) thread_.join();
+#ifdef __linux__
+    if (inotify_fd_ >= 0) {
+        ::close(inotify_fd_);
+        inotify_fd_ = -1;
+    }
+#endif
+}
+
+void ConfigWatcher::run_inotify() {
+    utils::set_current_thread_name("config-watch");
+#ifdef __linux__
+    using clock = std::chrono::steady_clock;
+    const std::string name = fs::path(path_).filename().string();
+    alignas(inotify_event) char buffer[4096];
+    bool pending = false;
+    clock::time_point due{};
+    while (running_) {
+        pollfd pfd{inotify_fd_, POLLIN, 0};
+        int ready = ::poll(&pfd, 1, kWakeIntervalMs);
+        if (ready > 0) {
+            ssize_t length;
+            while ((length = ::read(inotify_fd_, buffer, sizeof(buffer))) > 0) {
+                for (char* p = buffer; p < buffer + length;) {
+                    auto* event = reinterpret_cast<inotify_event*>(p);
+                    if (event->len > 0 && name == event->name) {
+                        pending = true;
+                        due = clock::now() + kDebounce;
+                    }
+                    p += sizeof(inotify_event) + event->len;
+                }
+            }
+        }
+        if (pending && clock::now() >= due) {
+            pending = false;
+            on_change_();
+        }
+    }
+#endif
+}
+
+void ConfigWatcher::run_polling() {
+    utils::set_current_thread_name("config-watch");
+    std::error_code ec;
+    auto last = fs::last_write_time(path_, ec);
+    auto next_check = std::chrono::steady_clock::now() + kPollInterval;
+    while (running_) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(kWakeIntervalMs));
+        if (std::chrono::steady_clock::now() < next_check) continue;
+        next_check += kPollInterval;
+        auto current = fs::last_write_time(path_, ec);
+        if (ec || current == last) continue;
+        last = current;
+        on_change_();
+    }
+}
+
+}  // namespace settings
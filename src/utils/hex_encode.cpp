@@ -0,0 +1,236 @@
+#include "utils/hex_encode.hpp"
+
+#include <array>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define BRIDGE_HEX_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(BRIDGE_HEX_X86) && (defined(__GNUC__) || defined(__clang__))
+#define BRIDGE_TARGET(isa) __attribute__((target(isa)))
+#else
+#define BRIDGE_TARGET(isa)
+#endif
+
+namespace utils {
+
+namespace {
+
+constexpr char kDigits[] = "0123456789abcdef";
+
+struct PairTable {
+    std::array<char, 512> text{};
+};
+
+constexpr PairTable make_pair_table() {
+    PairTable table;
+    for (int i = 0; i < 256; ++i) {
+        table.text[2 * i] = kDigits[i >> 4];
+        table.text[2 * i + 1] = kDigits[i & 0x0f];
+    }
+    return table;
+}
+
+constexpr PairTable kPairs = make_pair_table();
+
+std::size_t encode_scalar(char* out, const std::uint8_t* data, std::size_t size) {
+    char* p = out;
+    for (std::size_t i = 0; i < size; ++i) {
+        const char* pair = &kPairs.text[2 * data[i]];
+        p[0] = pair[0];
+        p[1] = pair[1];
+        p[2] = ' ';
+        p += 3;
+    }
+    return hex_spaced_length(size);
+}
+
+#ifdef BRIDGE_HEX_X86
+
+// Output position p (0..95) holds the high digit of input byte p / 3 when
+// p % 3 == 0, the low digit when p % 3 == 1 and a space otherwise. The masks
+// feed pshufb, which selects within a 16-byte lane, so indices are taken
+// modulo 16 and 0x80 zeroes the byte. The first 48 entries describe one
+// 16-byte input block; all 96 describe one 32-byte AVX2 block, whose middle
+// output vector straddles both input lanes.
+struct ShuffleMasks {
+    alignas(32) std::array<std::int8_t, 96> high{};
+    alignas(32) std::array<std::int8_t, 96> low{};
+    alignas(32) std::array<std::int8_t, 96> spaces{};
+};
+
+constexpr ShuffleMasks make_shuffle_masks() {
+    ShuffleMasks masks;
+    for (int p = 0; p < 96; ++p) {
+        auto source = static_cast<std::int8_t>((p / 3) & 0x0f);
+        masks.high[p] = p % 3 == 0 ? source : static_cast<std::int8_t>(0x80);
+        masks.low[p] = p % 3 == 1 ? source : static_cast<std::int8_t>(0x80);
+        masks.spaces[p] = p % 3 == 2 ? ' ' : 0;
+    }
+    return masks;
+}
+
+alignas(32) constexpr ShuffleMasks kMasks = make_shuffle_masks();
+
+BRIDGE_TARGET("ssse3")
+std::size_t encode_ssse3(char* out, const std::uint8_t* data, std::size_t size) {
+    const __m128i digits = _mm_loadu_si128(reinterpret_cast<const __m128i*>(kDigits));
+    const __m128i nibble = _mm_set1_epi8(0x0f);
+    std::size_t i = 0;
+    char* p = out;
+    for (; i + 16 <= size; i += 16, p += 48) {
+        __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        __m128i high = _mm_shuffle_epi8(digits, _mm_and_si128(_mm_srli_epi16(bytes, 4), nibble));
+        __m128i low = _mm_shuffle_epi8(digits, _mm_and_si128(bytes, nibble));
+        for (int chunk = 0; chunk < 3; ++chunk) {
+            const auto* mh = reinterpret_cast<const __m128i*>(kMasks.high.data() + 16 * chunk);
+            const auto* ml = reinterpret_cast<const __m128i*>(kMasks.low.data() + 16 * chunk);
+            const auto* ms = reinterpret_cast<const __m128i*>(kMasks.spaces.data() + 16 * chunk);
+            __m128i text = _mm_or_si128(_mm_shuffle_epi8(high, _mm_load_si128(mh)),
+                                        _mm_shuffle_epi8(low, _mm_load_si128(ml)));
+            text = _mm_or_si128(text, _mm_load_si128(ms));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(p + 16 * chunk), text);
+        }
+    }
+    encode_scalar(p, data + i, size - i);
+    return hex_spaced_length(size);
+}
+
+BRIDGE_TARGET("avx2")
+std::size_t encode_avx2(char* out, const std::uint8_t* data, std::size_t size) {
+    const __m256i digits = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(kDigits)));
+    const __m256i nibble = _mm256_set1_epi8(0x0f);
+    const __m256i mask_high[3] = {_mm256_load_si256(reinterpret_cast<const __m256i*>(kMasks.high.data())),
+                                  _mm256_load_si256(reinterpret_cast<const __m256i*>(kMasks.high.data() + 32)),
+                                  _mm256_load_si256(reinterpret_cast<const __m256i*>(kMasks.high.data() + 64))};
+    const __m256i mask_low[3] = {_mm256_load_si256(reinterpret_cast<const __m256i*>(kMasks.low.data())),
+                                 _mm256_load_si256(reinterpret_cast<const __m256i*>(kMasks.low.data() + 32)),
+                                 _mm256_load_si256(reinterpret_cast<const __m256i*>(kMasks.low.data() + 64))};
+    const __m256i spaces[3] = {_mm256_load_si256(reinterpret_cast<const __m256i*>(kMasks.spaces.data())),
+                               _mm256_load_si256(reinterpret_cast<const __m256i*>(kMasks.spaces.data() + 32)),
+                               _mm256_load_si256(reinterpret_cast<const __m256i*>(kMasks.spaces.data() + 64))};
+    std::size_t i = 0;
+    char* p = out;
+    for (; i + 32 <= size; i += 32, p += 96) {
+        __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        __m256i high = _mm256_shuffle_epi8(digits, _mm256_and_si256(_mm256_srli_epi16(bytes, 4), nibble));
+        __m256i low = _mm256_shuffle_epi8(digits, _mm256_and_si256(bytes, nibble));
+        // Output 0 reads input bytes 0..10 (low lane), output 1 bytes 10..21
+        // (both lanes as loaded), output 2 bytes 21..31 (high lane).
+        __m256i sources_high[3] = {_mm256_permute2x128_si256(high, high, 0x00), high,
+                                   _mm256_permute2x128_si256(high, high, 0x11)};
+        __m256i sources_low[3] = {_mm256_permute2x128_si256(low, low, 0x00), low,
+                                  _mm256_permute2x128_si256(low, low, 0x11)};
+        for (int chunk = 0; chunk < 3; ++chunk) {
+            __m256i text = _mm256_or_si256(_mm256_shuffle_epi8(sources_high[chunk], mask_high[chunk]),
+                                           _mm256_shuffle_epi8(sources_low[chunk], mask_low[chunk]));
+            text = _mm256_or_si256(text, spaces[chunk]);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(p + 32 * chunk), text);
+        }
+    }
+    encode_ssse3(p, data + i, size - i);
+    return hex_spaced_length(size);
+}
+
+bool cpu_has(HexKernel kernel) {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_cpu_init();
+    if (kernel == HexKernel::Avx2) return __builtin_cpu_supports("avx2");
+    if (kernel == HexKernel::Ssse3) return __builtin_cpu_supports("ssse3");
+    return true;
+#elif defined(_MSC_VER)
+    int regs[4] = {0, 0, 0, 0};
+    __cpuid(regs, 1);
+    const bool ssse3 = (regs[2] & (1 << 9)) != 0;
+    const bool osxsave = (regs[2] & (1 << 27)) != 0;
+    if (kernel == HexKernel::Ssse3) return ssse3;
+    if (kernel == HexKernel::Avx2) {
+        if (!osxsave || (_xgetbv(0) & 0x6) != 0x6) return false;
+        __cpuidex(regs, 7, 0);
+        return (regs[1] & (1 << 5)) != 0;
+    }
+    return true;
+#else
+    return kernel == HexKernel::Scalar;
+#endif
+}
+
+#else
+
+bool cpu_has(HexKernel kernel) { return kernel == HexKernel::Scalar; }
+
+#endif  // BRIDGE_HEX_X86
+
+struct CpuSupport {
+    bool ssse3 = cpu_has(HexKernel::Ssse3);
+    bool avx2 = cpu_has(HexKernel::Avx2);
+};
+
+const CpuSupport& cpu_support() {
+    static const CpuSupport support;
+    return support;
+}
+
+}  // namespace
+
+bool hex_kernel_supported(HexKernel kernel) {
+    switch (kernel) {
+    case HexKernel::Avx2:
+        return cpu_support().avx2;
+    case HexKernel::Ssse3:
+        return cpu_support().ssse3;
+    case HexKernel::Scalar:
+        break;
+    }
+    return true;
+}
+
+HexKernel hex_active_kernel() {
+    if (hex_kernel_supported(HexKernel::Avx2)) return HexKernel::Avx2;
+    if (hex_kernel_supported(HexKernel::Ssse3)) return HexKernel::Ssse3;
+    return HexKernel::Scalar;
+}
+
+const char* hex_kernel_name(HexKernel kernel) {
+    switch (kernel) {
+    case HexKernel::Avx2:
+        return "avx2";
+    case HexKernel::Ssse3:
+        return "ssse3";
+    case HexKernel::Scalar:
+        break;
+    }
+    return "scalar";
+}
+
+std::size_t hex_encode_spaced(HexKernel kernel, char* out, const std::uint8_t* data, std::size_t size) {
+#ifdef BRIDGE_HEX_X86
+    if (kernel == HexKernel::Avx2 && size >= 32 && hex_kernel_supported(kernel)) {
+        return encode_avx2(out, data, size);
+    }
+    if (kernel != HexKernel::Scalar && size >= 16 && hex_kernel_supported(HexKernel::Ssse3)) {
+        return encode_ssse3(out, data, size);
+    }
+#else
+    (void)kernel;
+#endif
+    return encode_scalar(out, data, size);
+}
+
+std::size_t hex_encode_spaced(char* out, const std::uint8_t* data, std::size_t size) {
+    return hex_encode_spaced(hex_active_kernel(), out, data, size);
+}
+
+void append_hex_spaced(std::string& out, const std::uint8_t* data, std::size_t size) {
+    if (size == 0) return;
+    std::size_t start = out.size();
+    out.resize(start + 3 * size);
+    std::size_t written = hex_encode_spaced(&out[start], data, size);
+    out.resize(start + written);
+}
+
+}  // namespace utils
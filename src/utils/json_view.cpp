@@ -0,0 +1,367 @@
+#include "utils/json_view.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+namespace mini_json {
+
+namespace {
+
+constexpr std::size_t kMaxDepth = 512;
+
+bool is_space(char ch) { return ch == ' ' || ch == '\n' || ch == '\r' || ch == '\t' || ch == '\v' || ch == '\f'; }
+bool is_digit(char ch) { return ch >= '0' && ch <= '9'; }
+
+int hex_digit(char ch) {
+    if (ch >= '0' && ch <= '9') return ch - '0';
+    if (ch >= 'a' && ch <= 'f') return ch - 'a' + 10;
+    if (ch >= 'A' && ch <= 'F') return ch - 'A' + 10;
+    return -1;
+}
+
+}  // namespace
+
+Arena::Arena(std::size_t block_size) : block_size_(std::max<std::size_t>(block_size, 1024)) {}
+
+void* Arena::allocate(std::size_t bytes, std::size_t align) {
+    auto misalignment = reinterpret_cast<std::uintptr_t>(cursor_) & (align - 1);
+    std::size_t padding = misalignment ? align - misalignment : 0;
+    if (cursor_ == nullptr || padding + bytes > remaining_) {
+        // Oversized requests get a block of their own so the current block
+        // keeps serving small nodes.
+        std::size_t size = std::max(block_size_, bytes + align);
+        blocks_.emplace_back(new unsigned char[size]);
+        reserved_ += size;
+        unsigned char* block = blocks_.back().get();
+        if (size > block_size_ && cursor_ != nullptr) {
+            auto offset = reinterpret_cast<std::uintptr_t>(block) & (align - 1);
+            return block + (offset ? align - offset : 0);
+        }
+        cursor_ = block;
+        remaining_ = size;
+        misalignment = reinterpret_cast<std::uintptr_t>(cursor_) & (align - 1);
+        padding = misalignment ? align - misalignment : 0;
+    }
+    unsigned char* result = cursor_ + padding;
+    cursor_ = result + bytes;
+    remaining_ -= padding + bytes;
+    return result;
+}
+
+// Containers are collected on scratch stacks while their children are
+// parsed, then copied into one contiguous arena array when they close.
+class ViewParser {
+public:
+    ViewParser(std::string_view text, Arena& arena) : text_(text), arena_(arena) {}
+
+    ViewValue parse_document() {
+        ViewValue root = parse_value(0);
+        skip_ws();
+        if (pos_ != text_.size()) {
+            throw std::runtime_error("Extra data after JSON value");
+        }
+        return root;
+    }
+
+private:
+    ViewValue parse_value(std::size_t depth) {
+        skip_ws();
+        if (pos_ >= text_.size()) {
+            throw std::runtime_error("Unexpected end of JSON input");
+        }
+        ViewValue value;
+        char ch = text_[pos_];
+        switch (ch) {
+            case 'n':
+                expect("null");
+                return value;
+            case 't':
+                expect("true");
+                value.type_ = ViewValue::Type::Bool;
+                value.boolean_ = true;
+                return value;
+            case 'f':
+                expect("false");
+                value.type_ = ViewValue::Type::Bool;
+                return value;
+            case '"': {
+                std::string_view text = parse_string();
+                value.type_ = ViewValue::Type::String;
+                value.text_ = text.data();
+                value.size_ = text.size();
+                return value;
+            }
+            case '{':
+                return parse_object(depth + 1);
+            case '[':
+                return parse_array(depth + 1);
+            default:
+                break;
+        }
+        if (ch == '-' || is_digit(ch)) {
+            value.type_ = ViewValue::Type::Number;
+            value.number_ = parse_number();
+            return value;
+        }
+        throw std::runtime_error("Invalid JSON token");
+    }
+
+    double parse_number() {
+        const std::size_t start = pos_;
+        if (text_[pos_] == '-') ++pos_;
+        while (pos_ < text_.size() && is_digit(text_[pos_])) ++pos_;
+        if (pos_ < text_.size() && text_[pos_] == '.') {
+            ++pos_;
+            while (pos_ < text_.size() && is_digit(text_[pos_])) ++pos_;
+        }
+        if (pos_ < text_.size() && (text_[pos_] == 'e' || text_[pos_] == 'E')) {
+            ++pos_;
+            if (pos_ < text_.size() && (text_[pos_] == '+' || text_[pos_] == '-')) ++pos_;
+            while (pos_ < text_.size() && is_digit(text_[pos_])) ++pos_;
+        }
+        double number = 0.0;
+        auto result = std::from_chars(text_.data() + start, text_.data() + pos_, number);
+        if (result.ec != std::errc() || result.ptr != text_.data() + pos_) {
+            throw std::runtime_error("Invalid JSON number");
+        }
+        return number;
+    }
+
+    std::string_view parse_string() {
+        ++pos_;  // opening quote
+        const std::size_t start = pos_;
+        while (pos_ < text_.size()) {
+            char ch = text_[pos_];
+            if (ch == '"') {
+                return text_.substr(start, pos_++ - start);
+            }
+            if (ch == '\\') {
+                return unescape_string(start);
+            }
+            ++pos_;
+        }
+        throw std::runtime_error("Unterminated string literal");
+    }
+
+    // Slow path for strings with escapes. Decoded text is never longer than
+    // the raw literal, so the literal's extent is found first and sized once.
+    std::string_view unescape_string(std::size_t start) {
+        std::size_t end = pos_;
+        while (end < text_.size() && text_[end] != '"') {
+            end += text_[end] == '\\' ? 2 : 1;
+        }
+        std::size_t prefix = pos_ - start;
+        char* out = arena_.allocate_array<char>(std::min(end, text_.size()) - start);
+        std::memcpy(out, text_.data() + start, prefix);
+        char* p = out + prefix;
+        while (pos_ < text_.size()) {
+            char ch = text_[pos_++];
+            if (ch == '"') {
+                return std::string_view(out, static_cast<std::size_t>(p - out));
+            }
+            if (ch != '\\') {
+                *p++ = ch;
+                continue;
+            }
+            if (pos_ >= text_.size()) {
+                throw std::runtime_error("Invalid escape sequence");
+            }
+            char esc = text_[pos_++];
+            switch (esc) {
+                case '"': *p++ = '"'; break;
+                case '\\': *p++ = '\\'; break;
+                case '/': *p++ = '/'; break;
+                case 'b': *p++ = '\b'; break;
+                case 'f': *p++ = '\f'; break;
+                case 'n': *p++ = '\n'; break;
+                case 'r': *p++ = '\r'; break;
+                case 't': *p++ = '\t'; break;
+                case 'u': {
+                    if (text_.size() - pos_ < 4) throw std::runtime_error("Invalid unicode escape");
+                    unsigned code = 0;
+                    for (int i = 0; i < 4; ++i) {
+                        int digit = hex_digit(text_[pos_++]);
+                        if (digit < 0) throw std::runtime_error("Invalid unicode escape");
+                        code = (code << 4) | static_cast<unsigned>(digit);
+                    }
+                    // "\uXXXX" is six input bytes, at most three output bytes.
+                    if (code < 0x80) {
+                        *p++ = static_cast<char>(code);
+                    } else if (code < 0x800) {
+                        *p++ = static_cast<char>(0xC0 | ((code >> 6) & 0x1F));
+                        *p++ = static_cast<char>(0x80 | (code & 0x3F));
+                    } else {
+                        *p++ = static_cast<char>(0xE0 | ((code >> 12) & 0x0F));
+                        *p++ = static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+                        *p++ = static_cast<char>(0x80 | (code & 0x3F));
+                    }
+                    break;
+                }
+                default:
+                    throw std::runtime_error("Unknown escape sequence");
+            }
+        }
+        throw std::runtime_error("Unterminated string literal");
+    }
+
+    ViewValue parse_array(std::size_t depth) {
+        check_depth(depth);
+        ++pos_;
+        const std::size_t base = items_.size();
+        skip_ws();
+        if (pos_ < text_.size() && text_[pos_] == ']') {
+            ++pos_;
+        } else {
+            while (true) {
+                ViewValue item = parse_value(depth);
+                items_.push_back(item);
+                skip_ws();
+                if (pos_ < text_.size() && text_[pos_] == ',') {
+                    ++pos_;
+                    continue;
+                }
+                if (pos_ < text_.size() && text_[pos_] == ']') {
+                    ++pos_;
+                    break;
+                }
+                throw std::runtime_error("Expected ',' or ']'");
+            }
+        }
+        ViewValue value;
+        value.type_ = ViewValue::Type::Array;
+        value.size_ = items_.size() - base;
+        value.items_ = commit(items_, base);
+        return value;
+    }
+
+    ViewValue parse_object(std::size_t depth) {
+        check_depth(depth);
+        ++pos_;
+        const std::size_t base = members_.size();
+        skip_ws();
+        if (pos_ < text_.size() && text_[pos_] == '}') {
+            ++pos_;
+        } else {
+            while (true) {
+                skip_ws();
+                if (pos_ >= text_.size() || text_[pos_] != '"') {
+                    throw std::runtime_error("Expected string key");
+                }
+                ViewMember member;
+                member.key = parse_string();
+                skip_ws();
+                if (pos_ >= text_.size() || text_[pos_] != ':') {
+                    throw std::runtime_error("Unexpected character in JSON input");
+                }
+                ++pos_;
+                member.value = parse_value(depth);
+                members_.push_back(member);
+                skip_ws();
+                if (pos_ < text_.size() && text_[pos_] == ',') {
+                    ++pos_;
+                    continue;
+                }
+                if (pos_ < text_.size() && text_[pos_] == '}') {
+                    ++pos_;
+                    break;
+                }
+                throw std::runtime_error("Expected ',' or '}' in object");
+            }
+        }
+        ViewValue value;
+        value.type_ = ViewValue::Type::Object;
+        value.size_ = members_.size() - base;
+        value.members_ = commit(members_, base);
+        return value;
+    }
+
+    template <typename T>
+    const T* commit(std::vector<T>& stack, std::size_t base) {
+        std::size_t count = stack.size() - base;
+        if (count == 0) return nullptr;
+        T* out = arena_.allocate_array<T>(count);
+        std::copy(stack.begin() + static_cast<std::ptrdiff_t>(base), stack.end(), out);
+        stack.resize(base);
+        return out;
+    }
+
+    void check_depth(std::size_t depth) const {
+        if (depth > kMaxDepth) {
+            throw std::runtime_error("JSON nesting too deep");
+        }
+    }
+
+    void skip_ws() {
+        while (pos_ < text_.size() && is_space(text_[pos_])) ++pos_;
+    }
+
+    void expect(std::string_view token) {
+        if (text_.compare(pos_, token.size(), token) != 0) {
+            throw std::runtime_error("Unexpected token in JSON input");
+        }
+        pos_ += token.size();
+    }
+
+    std::string_view text_;
+    Arena& arena_;
+    std::size_t pos_ = 0;
+    std::vector<ViewValue> items_;
+    std::vector<ViewMember> members_;
+};
+
+ViewRange<ViewValue> ViewValue::items() const {
+    return is_array() ? ViewRange<ViewValue>{items_, size_} : ViewRange<ViewValue>{};
+}
+
+ViewRange<ViewMember> ViewValue::members() const {
+    return is_object() ? ViewRange<ViewMember>{members_, size_} : ViewRange<ViewMember>{};
+}
+
+const ViewValue* ViewValue::find(std::string_view key) const {
+    for (const auto& member : members()) {
+        if (member.key == key) return &member.value;
+    }
+    return nullptr;
+}
+
+Value ViewValue::to_value() const {
+    switch (type_) {
+        case Type::Bool:
+            return Value(boolean_);
+        case Type::Number:
+            return Value(number_);
+        case Type::String:
+            return Value(std::string(text_, size_));
+        case Type::Array: {
+            Value::Array arr;
+            arr.reserve(size_);
+            for (const auto& item : items()) {
+                arr.push_back(item.to_value());
+            }
+            return Value(std::move(arr));
+        }
+        case Type::Object: {
+            Value::Object obj;
+            for (const auto& member : members()) {
+                obj.emplace(std::string(member.key), member.value.to_value());
+            }
+            return Value(std::move(obj));
+        }
+        case Type::Null:
+            break;
+    }
+    return Value(nullptr);
+}
+
+Document Document::parse(std::string_view text) {
+    // Node arrays come to about twice the input size for typical files.
+    Document doc(std::clamp<std::size_t>(text.size() * 2, 4 * 1024, 4 * 1024 * 1024));
+    ViewParser parser(text, doc.arena_);
+    doc.root_ = parser.parse_document();
+    return doc;
+}
+
+}  // namespace mini_json
@@ -0,0 +1,174 @@
+#include "utils/json_writer.hpp"
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <cerrno>
+#include <unistd.h>
+#endif
+
+#include <stdexcept>
+
+#include "utils/json.hpp"
+
+namespace mini_json {
+
+namespace {
+constexpr std::size_t kFlushThreshold = 64 * 1024;
+constexpr char kHexDigits[] = "0123456789abcdef";
+}
+
+Writer::Writer(std::string& out, int indent) : out_(&out), indent_(indent) {}
+
+Writer::Writer(int fd, int indent) : out_(&buffer_), fd_(fd), indent_(indent) {
+    buffer_.reserve(kFlushThreshold + 1024);
+}
+
+Writer::~Writer() { flush(); }
+
+Writer& Writer::begin_object() { return open('{', true); }
+Writer& Writer::end_object() { return close('}', true); }
+Writer& Writer::begin_array() { return open('[', false); }
+Writer& Writer::end_array() { return close(']', false); }
+
+Writer& Writer::key(std::string_view name) {
+    if (stack_.empty() || !stack_.back().object || stack_.back().after_key) {
+        throw std::runtime_error("JSON writer: key outside of an object");
+    }
+    Frame& frame = stack_.back();
+    if (frame.count++ > 0) out_->push_back(',');
+    newline();
+    append_escaped(name);
+    out_->push_back(':');
+    if (indent_ > 0) out_->push_back(' ');
+    frame.after_key = true;
+    return *this;
+}
+
+Writer& Writer::null() {
+    begin_value();
+    out_->append("null");
+    return end_value();
+}
+
+Writer& Writer::value(bool flag) {
+    begin_value();
+    out_->append(flag ? "true" : "false");
+    return end_value();
+}
+
+Writer& Writer::value(double number) {
+    begin_value();
+    // Same text as ostream's default formatting (%g, precision 6).
+    char buf[32];
+    auto result = std::to_chars(buf, buf + sizeof(buf), number, std::chars_format::general, 6);
+    out_->append(buf, result.ptr);
+    return end_value();
+}
+
+Writer& Writer::value(std::string_view text) {
+    begin_value();
+    append_escaped(text);
+    return end_value();
+}
+
+Writer& Writer::value(const Value& tree) {
+    tree.write(*this);
+    return *this;
+}
+
+bool Writer::flush() {
+    if (fd_ < 0 || buffer_.empty()) return ok_;
+    const char* data = buffer_.data();
+    std::size_t left = buffer_.size();
+    while (ok_ && left > 0) {
+#ifdef _WIN32
+        int written = ::_write(fd_, data, static_cast<unsigned int>(left));
+#else
+        ssize_t written = ::write(fd_, data, left);
+        if (written < 0 && errno == EINTR) continue;
+#endif
+        if (written <= 0) {
+            ok_ = false;
+            break;
+        }
+        data += written;
+        left -= static_cast<std::size_t>(written);
+    }
+    buffer_.clear();
+    return ok_;
+}
+
+void Writer::begin_value() {
+    if (stack_.empty()) {
+        if (root_done_) throw std::runtime_error("JSON writer: more than one root value");
+        return;
+    }
+    Frame& frame = stack_.back();
+    if (frame.object) {
+        if (!frame.after_key) throw std::runtime_error("JSON writer: object member without a key");
+        frame.after_key = false;
+        return;
+    }
+    if (frame.count++ > 0) out_->push_back(',');
+    newline();
+}
+
+Writer& Writer::end_value() {
+    if (stack_.empty()) root_done_ = true;
+    if (fd_ >= 0 && buffer_.size() >= kFlushThreshold) flush();
+    return *this;
+}
+
+Writer& Writer::open(char bracket, bool object) {
+    begin_value();
+    out_->push_back(bracket);
+    stack_.push_back(Frame{object, false, 0});
+    return *this;
+}
+
+Writer& Writer::close(char bracket, bool object) {
+    if (stack_.empty() || stack_.back().object != object || stack_.back().after_key) {
+        throw std::runtime_error("JSON writer: unbalanced end of container");
+    }
+    if (stack_.back().count > 0 && indent_ > 0) out_->push_back('\n');
+    out_->push_back(bracket);
+    stack_.pop_back();
+    return end_value();
+}
+
+// Members sit on their own line, indented by the nesting level of the
+// container that holds them; the closing bracket starts a bare line.
+void Writer::newline() {
+    if (indent_ <= 0) return;
+    out_->push_back('\n');
+    out_->append((stack_.size() - 1) * static_cast<std::size_t>(indent_), ' ');
+}
+
+void Writer::append_escaped(std::string_view text) {
+    out_->push_back('"');
+    std::size_t run = 0;
+    for (std::size_t i = 0; i < text.size(); ++i) {
+        auto ch = static_cast<unsigned char>(text[i]);
+        if (ch >= 0x20 && ch != '"' && ch != '\\') continue;
+        out_->append(text.data() + run, i - run);
+        run = i + 1;
+        switch (ch) {
+            case '\\': out_->append("\\\\"); break;
+            case '"': out_->append("\\\""); break;
+            case '\b': out_->append("\\b"); break;
+            case '\f': out_->append("\\f"); break;
+            case '\n': out_->append("\\n"); break;
+            case '\r': out_->append("\\r"); break;
+            case '\t': out_->append("\\t"); break;
+            default: {
+                const char escape[] = {'\\', 'u', '0', '0', kHexDigits[ch >> 4], kHexDigits[ch & 0x0f]};
+                out_->append(escape, sizeof(escape));
+            }
+        }
+    }
+    out_->append(text.data() + run, text.size() - run);
+    out_->push_back('"');
+}
+
+}  // namespace mini_json
@@ -0,0 +1,92 @@
+#include "utils/latency_histogram.hpp"
+
+#include <limits>
+
+namespace metrics {
+
+namespace {
+int highest_bit(std::uint64_t value) {
+    int bit = 0;
+    while (value >>= 1) ++bit;
+    return bit;
+}
+}
+
+std::size_t LatencyHistogram::bucket_index(std::uint64_t value) {
+    if (value < kSubBuckets) {
+        return static_cast<std::size_t>(value);
+    }
+    int exponent = highest_bit(value);
+    std::size_t sub = static_cast<std::size_t>((value >> (exponent - 4)) & (kSubBuckets - 1));
+    return kSubBuckets + static_cast<std::size_t>(exponent - 4) * kSubBuckets + sub;
+}
+
+std::uint64_t LatencyHistogram::bucket_lower_bound(std::size_t index) {
+    if (index < kSubBuckets) {
+        return index;
+    }
+    std::size_t exponent = (index - kSubBuckets) / kSubBuckets + 4;
+    std::uint64_t sub = (index - kSubBuckets) % kSubBuckets;
+    return (kSubBuckets + sub) << (exponent - 4);
+}
+
+std::uint64_t LatencyHistogram::bucket_upper_bound(std::size_t index) {
+    if (index + 1 >= kBucketCount) {
+        return std::numeric_limits<std::uint64_t>::max();
+    }
+    return bucket_lower_bound(index + 1) - 1;
+}
+
+void LatencyHistogram::record(std::uint64_t value_ns) {
+    buckets_[bucket_index(value_ns)].fetch_add(1, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+    sum_.fetch_add(value_ns, std::memory_order_relaxed);
+    std::uint64_t prev = max_.load(std::memory_order_relaxed);
+    while (value_ns > prev && !max_.compare_exchange_weak(prev, value_ns, std::memory_order_relaxed)) {
+    }
+}
+
+void LatencyHistogram::reset() {
+    for (auto& bucket : buckets_) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    count_.store(0, std::memory_order_relaxed);
+    sum_.store(0, std::memory_order_relaxed);
+    max_.store(0, std::memory_order_relaxed);
+}
+
+LatencyHistogram::Snapshot LatencyHistogram::snapshot() const {
+    Snapshot snap;
+    std::uint64_t total = 0;
+    for (std::size_t i = 0; i < kBucketCount; ++i) {
+        snap.counts[i] = buckets_[i].load(std::memory_order_relaxed);
+        total += snap.counts[i];
+    }
+    // Derive the count from the buckets so percentiles stay self-consistent
+    // even while writers are active.
+    snap.count = total;
+    snap.sum = sum_.load(std::memory_order_relaxed);
+    snap.max = max_.load(std::memory_order_relaxed);
+    return snap;
+}
+
+std::uint64_t LatencyHistogram::Snapshot::percentile(double q) const {
+    if (count == 0) return 0;
+    if (q <= 0.0) q = 0.0;
+    if (q >= 1.0) return max;
+    auto rank = static_cast<std::uint64_t>(q * static_cast<double>(count));
+    if (rank >= count) rank = count - 1;
+    std::uint64_t seen = 0;
+    for (std::size_t i = 0; i < kBucketCount; ++i) {
+        seen += counts[i];
+        if (seen > rank) {
+            std::uint64_t lower = bucket_lower_bound(i);
+            std::uint64_t upper = bucket_upper_bound(i);
+            std::uint64_t mid = lower + (upper - lower) / 2;
+            return max != 0 && mid > max ? max : mid;
+        }
+    }
+    return max;
+}
+
+}  // namespace metrics
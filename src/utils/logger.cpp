@@ -1,50 +1,115 @@
 #include "utils/logger.hpp"
 
-#include <ctime>
-#include <iomanip>
+#include "utils/async_log_writer.hpp"
+
 #include <iostream>
 
+#include "utils/metrics.hpp"
+#include "utils/timestamp.hpp"
+
 namespace logging {
 
 namespace {
-std::string timestamp() {
-    auto now = std::chrono::system_clock::now();
-    auto tt = std::chrono::system_clock::to_time_t(now);
-    std::tm tm{};
-#ifdef _WIN32
-    localtime_s(&tm, &tt);
-#else
-    localtime_r(&tt, &tm);
-#endif
-    std::ostringstream oss;
-    oss << std::put_time(&tm, "%Y-%m-%d %H:%M:%S");
-    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()) % 1000;
-    oss << '.' << std::setfill('0') << std::setw(3) << ms.count();
-    return oss.str();
+std::atomic<RateLimiter*> g_limited_sites{nullptr};
+
+metrics::Counter& message_counter(Level level) {
+    static metrics::Counter* const counters[] = {
+        &metrics::default_registry().counter("log_messages", "Log messages emitted", {{"level", "debug"}}),
+        &metrics::default_registry().counter("log_messages", "Log messages emitted", {{"level", "info"}}),
+        &metrics::default_registry().counter("log_messages", "Log messages emitted", {{"level", "warning"}}),
+        &metrics::default_registry().counter("log_messages", "Log messages emitted", {{"level", "error"}}),
+    };
+    return *counters[static_cast<int>(level)];
 }
 }
 
 Logger::Logger(std::string name) : name_(std::move(name)) {}
 
-void Logger::set_level(Level level) { level_ = level; }
-Level Logger::level() const { return level_; }
+Logger::~Logger() { stop_async(); }
+
+void Logger::start_async(const AsyncOptions& options) {
+    std::lock_guard<std::mutex> lock(async_mutex_);
+    if (async_.load(std::memory_order_acquire)) return;
+    // A stopped writer may still be referenced by a log() call that loaded
+    // it just before stop_async(), so it is parked rather than freed.
+    if (async_writer_) retired_writers_.push_back(std::move(async_writer_));
+    async_writer_ = std::make_unique<AsyncLogWriter>(name_, options);
+    async_writer_->start();
+    async_.store(async_writer_.get(), std::memory_order_release);
+    AsyncLogWriter* writer = async_writer_.get();
+    queue_depth_.reset();  // still bound to the previous writer after a restart
+    queue_depth_ = metrics::default_registry().observe(
+        "log_queue_depth", "Records waiting in the async log queue", {{"logger", name_}}, metrics::MetricType::Gauge,
+        [writer] { return static_cast<double>(writer->queue_depth()); });
+}
+
+void Logger::stop_async() {
+    std::lock_guard<std::mutex> lock(async_mutex_);
+    AsyncLogWriter* writer = async_.exchange(nullptr, std::memory_order_acq_rel);
+    if (writer) {
+        // The writer object stays alive until the Logger is destroyed so a
+        // racing log() call never touches freed memory.
+        writer->stop();
+    }
+}
+
+bool Logger::is_async() const { return async_.load(std::memory_order_acquire) != nullptr; }
+
+std::size_t Logger::dropped_records() const {
+    std::lock_guard<std::mutex> lock(async_mutex_);
+    std::size_t dropped = async_writer_ ? async_writer_->dropped() : 0;
+    for (const auto& writer : retired_writers_) dropped += writer->dropped();
+    return dropped;
+}
+
+void Logger::set_level(Level level) { level_.store(level, std::memory_order_relaxed); }
+Level Logger::level() const { return level_.load(std::memory_order_relaxed); }
 
 void Logger::debug(const std::string& message) { log(Level::Debug, message); }
 void Logger::info(const std::string& message) { log(Level::Info, message); }
 void Logger::warn(const std::string& message) { log(Level::Warning, message); }
 void Logger::error(const std::string& message) { log(Level::Error, message); }
 
-void Logger::log(Level level, const std::string& message) {
-    if (level < level_) {
+void Logger::log(Level level, std::string_view message) {
+    if (!enabled(level)) {
         return;
     }
+    message_counter(level).add();
+    if (AsyncLogWriter* writer = async_.load(std::memory_order_acquire)) {
+        writer->push(level, message);
+        return;
+    }
+    char ts[timestamp::kMaxLength];
+    std::size_t ts_len = timestamp::format_local(ts, std::chrono::system_clock::now());
     std::lock_guard<std::mutex> lock(mutex_);
-    std::cout << '[' << timestamp() << "] [" << level_to_string(level) << "] "
+    std::cout << '[' << std::string_view(ts, ts_len) << "] [" << level_to_string(level) << "] "
               << name_ << ": " << message << std::endl;
 }
 
-void Logger::format_impl(std::ostringstream& oss, const std::string& fmt) {
-    oss << fmt;
+std::string format_timestamp(std::chrono::system_clock::time_point time) {
+    return timestamp::local_string(time);
+}
+
+void RateLimiter::register_site(Logger* logger, Level level, std::string_view fmt) {
+    bool expected = false;
+    if (!registered_.compare_exchange_strong(expected, true, std::memory_order_relaxed)) return;
+    logger_ = logger;
+    level_ = level;
+    fmt_ = fmt;
+    next_ = g_limited_sites.load(std::memory_order_relaxed);
+    while (!g_limited_sites.compare_exchange_weak(next_, this, std::memory_order_release, std::memory_order_relaxed)) {
+    }
+}
+
+void report_suppressed() {
+    for (RateLimiter* site = g_limited_sites.load(std::memory_order_acquire); site; site = site->next_) {
+        std::uint64_t suppressed = 0;
+        if (site->pending_suppressed() == 0 || !site->allow(suppressed) || suppressed == 0) continue;
+        std::string& buffer = detail::format_buffer();
+        buffer.clear();
+        detail::format_to(buffer, "suppressed {} similar messages: {}", suppressed, site->fmt_);
+        site->logger_->log(site->level_, buffer);
+    }
 }
 
 std::string level_to_string(Level level) {
@@ -0,0 +1,160 @@
+#include "utils/metrics.hpp"
+
+#include <stdexcept>
+
+namespace metrics {
+
+namespace {
+
+// Sort key: the name, then each label pair. '\x01' and '\x02' sort below any
+// printable character, so "a" < "a{...}" < "a_b".
+std::string entry_key(std::string_view name, const Labels& labels) {
+    std::string key(name);
+    for (const auto& [label, value] : labels) {
+        key += '\x01';
+        key += label;
+        key += '\x02';
+        key += value;
+    }
+    return key;
+}
+
+}  // namespace
+
+const ScalarSample* RegistrySnapshot::find(std::string_view name, const Labels& labels) const {
+    for (const auto& sample : scalars) {
+        if (sample.name == name && sample.labels == labels) return &sample;
+    }
+    return nullptr;
+}
+
+const HistogramSample* RegistrySnapshot::find_histogram(std::string_view name, const Labels& labels) const {
+    for (const auto& sample : histograms) {
+        if (sample.name == name && sample.labels == labels) return &sample;
+    }
+    return nullptr;
+}
+
+double RegistrySnapshot::value(std::string_view name, const Labels& labels, double fallback) const {
+    const ScalarSample* sample = find(name, labels);
+    return sample ? sample->value : fallback;
+}
+
+ObserverHandle::ObserverHandle(ObserverHandle&& other) noexcept
+    : registry_(std::exchange(other.registry_, nullptr)), key_(std::move(other.key_)) {}
+
+ObserverHandle& ObserverHandle::operator=(ObserverHandle&& other) noexcept {
+    if (this != &other) {
+        reset();
+        registry_ = std::exchange(other.registry_, nullptr);
+        key_ = std::move(other.key_);
+    }
+    return *this;
+}
+
+void ObserverHandle::reset() {
+    if (registry_) {
+        registry_->remove(key_);
+        registry_ = nullptr;
+    }
+}
+
+Counter& Registry::counter(std::string_view name, std::string_view help, Labels labels) {
+    return *entry(name, help, std::move(labels), MetricType::Counter).counter;
+}
+
+Gauge& Registry::gauge(std::string_view name, std::string_view help, Labels labels) {
+    return *entry(name, help, std::move(labels), MetricType::Gauge).gauge;
+}
+
+LatencyHistogram& Registry::histogram(std::string_view name, std::string_view help, Labels labels) {
+    return *entry(name, help, std::move(labels), MetricType::Histogram).histogram;
+}
+
+ObserverHandle Registry::observe(std::string_view name, std::string_view help, Labels labels, MetricType type,
+                                 std::function<double()> read) {
+    if (type == MetricType::Histogram) {
+        throw std::invalid_argument("metric '" + std::string(name) + "': histograms cannot be observed");
+    }
+    std::string key = entry_key(name, labels);
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (entries_.count(key)) {
+        throw std::invalid_argument("metric '" + std::string(name) + "' is already registered");
+    }
+    Entry& created = entries_[key];
+    created.name = std::string(name);
+    created.help = std::string(help);
+    created.labels = std::move(labels);
+    created.type = type;
+    created.read = std::move(read);
+    return ObserverHandle(this, std::move(key));
+}
+
+void Registry::remove(const std::string& key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.erase(key);
+}
+
+Registry::Entry& Registry::entry(std::string_view name, std::string_view help, Labels labels, MetricType type) {
+    std::string key = entry_key(name, labels);
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(key);
+    if (it != entries_.end()) {
+        if (it->second.type != type || it->second.read) {
+            throw std::invalid_argument("metric '" + std::string(name) + "' already registered with another type");
+        }
+        return it->second;
+    }
+    Entry& created = entries_[std::move(key)];
+    created.name = std::string(name);
+    created.help = std::string(help);
+    created.labels = std::move(labels);
+    created.type = type;
+    switch (type) {
+        case MetricType::Counter:
+            created.counter = std::make_unique<Counter>();
+            break;
+        case MetricType::Gauge:
+            created.gauge = std::make_unique<Gauge>();
+            break;
+        case MetricType::Histogram:
+            created.histogram = std::make_unique<LatencyHistogram>();
+            break;
+    }
+    return created;
+}
+
+RegistrySnapshot Registry::snapshot() const {
+    RegistrySnapshot snap;
+    std::lock_guard<std::mutex> lock(mutex_);
+    snap.taken_at = std::chrono::system_clock::now();
+    snap.scalars.reserve(entries_.size());
+    for (const auto& [key, entry] : entries_) {
+        if (entry.read) {
+            snap.scalars.push_back(ScalarSample{entry.name, entry.help, entry.labels, entry.type, entry.read()});
+            continue;
+        }
+        switch (entry.type) {
+            case MetricType::Counter:
+                snap.scalars.push_back(ScalarSample{entry.name, entry.help, entry.labels, entry.type,
+                                                    static_cast<double>(entry.counter->value())});
+                break;
+            case MetricType::Gauge:
+                snap.scalars.push_back(ScalarSample{entry.name, entry.help, entry.labels, entry.type,
+                                                    static_cast<double>(entry.gauge->value())});
+                break;
+            case MetricType::Histogram:
+                snap.histograms.push_back(HistogramSample{entry.name, entry.help, entry.labels,
+                                                          entry.histogram->snapshot()});
+                break;
+        }
+    }
+    return snap;
+}
+
+Registry& default_registry() {
+    static Registry registry;
+    return registry;
+}
+
+}  // namespace metrics
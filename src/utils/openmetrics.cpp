@@ -0,0 +1,167 @@
+#include "utils/openmetrics.hpp"
+
+#include <charconv>
+#include <cmath>
+#include <string_view>
+
+namespace metrics {
+
+namespace {
+
+void append_number(std::string& out, double value) {
+    if (std::isnan(value)) {
+        out += "NaN";
+        return;
+    }
+    if (std::isinf(value)) {
+        out += value > 0 ? "+Inf" : "-Inf";
+        return;
+    }
+    char buf[32];
+    auto result = std::to_chars(buf, buf + sizeof(buf), value);
+    out.append(buf, result.ptr);
+}
+
+void append_integer(std::string& out, std::uint64_t value) {
+    char buf[24];
+    auto result = std::to_chars(buf, buf + sizeof(buf), value);
+    out.append(buf, result.ptr);
+}
+
+// Label values and HELP text escape backslash, double quote and newline.
+void append_escaped(std::string& out, std::string_view text) {
+    for (char ch : text) {
+        switch (ch) {
+            case '\\': out += "\\\\"; break;
+            case '"': out += "\\\""; break;
+            case '\n': out += "\\n"; break;
+            default: out += ch;
+        }
+    }
+}
+
+// `{a="1",b="2"}` including an optional trailing `le` label.
+void append_labels(std::string& out, const Labels& labels, std::string_view le = {}) {
+    if (labels.empty() && le.empty()) return;
+    out += '{';
+    bool first = true;
+    for (const auto& [name, value] : labels) {
+        if (!first) out += ',';
+        first = false;
+        out += name;
+        out += "=\"";
+        append_escaped(out, value);
+        out += '"';
+    }
+    if (!le.empty()) {
+        if (!first) out += ',';
+        out += "le=\"";
+        out += le;
+        out += '"';
+    }
+    out += '}';
+}
+
+void append_family(std::string& out, std::string_view name, std::string_view type, std::string_view help,
+                   std::string_view unit = {}) {
+    out += "# TYPE ";
+    out += name;
+    out += ' ';
+    out += type;
+    out += '\n';
+    if (!unit.empty()) {
+        out += "# UNIT ";
+        out += name;
+        out += ' ';
+        out += unit;
+        out += '\n';
+    }
+    if (!help.empty()) {
+        out += "# HELP ";
+        out += name;
+        out += ' ';
+        append_escaped(out, help);
+        out += '\n';
+    }
+}
+
+// Exported `le` ladder: one bucket per power of two (the 16 log-linear
+// sub-buckets of each octave folded together) up to 2^36 ns (~69 s). Every
+// scrape emits the same series; slower samples only show up in +Inf.
+constexpr std::size_t kLadderOctaves = 33;
+
+void append_histogram(std::string& out, const HistogramSample& sample, const std::string& family) {
+    const auto& data = sample.data;
+    constexpr std::size_t kSub = LatencyHistogram::kSubBuckets;
+    static_assert(kLadderOctaves * kSub < LatencyHistogram::kBucketCount, "ladder must stop below +Inf");
+    char le[32];
+    std::uint64_t cumulative = 0;
+    std::size_t index = 0;
+    for (std::size_t octave = 0; octave < kLadderOctaves; ++octave) {
+        const std::size_t end = (octave + 1) * kSub;
+        for (; index < end; ++index) cumulative += data.counts[index];
+        double upper = static_cast<double>(LatencyHistogram::bucket_upper_bound(end - 1)) / 1e9;
+        auto last = std::to_chars(le, le + sizeof(le), upper).ptr;
+        out += family;
+        out += "_bucket";
+        append_labels(out, sample.labels, std::string_view(le, static_cast<std::size_t>(last - le)));
+        out += ' ';
+        append_integer(out, cumulative);
+        out += '\n';
+    }
+    out += family;
+    out += "_bucket";
+    append_labels(out, sample.labels, "+Inf");
+    out += ' ';
+    append_integer(out, data.count);
+    out += '\n';
+
+    out += family;
+    out += "_count";
+    append_labels(out, sample.labels);
+    out += ' ';
+    append_integer(out, data.count);
+    out += '\n';
+
+    out += family;
+    out += "_sum";
+    append_labels(out, sample.labels);
+    out += ' ';
+    append_number(out, static_cast<double>(data.sum) / 1e9);
+    out += '\n';
+}
+
+}  // namespace
+
+void render_openmetrics(const RegistrySnapshot& snapshot, std::string& out) {
+    // Samples arrive sorted by name, so a family header is written whenever
+    // the name changes.
+    const std::string* previous = nullptr;
+    for (const auto& sample : snapshot.scalars) {
+        const bool counter = sample.type == MetricType::Counter;
+        if (!previous || *previous != sample.name) {
+            append_family(out, sample.name, counter ? "counter" : "gauge", sample.help);
+            previous = &sample.name;
+        }
+        out += sample.name;
+        if (counter) out += "_total";
+        append_labels(out, sample.labels);
+        out += ' ';
+        append_number(out, sample.value);
+        out += '\n';
+    }
+
+    std::string family;
+    previous = nullptr;
+    for (const auto& sample : snapshot.histograms) {
+        if (!previous || *previous != sample.name) {
+            family = sample.name + "_seconds";
+            append_family(out, family, "histogram", sample.help, "seconds");
+            previous = &sample.name;
+        }
+        append_histogram(out, sample, family);
+    }
+    out += "# EOF\n";
+}
+
+}  // namespace metrics
@@ -1,6 +1,8 @@
 #include "utils/settings.hpp"
 
+#include <algorithm>
 #include <cerrno>
+#include <cmath>
 #include <csignal>
 #include <cstdlib>
 #include <filesystem>
@@ -8,8 +10,11 @@
 #include <iostream>
 #include <stdexcept>
 #include <system_error>
+#include <tuple>
 #include <iterator>
 
+#include "utils/json_writer.hpp"
+
 namespace fs = std::filesystem;
 
 namespace settings {
@@ -26,64 +31,146 @@ std::string safe_env(const char* name) {
     return value ? std::string(value) : std::string();
 }
 
-mini_json::Value::Object object_or(const mini_json::Value& value) {
-    if (value.is_object()) {
-        return value.as_object();
+const mini_json::Value::Object& object_or_empty(const mini_json::Value::Object& parent, const char* key) {
+    static const mini_json::Value::Object empty;
+    auto it = parent.find(key);
+    if (it != parent.end() && it->second.is_object()) {
+        return it->second.as_object();
     }
-    return {};
+    return empty;
 }
 
 std::string join_path(const std::string& a, const std::string& b) {
     return (fs::path(a) / b).string();
 }
 
+// A misspelt policy falls back loudly rather than quietly acting as the default.
+std::string drop_policy_or(const mini_json::Value::Object& relay, const char* key, const std::string& fallback) {
+    if (!relay.count(key)) return fallback;
+    std::string policy = relay.at(key).as_string(fallback);
+    if (policy == "drop_oldest" || policy == "drop_newest") return policy;
+    std::cerr << "config.json: relay." << key << " \"" << policy
+              << "\" is not drop_oldest or drop_newest; using " << fallback << std::endl;
+    return fallback;
+}
+
+// Queue lengths are clamped loudly too; casting an arbitrary JSON number
+// straight to int would be undefined for out-of-range values.
+int queue_length_or(const mini_json::Value::Object& relay, const char* key, int fallback) {
+    if (!relay.count(key)) return fallback;
+    double length = relay.at(key).as_number(fallback);
+    if (std::isnan(length)) length = fallback;
+    double clamped = std::clamp(length, 0.0, static_cast<double>(RelaySettings::kMaxQueue));
+    if (clamped != length) {
+        std::cerr << "config.json: relay." << key << " " << length << " is outside 0.."
+                  << RelaySettings::kMaxQueue << "; using " << clamped << std::endl;
+    }
+    return static_cast<int>(clamped);
+}
+
 }  // namespace
 
+// Keys are written in sorted order, the same order to_json()'s std::map
+// produced when config.json was dumped from a Value tree.
+void AppConfig::write_json(mini_json::Writer& writer) const {
+    writer.begin_object();
+
+    writer.key("bridge").begin_object();
+    writer.member("console_echo", bridge.console_echo);
+    writer.member("image_source_mode", bridge.image_source_mode);
+    writer.member("ip", bridge.ip);
+    writer.member("predefined_dir", bridge.predefined_dir);
+    writer.member("realtime_dir", bridge.realtime_dir);
+    writer.member("show_hud", bridge.show_hud);
+    writer.member("tcp_port", bridge.tcp_port);
+    writer.member("udp_port", bridge.udp_port);
+    writer.end_object();
+
+    writer.member("console_hud", console_hud);
+
+    writer.key("gimbal").begin_object();
+    writer.member("bind_ip", gimbal.bind_ip);
+    writer.member("bind_port", gimbal.bind_port);
+    writer.member("generator_ip", gimbal.generator_ip);
+    writer.member("generator_port", gimbal.generator_port);
+    writer.member("gimbal_control_method", gimbal.control_method);
+    writer.member("max_accel_dps2", gimbal.max_accel_dps2);
+    writer.member("max_rate_dps", gimbal.max_rate_dps);
+    writer.member("max_zoom_accel", gimbal.max_zoom_accel);
+    writer.member("max_zoom_rate", gimbal.max_zoom_rate);
+    writer.member("measure_latency", gimbal.measure_latency);
+    writer.member("packet_format", gimbal.packet_format);
+    writer.member("send_rate_hz", gimbal.send_rate_hz);
+    writer.member("sensor_id", gimbal.sensor_id);
+    writer.member("sensor_type", gimbal.sensor_type);
+    writer.member("show_packets", gimbal.show_packets);
+    writer.end_object();
+
+    writer.member("hud_interval", hud_interval);
+    writer.key("hud_windows").begin_array();
+    for (double window : hud_windows) writer.value(window);
+    writer.end_array();
+
+    writer.key("logging").begin_object();
+    writer.member("async", logging.async);
+    writer.member("file_path", logging.file_path);
+    writer.member("flush_interval_ms", logging.flush_interval_ms);
+    writer.member("max_file_mb", logging.max_file_mb);
+    writer.member("max_files", logging.max_files);
+    writer.member("queue_capacity", logging.queue_capacity);
+    writer.end_object();
+
+    writer.key("metrics").begin_object();
+    writer.member("bind_ip", metrics.bind_ip);
+    writer.member("enable", metrics.enable);
+    writer.member("port", metrics.port);
+    writer.end_object();
+
+    writer.key("relay").begin_object();
+    writer.member("bind_ip", relay.bind_ip);
+    writer.member("bind_port", relay.bind_port);
+    writer.member("enable", relay.enable);
+    writer.member("log_packets", relay.log_packets);
+    writer.member("proc_drop_policy", relay.proc_drop_policy);
+    writer.member("proc_ip", relay.proc_ip);
+    writer.member("proc_port", relay.proc_port);
+    writer.member("proc_queue", relay.proc_queue);
+    writer.member("raw_drop_policy", relay.raw_drop_policy);
+    writer.member("raw_ip", relay.raw_ip);
+    writer.member("raw_port", relay.raw_port);
+    writer.member("raw_queue", relay.raw_queue);
+    writer.end_object();
+
+    writer.key("rover").begin_object();
+    writer.member("enable_logging", rover.enable_logging);
+    writer.member("log_directory", rover.log_directory);
+    writer.end_object();
+
+    auto write_thread = [&writer](const char* key, const ThreadSettings& thread) {
+        writer.key(key).begin_object();
+        writer.member("cpus", thread.cpus);
+        writer.member("priority", thread.priority);
+        writer.end_object();
+    };
+    writer.key("runtime").begin_object();
+    write_thread("gimbal", runtime.gimbal);
+    write_thread("image", runtime.image);
+    writer.member("io_backend", runtime.io_backend);
+    write_thread("logging", runtime.logging);
+    writer.member("loop_threads", runtime.loop_threads);
+    writer.member("mlockall", runtime.mlockall);
+    write_thread("relay", runtime.relay);
+    write_thread("service", runtime.service);
+    writer.end_object();
+
+    writer.end_object();
+}
+
 mini_json::Value AppConfig::to_json() const {
-    mini_json::Value::Object root;
-
-    mini_json::Value::Object bridge_obj;
-    bridge_obj["ip"] = bridge.ip;
-    bridge_obj["tcp_port"] = static_cast<double>(bridge.tcp_port);
-    bridge_obj["udp_port"] = static_cast<double>(bridge.udp_port);
-    bridge_obj["realtime_dir"] = bridge.realtime_dir;
-    bridge_obj["predefined_dir"] = bridge.predefined_dir;
-    bridge_obj["image_source_mode"] = bridge.image_source_mode;
-    bridge_obj["console_echo"] = bridge.console_echo;
-    bridge_obj["show_hud"] = bridge.show_hud;
-
-    mini_json::Value::Object gimbal_obj;
-    gimbal_obj["bind_ip"] = gimbal.bind_ip;
-    gimbal_obj["bind_port"] = static_cast<double>(gimbal.bind_port);
-    gimbal_obj["generator_ip"] = gimbal.generator_ip;
-    gimbal_obj["generator_port"] = static_cast<double>(gimbal.generator_port);
-    gimbal_obj["sensor_type"] = static_cast<double>(gimbal.sensor_type);
-    gimbal_obj["sensor_id"] = static_cast<double>(gimbal.sensor_id);
-    gimbal_obj["gimbal_control_method"] = gimbal.control_method;
-    gimbal_obj["show_packets"] = gimbal.show_packets;
-
-    mini_json::Value::Object relay_obj;
-    relay_obj["bind_ip"] = relay.bind_ip;
-    relay_obj["bind_port"] = static_cast<double>(relay.bind_port);
-    relay_obj["raw_ip"] = relay.raw_ip;
-    relay_obj["raw_port"] = static_cast<double>(relay.raw_port);
-    relay_obj["proc_ip"] = relay.proc_ip;
-    relay_obj["proc_port"] = static_cast<double>(relay.proc_port);
-    relay_obj["enable"] = relay.enable;
-    relay_obj["log_packets"] = relay.log_packets;
-
-    mini_json::Value::Object rover_obj;
-    rover_obj["enable_logging"] = rover.enable_logging;
-    rover_obj["log_directory"] = rover.log_directory;
-
-    root["bridge"] = bridge_obj;
-    root["gimbal"] = gimbal_obj;
-    root["relay"] = relay_obj;
-    root["rover"] = rover_obj;
-    root["console_hud"] = console_hud;
-    root["hud_interval"] = hud_interval;
-
-    return root;
+    std::string text;
+    mini_json::Writer writer(text);
+    write_json(writer);
+    return mini_json::parse(text);
 }
 
 AppConfig AppConfig::from_json(const mini_json::Value& value, const std::string& base_dir) {
@@ -94,60 +181,130 @@ AppConfig AppConfig::from_json(const mini_json::Value& value, const std::string&
     if (!value.is_object()) {
         return cfg;
     }
-    auto root = value.as_object();
+    const auto& root = value.as_object();
 
-    auto bridge_it = root.find("bridge");
-    auto bridge_obj = bridge_it != root.end() ? object_or(bridge_it->second) : mini_json::Value::Object{};
+    const auto& bridge_obj = object_or_empty(root, "bridge");
     if (!bridge_obj.empty()) {
-        if (bridge_obj.count("ip")) cfg.bridge.ip = bridge_obj["ip"].as_string(cfg.bridge.ip);
-        if (bridge_obj.count("tcp_port")) cfg.bridge.tcp_port = static_cast<int>(bridge_obj["tcp_port"].as_number(cfg.bridge.tcp_port));
-        if (bridge_obj.count("udp_port")) cfg.bridge.udp_port = static_cast<int>(bridge_obj["udp_port"].as_number(cfg.bridge.udp_port));
-        if (bridge_obj.count("realtime_dir")) cfg.bridge.realtime_dir = bridge_obj["realtime_dir"].as_string(cfg.bridge.realtime_dir);
-        if (bridge_obj.count("predefined_dir")) cfg.bridge.predefined_dir = bridge_obj["predefined_dir"].as_string(cfg.bridge.predefined_dir);
-        if (bridge_obj.count("image_source_mode")) cfg.bridge.image_source_mode = bridge_obj["image_source_mode"].as_string(cfg.bridge.image_source_mode);
-        if (bridge_obj.count("console_echo")) cfg.bridge.console_echo = bridge_obj["console_echo"].as_bool(cfg.bridge.console_echo);
-        if (bridge_obj.count("show_hud")) cfg.bridge.show_hud = bridge_obj["show_hud"].as_bool(cfg.bridge.show_hud);
-    }
-
-    auto gimbal_it = root.find("gimbal");
-    auto gimbal_obj = gimbal_it != root.end() ? object_or(gimbal_it->second) : mini_json::Value::Object{};
+        if (bridge_obj.count("ip")) cfg.bridge.ip = bridge_obj.at("ip").as_string(cfg.bridge.ip);
+        if (bridge_obj.count("tcp_port")) cfg.bridge.tcp_port = static_cast<int>(bridge_obj.at("tcp_port").as_number(cfg.bridge.tcp_port));
+        if (bridge_obj.count("udp_port")) cfg.bridge.udp_port = static_cast<int>(bridge_obj.at("udp_port").as_number(cfg.bridge.udp_port));
+        if (bridge_obj.count("realtime_dir")) cfg.bridge.realtime_dir = bridge_obj.at("realtime_dir").as_string(cfg.bridge.realtime_dir);
+        if (bridge_obj.count("predefined_dir")) cfg.bridge.predefined_dir = bridge_obj.at("predefined_dir").as_string(cfg.bridge.predefined_dir);
+        if (bridge_obj.count("image_source_mode")) cfg.bridge.image_source_mode = bridge_obj.at("image_source_mode").as_string(cfg.bridge.image_source_mode);
+        if (bridge_obj.count("console_echo")) cfg.bridge.console_echo = bridge_obj.at("console_echo").as_bool(cfg.bridge.console_echo);
+        if (bridge_obj.count("show_hud")) cfg.bridge.show_hud = bridge_obj.at("show_hud").as_bool(cfg.bridge.show_hud);
+    }
+
+    const auto& gimbal_obj = object_or_empty(root, "gimbal");
     if (!gimbal_obj.empty()) {
-        if (gimbal_obj.count("bind_ip")) cfg.gimbal.bind_ip = gimbal_obj["bind_ip"].as_string(cfg.gimbal.bind_ip);
-        if (gimbal_obj.count("bind_port")) cfg.gimbal.bind_port = static_cast<int>(gimbal_obj["bind_port"].as_number(cfg.gimbal.bind_port));
-        if (gimbal_obj.count("generator_ip")) cfg.gimbal.generator_ip = gimbal_obj["generator_ip"].as_string(cfg.gimbal.generator_ip);
-        if (gimbal_obj.count("generator_port")) cfg.gimbal.generator_port = static_cast<int>(gimbal_obj["generator_port"].as_number(cfg.gimbal.generator_port));
-        if (gimbal_obj.count("sensor_type")) cfg.gimbal.sensor_type = static_cast<int>(gimbal_obj["sensor_type"].as_number(cfg.gimbal.sensor_type));
-        if (gimbal_obj.count("sensor_id")) cfg.gimbal.sensor_id = static_cast<int>(gimbal_obj["sensor_id"].as_number(cfg.gimbal.sensor_id));
-        if (gimbal_obj.count("gimbal_control_method")) cfg.gimbal.control_method = gimbal_obj["gimbal_control_method"].as_string(cfg.gimbal.control_method);
-        if (gimbal_obj.count("show_packets")) cfg.gimbal.show_packets = gimbal_obj["show_packets"].as_bool(cfg.gimbal.show_packets);
-    }
-
-    auto relay_it = root.find("relay");
-    auto relay_obj = relay_it != root.end() ? object_or(relay_it->second) : mini_json::Value::Object{};
+        if (gimbal_obj.count("bind_ip")) cfg.gimbal.bind_ip = gimbal_obj.at("bind_ip").as_string(cfg.gimbal.bind_ip);
+        if (gimbal_obj.count("bind_port")) cfg.gimbal.bind_port = static_cast<int>(gimbal_obj.at("bind_port").as_number(cfg.gimbal.bind_port));
+        if (gimbal_obj.count("generator_ip")) cfg.gimbal.generator_ip = gimbal_obj.at("generator_ip").as_string(cfg.gimbal.generator_ip);
+        if (gimbal_obj.count("generator_port")) cfg.gimbal.generator_port = static_cast<int>(gimbal_obj.at("generator_port").as_number(cfg.gimbal.generator_port));
+        if (gimbal_obj.count("sensor_type")) cfg.gimbal.sensor_type = static_cast<int>(gimbal_obj.at("sensor_type").as_number(cfg.gimbal.sensor_type));
+        if (gimbal_obj.count("sensor_id")) cfg.gimbal.sensor_id = static_cast<int>(gimbal_obj.at("sensor_id").as_number(cfg.gimbal.sensor_id));
+        if (gimbal_obj.count("gimbal_control_method")) cfg.gimbal.control_method = gimbal_obj.at("gimbal_control_method").as_string(cfg.gimbal.control_method);
+        if (gimbal_obj.count("show_packets")) cfg.gimbal.show_packets = gimbal_obj.at("show_packets").as_bool(cfg.gimbal.show_packets);
+        if (gimbal_obj.count("packet_format")) cfg.gimbal.packet_format = gimbal_obj.at("packet_format").as_string(cfg.gimbal.packet_format);
+        if (gimbal_obj.count("send_rate_hz")) cfg.gimbal.send_rate_hz = gimbal_obj.at("send_rate_hz").as_number(cfg.gimbal.send_rate_hz);
+        if (gimbal_obj.count("max_rate_dps")) cfg.gimbal.max_rate_dps = gimbal_obj.at("max_rate_dps").as_number(cfg.gimbal.max_rate_dps);
+        if (gimbal_obj.count("max_accel_dps2")) cfg.gimbal.max_accel_dps2 = gimbal_obj.at("max_accel_dps2").as_number(cfg.gimbal.max_accel_dps2);
+        if (gimbal_obj.count("max_zoom_rate")) cfg.gimbal.max_zoom_rate = gimbal_obj.at("max_zoom_rate").as_number(cfg.gimbal.max_zoom_rate);
+        if (gimbal_obj.count("max_zoom_accel")) cfg.gimbal.max_zoom_accel = gimbal_obj.at("max_zoom_accel").as_number(cfg.gimbal.max_zoom_accel);
+        if (gimbal_obj.count("measure_latency")) cfg.gimbal.measure_latency = gimbal_obj.at("measure_latency").as_bool(cfg.gimbal.measure_latency);
+    }
+
+    const auto& relay_obj = object_or_empty(root, "relay");
     if (!relay_obj.empty()) {
-        if (relay_obj.count("bind_ip")) cfg.relay.bind_ip = relay_obj["bind_ip"].as_string(cfg.relay.bind_ip);
-        if (relay_obj.count("bind_port")) cfg.relay.bind_port = static_cast<int>(relay_obj["bind_port"].as_number(cfg.relay.bind_port));
-        if (relay_obj.count("raw_ip")) cfg.relay.raw_ip = relay_obj["raw_ip"].as_string(cfg.relay.raw_ip);
-        if (relay_obj.count("raw_port")) cfg.relay.raw_port = static_cast<int>(relay_obj["raw_port"].as_number(cfg.relay.raw_port));
-        if (relay_obj.count("proc_ip")) cfg.relay.proc_ip = relay_obj["proc_ip"].as_string(cfg.relay.proc_ip);
-        if (relay_obj.count("proc_port")) cfg.relay.proc_port = static_cast<int>(relay_obj["proc_port"].as_number(cfg.relay.proc_port));
-        if (relay_obj.count("enable")) cfg.relay.enable = relay_obj["enable"].as_bool(cfg.relay.enable);
-        if (relay_obj.count("log_packets")) cfg.relay.log_packets = relay_obj["log_packets"].as_bool(cfg.relay.log_packets);
-    }
-
-    auto rover_it = root.find("rover");
-    auto rover_obj = rover_it != root.end() ? object_or(rover_it->second) : mini_json::Value::Object{};
+        if (relay_obj.count("bind_ip")) cfg.relay.bind_ip = relay_obj.at("bind_ip").as_string(cfg.relay.bind_ip);
+        if (relay_obj.count("bind_port")) cfg.relay.bind_port = static_cast<int>(relay_obj.at("bind_port").as_number(cfg.relay.bind_port));
+        if (relay_obj.count("raw_ip")) cfg.relay.raw_ip = relay_obj.at("raw_ip").as_string(cfg.relay.raw_ip);
+        if (relay_obj.count("raw_port")) cfg.relay.raw_port = static_cast<int>(relay_obj.at("raw_port").as_number(cfg.relay.raw_port));
+        if (relay_obj.count("proc_ip")) cfg.relay.proc_ip = relay_obj.at("proc_ip").as_string(cfg.relay.proc_ip);
+        if (relay_obj.count("proc_port")) cfg.relay.proc_port = static_cast<int>(relay_obj.at("proc_port").as_number(cfg.relay.proc_port));
+        if (relay_obj.count("enable")) cfg.relay.enable = relay_obj.at("enable").as_bool(cfg.relay.enable);
+        if (relay_obj.count("log_packets")) cfg.relay.log_packets = relay_obj.at("log_packets").as_bool(cfg.relay.log_packets);
+        cfg.relay.raw_queue = queue_length_or(relay_obj, "raw_queue", cfg.relay.raw_queue);
+        cfg.relay.raw_drop_policy = drop_policy_or(relay_obj, "raw_drop_policy", cfg.relay.raw_drop_policy);
+        cfg.relay.proc_queue = queue_length_or(relay_obj, "proc_queue", cfg.relay.proc_queue);
+        cfg.relay.proc_drop_policy = drop_policy_or(relay_obj, "proc_drop_policy", cfg.relay.proc_drop_policy);
+    }
+
+    const auto& rover_obj = object_or_empty(root, "rover");
     if (!rover_obj.empty()) {
-        if (rover_obj.count("enable_logging")) cfg.rover.enable_logging = rover_obj["enable_logging"].as_bool(cfg.rover.enable_logging);
-        if (rover_obj.count("log_directory")) cfg.rover.log_directory = rover_obj["log_directory"].as_string(cfg.rover.log_directory);
+        if (rover_obj.count("enable_logging")) cfg.rover.enable_logging = rover_obj.at("enable_logging").as_bool(cfg.rover.enable_logging);
+        if (rover_obj.count("log_directory")) cfg.rover.log_directory = rover_obj.at("log_directory").as_string(cfg.rover.log_directory);
+    }
+
+    const auto& logging_obj = object_or_empty(root, "logging");
+    if (!logging_obj.empty()) {
+        if (logging_obj.count("async")) cfg.logging.async = logging_obj.at("async").as_bool(cfg.logging.async);
+        if (logging_obj.count("file_path")) cfg.logging.file_path = logging_obj.at("file_path").as_string(cfg.logging.file_path);
+        if (logging_obj.count("max_file_mb")) cfg.logging.max_file_mb = static_cast<int>(logging_obj.at("max_file_mb").as_number(cfg.logging.max_file_mb));
+        if (logging_obj.count("max_files")) cfg.logging.max_files = static_cast<int>(logging_obj.at("max_files").as_number(cfg.logging.max_files));
+        if (logging_obj.count("flush_interval_ms")) cfg.logging.flush_interval_ms = static_cast<int>(logging_obj.at("flush_interval_ms").as_number(cfg.logging.flush_interval_ms));
+        if (logging_obj.count("queue_capacity")) cfg.logging.queue_capacity = static_cast<int>(logging_obj.at("queue_capacity").as_number(cfg.logging.queue_capacity));
+    }
+
+    const auto& metrics_obj = object_or_empty(root, "metrics");
+    if (!metrics_obj.empty()) {
+        if (metrics_obj.count("enable")) cfg.metrics.enable = metrics_obj.at("enable").as_bool(cfg.metrics.enable);
+        if (metrics_obj.count("bind_ip")) cfg.metrics.bind_ip = metrics_obj.at("bind_ip").as_string(cfg.metrics.bind_ip);
+        if (metrics_obj.count("port")) cfg.metrics.port = static_cast<int>(metrics_obj.at("port").as_number(cfg.metrics.port));
+    }
+
+    const auto& runtime_obj = object_or_empty(root, "runtime");
+    if (!runtime_obj.empty()) {
+        if (runtime_obj.count("io_backend")) cfg.runtime.io_backend = runtime_obj.at("io_backend").as_string(cfg.runtime.io_backend);
+        if (runtime_obj.count("loop_threads")) cfg.runtime.loop_threads = static_cast<int>(runtime_obj.at("loop_threads").as_number(cfg.runtime.loop_threads));
+        if (runtime_obj.count("mlockall")) cfg.runtime.mlockall = runtime_obj.at("mlockall").as_bool(cfg.runtime.mlockall);
+        auto read_thread = [&runtime_obj](const char* key, ThreadSettings& thread) {
+            const auto& obj = object_or_empty(runtime_obj, key);
+            if (obj.count("cpus")) thread.cpus = obj.at("cpus").as_string(thread.cpus);
+            if (obj.count("priority")) thread.priority = static_cast<int>(obj.at("priority").as_number(thread.priority));
+        };
+        read_thread("relay", cfg.runtime.relay);
+        read_thread("image", cfg.runtime.image);
+        read_thread("gimbal", cfg.runtime.gimbal);
+        read_thread("logging", cfg.runtime.logging);
+        read_thread("service", cfg.runtime.service);
     }
 
     if (auto it = root.find("console_hud"); it != root.end()) cfg.console_hud = it->second.as_bool(cfg.console_hud);
     if (auto it = root.find("hud_interval"); it != root.end()) cfg.hud_interval = it->second.as_number(cfg.hud_interval);
+    if (auto it = root.find("hud_windows"); it != root.end() && it->second.is_array()) {
+        cfg.hud_windows.clear();
+        for (const auto& window : it->second.as_array()) {
+            if (window.as_number(0.0) > 0.0) cfg.hud_windows.push_back(window.as_number());
+        }
+    }
 
     return cfg;
 }
 
+bool operator==(const BridgeSettings& a, const BridgeSettings& b) {
+    return std::tie(a.ip, a.tcp_port, a.udp_port, a.realtime_dir, a.predefined_dir, a.image_source_mode,
+                    a.console_echo, a.show_hud) ==
+           std::tie(b.ip, b.tcp_port, b.udp_port, b.realtime_dir, b.predefined_dir, b.image_source_mode,
+                    b.console_echo, b.show_hud);
+}
+
+bool operator==(const GimbalSettings& a, const GimbalSettings& b) {
+    return std::tie(a.bind_ip, a.bind_port, a.generator_ip, a.generator_port, a.sensor_type, a.sensor_id,
+                    a.control_method, a.show_packets, a.packet_format, a.send_rate_hz, a.max_rate_dps,
+                    a.max_accel_dps2, a.max_zoom_rate, a.max_zoom_accel, a.measure_latency) ==
+           std::tie(b.bind_ip, b.bind_port, b.generator_ip, b.generator_port, b.sensor_type, b.sensor_id,
+                    b.control_method, b.show_packets, b.packet_format, b.send_rate_hz, b.max_rate_dps,
+                    b.max_accel_dps2, b.max_zoom_rate, b.max_zoom_accel, b.measure_latency);
+}
+
+bool operator==(const RelaySettings& a, const RelaySettings& b) {
+    return std::tie(a.bind_ip, a.bind_port, a.raw_ip, a.raw_port, a.proc_ip, a.proc_port, a.enable,
+                    a.log_packets, a.raw_queue, a.raw_drop_policy, a.proc_queue, a.proc_drop_policy) ==
+           std::tie(b.bind_ip, b.bind_port, b.raw_ip, b.raw_port, b.proc_ip, b.proc_port, b.enable,
+                    b.log_packets, b.raw_queue, b.raw_drop_policy, b.proc_queue, b.proc_drop_policy);
+}
+
 ConfigManager::ConfigManager(std::string base_dir) : base_dir_(std::move(base_dir)) {}
 
 AppConfig ConfigManager::defaults(const std::string& base_dir) {
@@ -179,13 +336,25 @@ AppConfig ConfigManager::load() {
     return cfg;
 }
 
+std::optional<AppConfig> ConfigManager::try_load() const {
+    try {
+        std::string text = load_text(config_path());
+        if (text.empty()) return std::nullopt;
+        return AppConfig::from_json(mini_json::parse(text), base_dir_);
+    } catch (const std::exception&) {
+        return std::nullopt;
+    }
+}
+
 void ConfigManager::save(const AppConfig& config) const {
     ensure_directory(base_dir_);
     ensure_directory(config.bridge.realtime_dir);
     ensure_directory(config.bridge.predefined_dir);
     ensure_directory(config.rover.log_directory);
 
-    std::string json = config.to_json().dump(2);
+    std::string json;
+    mini_json::Writer writer(json, 2);
+    config.write_json(writer);
     atomic_write(config_path(), json);
 }
 
@@ -0,0 +1,93 @@
+#include "utils/thread_tuning.hpp"
+
+#if defined(__linux__) || defined(__APPLE__)
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#endif
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+
+namespace utils {
+
+void set_current_thread_name(const std::string& name) {
+#if defined(__linux__)
+    ::pthread_setname_np(::pthread_self(), name.substr(0, 15).c_str());
+#elif defined(__APPLE__)
+    ::pthread_setname_np(name.c_str());
+#else
+    (void)name;
+#endif
+}
+
+bool parse_cpu_list(const std::string& text, std::vector<int>& cpus) {
+    cpus.clear();
+    std::stringstream ss(text);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        if (item.empty()) return false;
+        char* end = nullptr;
+        long first = std::strtol(item.c_str(), &end, 10);
+        long last = first;
+        if (end == item.c_str()) return false;
+        if (*end == '-') {
+            const char* start = end + 1;
+            last = std::strtol(start, &end, 10);
+            if (end == start) return false;
+        }
+        if (*end != '\0' || first < 0 || last < first) return false;
+#ifdef __linux__
+        if (last >= CPU_SETSIZE) return false;
+#endif
+        for (long cpu = first; cpu <= last; ++cpu) cpus.push_back(static_cast<int>(cpu));
+    }
+    return !cpus.empty();
+}
+
+bool apply_current_thread_policy(const std::string& cpus, int priority, std::string& error) {
+    error.clear();
+#ifdef __linux__
+    if (!cpus.empty()) {
+        std::vector<int> list;
+        if (!parse_cpu_list(cpus, list)) {
+            error = "invalid cpu list '" + cpus + "'";
+        } else {
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            for (int cpu : list) CPU_SET(cpu, &set);
+            if (int rc = ::pthread_setaffinity_np(::pthread_self(), sizeof(set), &set); rc != 0) {
+                error = "affinity " + cpus + ": " + std::strerror(rc);
+            }
+        }
+    }
+    if (priority > 0) {
+        sched_param param{};
+        param.sched_priority = priority > 99 ? 99 : priority;
+        if (int rc = ::pthread_setschedparam(::pthread_self(), SCHED_FIFO, &param); rc != 0) {
+            if (!error.empty()) error += "; ";
+            error += "SCHED_FIFO " + std::to_string(param.sched_priority) + ": " + std::strerror(rc);
+        }
+    }
+#else
+    if (!cpus.empty() || priority > 0) error = "thread affinity and priority are only supported on Linux";
+#endif
+    return error.empty();
+}
+
+bool lock_process_memory(std::string& error) {
+#if defined(__linux__) || defined(__APPLE__)
+    if (::mlockall(MCL_CURRENT | MCL_FUTURE) != 0) {
+        error = std::strerror(errno);
+        return false;
+    }
+    return true;
+#else
+    error = "mlockall is not supported on this platform";
+    return false;
+#endif
+}
+
+}  // namespace utils
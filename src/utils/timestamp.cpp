@@ -0,0 +1,94 @@
+#include "utils/timestamp.hpp"
+
+#include <cstring>
+#include <ctime>
+
+namespace timestamp {
+
+namespace {
+
+constexpr std::size_t kPrefixLength = 19;  // "YYYY-MM-DD HH:MM:SS"
+
+struct SecondCache {
+    std::int64_t second = INT64_MIN;
+    char prefix[kPrefixLength + 1] = {};
+};
+
+const char* seconds_prefix(std::int64_t second) {
+    thread_local SecondCache cache;
+    if (cache.second != second) {
+        auto tt = static_cast<std::time_t>(second);
+        std::tm tm{};
+#ifdef _WIN32
+        localtime_s(&tm, &tt);
+#else
+        localtime_r(&tt, &tm);
+#endif
+        if (std::strftime(cache.prefix, sizeof(cache.prefix), "%Y-%m-%d %H:%M:%S", &tm) != kPrefixLength) {
+            std::memset(cache.prefix, '?', kPrefixLength);
+        }
+        cache.second = second;
+    }
+    return cache.prefix;
+}
+
+void write_digits(char* out, std::int64_t value, int digits) {
+    for (int i = digits - 1; i >= 0; --i) {
+        out[i] = static_cast<char>('0' + value % 10);
+        value /= 10;
+    }
+}
+
+}  // namespace
+
+ClockPair now() {
+    ClockPair pair;
+    pair.wall_ns = wall_ns(std::chrono::system_clock::now());
+    pair.mono_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                       std::chrono::steady_clock::now().time_since_epoch())
+                       .count();
+    return pair;
+}
+
+std::int64_t wall_ns(std::chrono::system_clock::time_point time) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+}
+
+std::size_t format_local(char* out, std::int64_t wall_ns, Precision precision) {
+    std::int64_t second = wall_ns / 1000000000;
+    std::int64_t fraction = wall_ns % 1000000000;
+    if (fraction < 0) {
+        fraction += 1000000000;
+        --second;
+    }
+    std::memcpy(out, seconds_prefix(second), kPrefixLength);
+    out[kPrefixLength] = '.';
+    switch (precision) {
+        case Precision::Millis:
+            write_digits(out + kPrefixLength + 1, fraction / 1000000, 3);
+            return kPrefixLength + 1 + 3;
+        case Precision::Micros:
+            write_digits(out + kPrefixLength + 1, fraction / 1000, 6);
+            return kPrefixLength + 1 + 6;
+        case Precision::Nanos:
+            write_digits(out + kPrefixLength + 1, fraction, 9);
+            return kPrefixLength + 1 + 9;
+    }
+    return kPrefixLength;
+}
+
+std::size_t format_local(char* out, std::chrono::system_clock::time_point time, Precision precision) {
+    return format_local(out, wall_ns(time), precision);
+}
+
+void append_local(std::string& out, std::chrono::system_clock::time_point time, Precision precision) {
+    char buf[kMaxLength];
+    out.append(buf, format_local(buf, time, precision));
+}
+
+std::string local_string(std::chrono::system_clock::time_point time, Precision precision) {
+    char buf[kMaxLength];
+    return std::string(buf, format_local(buf, time, precision));
+}
+
+}  // namespace timestamp
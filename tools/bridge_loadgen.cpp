@@ -0,0 +1,630 @@
+#ifdef _WIN32
+#include <BaseTsd.h>
+#include <winsock2.h>
+#include <ws2tcpip.h>
+using ssize_t = SSIZE_T;
+#else
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "core/image_stream_bridge.hpp"
+#include "core/udp_relay.hpp"
+#include "network/reactor.hpp"
+#include "network/socket_utils.hpp"
+#include "utils/json_writer.hpp"
+#include "utils/latency_histogram.hpp"
+#include "utils/logger.hpp"
+#include "utils/metrics.hpp"
+#include "utils/settings.hpp"
+#include "utils/timestamp.hpp"
+
+// Loopback load test for UdpRelay and ImageStreamBridge. Each step sends
+// sequence-numbered probes at a fixed rate for a fixed time; UDP sinks on the
+// RAW/PROC ports and TCP viewers decode the probes and count delivery, loss,
+// duplicates, reordering and one-way latency. By default the relay and the
+// bridge run in this process; `--external` targets a unified_bridge that is
+// already running on the same host.
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+// Probe header at the start of every payload, host byte order (the sender
+// and the sinks always share a host). `size` lets a TCP viewer find frame
+// boundaries in the bridge's unframed stream.
+struct ProbeHeader {
+    std::uint32_t magic;
+    std::uint32_t size;
+    std::uint64_t sequence;
+    std::int64_t send_ns;
+};
+
+constexpr std::uint32_t kProbeMagic = 0x47414C4D;  // "MLAG"
+constexpr std::size_t kProbeHeaderSize = sizeof(ProbeHeader);
+constexpr std::size_t kMaxDatagram = 65507;
+constexpr int kSocketBufferBytes = 8 * 1024 * 1024;
+
+std::int64_t steady_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(clock_type::now().time_since_epoch()).count();
+}
+
+void write_probe(std::vector<std::uint8_t>& payload, std::uint64_t sequence) {
+    ProbeHeader header{kProbeMagic, static_cast<std::uint32_t>(payload.size()), sequence, steady_ns()};
+    std::memcpy(payload.data(), &header, sizeof(header));
+}
+
+bool read_probe(const std::uint8_t* data, std::size_t size, ProbeHeader& header) {
+    if (size < kProbeHeaderSize) return false;
+    std::memcpy(&header, data, sizeof(header));
+    return header.magic == kProbeMagic && header.size >= kProbeHeaderSize;
+}
+
+void set_buffer_sizes(int fd) {
+    int bytes = kSocketBufferBytes;
+    setsockopt(fd, SOL_SOCKET, SO_RCVBUF, reinterpret_cast<const char*>(&bytes), sizeof(bytes));
+    setsockopt(fd, SOL_SOCKET, SO_SNDBUF, reinterpret_cast<const char*>(&bytes), sizeof(bytes));
+}
+
+// Delivery bookkeeping for one receiver.
+struct StreamStats {
+    std::uint64_t received = 0;
+    std::uint64_t bytes = 0;
+    std::uint64_t unique = 0;
+    std::uint64_t duplicates = 0;
+    std::uint64_t reordered = 0;  // arrived after a higher sequence number
+    std::uint64_t resyncs = 0;    // TCP only: bytes skipped to find a header
+    std::uint64_t first = 0;      // probes below this belong to an earlier step
+    std::uint64_t highest = 0;
+    std::vector<bool> seen;
+    metrics::LatencyHistogram latency;  // first arrival of each sequence
+
+    void record(const ProbeHeader& header, std::size_t size, std::int64_t now_ns) {
+        if (header.sequence < first) return;
+        ++received;
+        bytes += size;
+        const std::size_t index = header.sequence - first;
+        if (index >= seen.size()) seen.resize(std::max<std::size_t>(index + 1, 2 * seen.size()));
+        if (seen[index]) {
+            ++duplicates;
+            return;
+        }
+        seen[index] = true;
+        ++unique;
+        if (unique > 1 && header.sequence < highest) ++reordered;
+        highest = std::max(highest, header.sequence);
+        if (now_ns > header.send_ns) latency.record(static_cast<std::uint64_t>(now_ns - header.send_ns));
+    }
+};
+
+class UdpSink {
+public:
+    UdpSink(const std::string& ip, int port, std::uint64_t first_sequence) {
+        stats_.first = first_sequence;
+        fd_ = network::create_udp_socket();
+        set_buffer_sizes(fd_);
+        network::set_receive_timeout(fd_, 100);
+        sockaddr_in addr = network::make_address(ip, static_cast<std::uint16_t>(port));
+        if (bind(fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+            std::fprintf(stderr, "sink: cannot bind %s\n",
+                         network::describe_endpoint(ip, static_cast<std::uint16_t>(port)).c_str());
+            network::close_socket(fd_);
+            fd_ = -1;
+            return;
+        }
+        running_ = true;
+        thread_ = std::thread(&UdpSink::run, this);
+    }
+
+    ~UdpSink() { stop(); }
+
+    // Joins the receiver; stats are only read after this.
+    void stop() {
+        running_ = false;
+        if (thread_.joinable()) thread_.join();
+        network::close_socket(fd_);
+        fd_ = -1;
+    }
+
+    const StreamStats& stats() const { return stats_; }
+
+private:
+    void run() {
+        std::vector<std::uint8_t> buffer(kMaxDatagram);
+        while (running_) {
+            ssize_t received = recv(fd_, reinterpret_cast<char*>(buffer.data()), static_cast<int>(buffer.size()), 0);
+            if (received <= 0) continue;
+            ProbeHeader header;
+            if (read_probe(buffer.data(), static_cast<std::size_t>(received), header)) {
+                stats_.record(header, static_cast<std::size_t>(received), steady_ns());
+            }
+        }
+    }
+
+    int fd_ = -1;
+    std::atomic<bool> running_{false};
+    std::thread thread_;
+    StreamStats stats_;
+};
+
+// One TCP viewer of the image bridge. Frames arrive back to back without
+// framing, so the probe header's size is used to split them.
+class TcpViewer {
+public:
+    TcpViewer(const std::string& ip, int port, std::uint64_t first_sequence) {
+        stats_.first = first_sequence;
+        fd_ = network::create_tcp_socket();
+        set_buffer_sizes(fd_);
+        sockaddr_in addr = network::make_address(ip, static_cast<std::uint16_t>(port));
+        if (connect(fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+            network::close_socket(fd_);
+            fd_ = -1;
+            return;
+        }
+        network::set_receive_timeout(fd_, 100);
+        running_ = true;
+        thread_ = std::thread(&TcpViewer::run, this);
+    }
+
+    ~TcpViewer() { stop(); }
+
+    bool ok() const { return fd_ >= 0; }
+
+    void stop() {
+        running_ = false;
+        if (thread_.joinable()) thread_.join();
+        network::close_socket(fd_);
+        fd_ = -1;
+    }
+
+    const StreamStats& stats() const { return stats_; }
+
+private:
+    void run() {
+        std::vector<std::uint8_t> pending;
+        std::vector<std::uint8_t> chunk(256 * 1024);
+        while (running_) {
+            ssize_t received = recv(fd_, reinterpret_cast<char*>(chunk.data()), static_cast<int>(chunk.size()), 0);
+            if (received == 0) break;
+            if (received < 0) continue;
+            pending.insert(pending.end(), chunk.begin(), chunk.begin() + received);
+
+            std::size_t offset = 0;
+            while (pending.size() - offset >= kProbeHeaderSize) {
+                ProbeHeader header;
+                if (!read_probe(pending.data() + offset, pending.size() - offset, header)) {
+                    ++offset;
+                    ++stats_.resyncs;
+                    continue;
+                }
+                if (pending.size() - offset < header.size) break;
+                stats_.record(header, header.size, steady_ns());
+                offset += header.size;
+            }
+            pending.erase(pending.begin(), pending.begin() + static_cast<std::ptrdiff_t>(offset));
+        }
+    }
+
+    int fd_ = -1;
+    std::atomic<bool> running_{false};
+    std::thread thread_;
+    StreamStats stats_;
+};
+
+// Sends `rate` probes per second for `duration` and returns how many went
+// out; the send loop catches up in bursts rather than sleeping per packet.
+// Sequence numbers continue across steps so a frame still cached by the
+// bridge from the previous step is recognised and ignored.
+struct SendResult {
+    std::uint64_t first = 0;
+    std::uint64_t sent = 0;
+    std::uint64_t errors = 0;
+    double seconds = 0.0;
+};
+
+SendResult paced_send(const std::string& ip, int port, double rate, std::size_t size, double duration,
+                      std::uint64_t first_sequence) {
+    SendResult result;
+    result.first = first_sequence;
+    int fd = network::create_udp_socket();
+    set_buffer_sizes(fd);
+    sockaddr_in dest = network::make_address(ip, static_cast<std::uint16_t>(port));
+    std::vector<std::uint8_t> payload(std::max(size, kProbeHeaderSize), 0x5A);
+
+    const auto start = clock_type::now();
+    const auto end = start + std::chrono::duration_cast<clock_type::duration>(std::chrono::duration<double>(duration));
+    for (auto now = start; now < end; now = clock_type::now()) {
+        const auto due = static_cast<std::uint64_t>(rate * std::chrono::duration<double>(now - start).count()) + 1;
+        if (result.sent >= due) {
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+            continue;
+        }
+        for (int burst = 0; burst < 256 && result.sent < due; ++burst) {
+            write_probe(payload, first_sequence + result.sent);
+            ssize_t sent = sendto(fd, reinterpret_cast<const char*>(payload.data()), static_cast<int>(payload.size()),
+                                  0, reinterpret_cast<sockaddr*>(&dest), sizeof(dest));
+            if (sent < 0) ++result.errors;
+            ++result.sent;
+        }
+    }
+    result.seconds = std::chrono::duration<double>(clock_type::now() - start).count();
+    network::close_socket(fd);
+    return result;
+}
+
+struct Options {
+    bool external = false;
+    bool run_relay = true;
+    bool run_image = true;
+    double duration = 5.0;
+    std::string json_path;
+    int loop_threads = 1;
+    std::string io_backend = "epoll";
+
+    std::string relay_ip = "127.0.0.1";
+    int relay_port = 10707;
+    int raw_port = 10708;
+    int proc_port = 10709;
+    std::vector<double> relay_rates{10000, 50000, 100000};
+    std::size_t relay_size = 256;
+
+    std::string image_ip = "127.0.0.1";
+    int image_udp_port = 9998;
+    int image_tcp_port = 9999;
+    std::vector<double> viewer_counts{1, 4, 16};
+    std::size_t frame_size = 60000;
+    double fps = 30.0;
+};
+
+bool parse_list(const char* text, std::vector<double>& out) {
+    out.clear();
+    std::stringstream ss(text);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        char* end = nullptr;
+        double value = std::strtod(item.c_str(), &end);
+        if (end == item.c_str() || value <= 0.0) return false;
+        out.push_back(value);
+    }
+    return !out.empty();
+}
+
+void print_usage(const char* argv0) {
+    std::printf(
+        "Usage: %s [options]\n"
+        "  --duration <s>            seconds per step (default 5)\n"
+        "  --external                drive an already running unified_bridge instead of in-process modules\n"
+        "  --json <file|->           also write the report as JSON\n"
+        "  --skip-relay | --skip-image\n"
+        "  --loop-threads <n>        reactor loops for the in-process modules (default 1)\n"
+        "  --io-backend <name>       in-process relay I/O path: epoll | io_uring (default epoll)\n"
+        "Relay:\n"
+        "  --relay-ip <ip>           relay address (default 127.0.0.1)\n"
+        "  --relay-port <port>       relay input (default 10707)\n"
+        "  --raw-port <port>         RAW sink (default 10708)\n"
+        "  --proc-port <port>        PROC sink (default 10709)\n"
+        "  --relay-rates <pps,...>   one step per rate (default 10000,50000,100000)\n"
+        "  --relay-size <bytes>      datagram size (default 256)\n"
+        "Image:\n"
+        "  --image-ip <ip>           bridge address (default 127.0.0.1)\n"
+        "  --image-udp <port>        frame input (default 9998)\n"
+        "  --image-tcp <port>        viewer port (default 9999)\n"
+        "  --viewers <n,...>         one step per viewer count (default 1,4,16)\n"
+        "  --frame-size <bytes>      frame size, at most 65507 (default 60000)\n"
+        "  --fps <rate>              frames per second (default 30)\n",
+        argv0);
+}
+
+bool parse_args(int argc, char** argv, Options& opts) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto next = [&]() -> const char* { return i + 1 < argc ? argv[++i] : nullptr; };
+        const char* value = nullptr;
+        if (arg == "--external") {
+            opts.external = true;
+        } else if (arg == "--skip-relay") {
+            opts.run_relay = false;
+        } else if (arg == "--skip-image") {
+            opts.run_image = false;
+        } else if (arg == "--duration" && (value = next())) {
+            opts.duration = std::atof(value);
+        } else if (arg == "--json" && (value = next())) {
+            opts.json_path = value;
+        } else if (arg == "--loop-threads" && (value = next())) {
+            opts.loop_threads = std::atoi(value);
+        } else if (arg == "--io-backend" && (value = next())) {
+            opts.io_backend = value;
+            if (opts.io_backend != "epoll" && opts.io_backend != "io_uring") return false;
+        } else if (arg == "--relay-ip" && (value = next())) {
+            opts.relay_ip = value;
+        } else if (arg == "--relay-port" && (value = next())) {
+            opts.relay_port = std::atoi(value);
+        } else if (arg == "--raw-port" && (value = next())) {
+            opts.raw_port = std::atoi(value);
+        } else if (arg == "--proc-port" && (value = next())) {
+            opts.proc_port = std::atoi(value);
+        } else if (arg == "--relay-rates" && (value = next())) {
+            if (!parse_list(value, opts.relay_rates)) return false;
+        } else if (arg == "--relay-size" && (value = next())) {
+            opts.relay_size = static_cast<std::size_t>(std::atoi(value));
+        } else if (arg == "--image-ip" && (value = next())) {
+            opts.image_ip = value;
+        } else if (arg == "--image-udp" && (value = next())) {
+            opts.image_udp_port = std::atoi(value);
+        } else if (arg == "--image-tcp" && (value = next())) {
+            opts.image_tcp_port = std::atoi(value);
+        } else if (arg == "--viewers" && (value = next())) {
+            if (!parse_list(value, opts.viewer_counts)) return false;
+        } else if (arg == "--frame-size" && (value = next())) {
+            opts.frame_size = static_cast<std::size_t>(std::atoi(value));
+        } else if (arg == "--fps" && (value = next())) {
+            opts.fps = std::atof(value);
+        } else {
+            return false;
+        }
+    }
+    return opts.duration > 0.0 && opts.loop_threads > 0 && opts.fps > 0.0 && opts.frame_size >= kProbeHeaderSize &&
+           opts.frame_size <= kMaxDatagram && opts.relay_size >= kProbeHeaderSize && opts.relay_size <= kMaxDatagram;
+}
+
+struct StreamReport {
+    std::string name;
+    std::uint64_t unique = 0;
+    std::uint64_t duplicates = 0;
+    std::uint64_t reordered = 0;
+    std::uint64_t resyncs = 0;
+    double loss_pct = 0.0;
+    double rate = 0.0;  // unique probes per second
+    double mbps = 0.0;
+    double p50_ms = 0.0;
+    double p99_ms = 0.0;
+    double max_ms = 0.0;
+};
+
+struct StepReport {
+    std::string kind;  // relay | image
+    double offered = 0.0;  // pps or fps
+    std::size_t size = 0;
+    std::size_t viewers = 0;
+    SendResult send;
+    double ingest_loss_pct = -1.0;  // image, in-process only
+    std::vector<StreamReport> streams;
+};
+
+StreamReport summarize(const std::string& name, const StreamStats& stats, std::uint64_t sent, double seconds) {
+    StreamReport r;
+    r.name = name;
+    r.unique = stats.unique;
+    r.duplicates = stats.duplicates;
+    r.reordered = stats.reordered;
+    r.resyncs = stats.resyncs;
+    if (sent > 0) {
+        r.loss_pct = 100.0 * static_cast<double>(sent - std::min(sent, stats.unique)) / static_cast<double>(sent);
+    }
+    r.rate = static_cast<double>(stats.unique) / seconds;
+    r.mbps = static_cast<double>(stats.bytes) * 8e-6 / seconds;
+    const auto snap = stats.latency.snapshot();
+    r.p50_ms = static_cast<double>(snap.percentile(0.50)) / 1e6;
+    r.p99_ms = static_cast<double>(snap.percentile(0.99)) / 1e6;
+    r.max_ms = static_cast<double>(snap.max) / 1e6;
+    return r;
+}
+
+StepReport run_relay_step(const Options& opts, double rate, std::uint64_t& sequence) {
+    StepReport step;
+    step.kind = "relay";
+    step.offered = rate;
+    step.size = opts.relay_size;
+    UdpSink raw(opts.relay_ip, opts.raw_port, sequence);
+    UdpSink proc(opts.relay_ip, opts.proc_port, sequence);
+    step.send = paced_send(opts.relay_ip, opts.relay_port, rate, opts.relay_size, opts.duration, sequence);
+    sequence += step.send.sent;
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));  // drain
+    raw.stop();
+    proc.stop();
+    step.streams.push_back(summarize("raw", raw.stats(), step.send.sent, step.send.seconds));
+    step.streams.push_back(summarize("proc", proc.stats(), step.send.sent, step.send.seconds));
+    return step;
+}
+
+StepReport run_image_step(const Options& opts, std::size_t viewer_count, std::uint64_t& sequence) {
+    StepReport step;
+    step.kind = "image";
+    step.offered = opts.fps;
+    step.size = opts.frame_size;
+    step.viewers = viewer_count;
+
+    std::vector<std::unique_ptr<TcpViewer>> viewers;
+    for (std::size_t i = 0; i < viewer_count; ++i) {
+        viewers.push_back(std::make_unique<TcpViewer>(opts.image_ip, opts.image_tcp_port, sequence));
+        if (!viewers.back()->ok()) {
+            const auto port = static_cast<std::uint16_t>(opts.image_tcp_port);
+            std::fprintf(stderr, "viewer %zu could not connect to %s\n", i,
+                         network::describe_endpoint(opts.image_ip, port).c_str());
+            viewers.pop_back();
+            break;
+        }
+    }
+    const double received_before = metrics::default_registry().snapshot().value("image_frames_received");
+    step.send = paced_send(opts.image_ip, opts.image_udp_port, opts.fps, opts.frame_size, opts.duration, sequence);
+    sequence += step.send.sent;
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    for (auto& viewer : viewers) viewer->stop();
+    if (!opts.external && step.send.sent > 0) {
+        const double ingested = metrics::default_registry().snapshot().value("image_frames_received") - received_before;
+        step.ingest_loss_pct =
+            100.0 * std::max(0.0, static_cast<double>(step.send.sent) - ingested) / static_cast<double>(step.send.sent);
+    }
+    for (std::size_t i = 0; i < viewers.size(); ++i) {
+        step.streams.push_back(summarize("viewer" + std::to_string(i), viewers[i]->stats(), step.send.sent,
+                                         step.send.seconds));
+    }
+    return step;
+}
+
+void print_step(const StepReport& step) {
+    if (step.kind == "relay") {
+        std::printf("\nrelay  offered %.0f pps x %zu B  sent %llu (%llu send errors) in %.2fs\n", step.offered,
+                    step.size, static_cast<unsigned long long>(step.send.sent),
+                    static_cast<unsigned long long>(step.send.errors), step.send.seconds);
+    } else {
+        std::printf("\nimage  offered %.1f fps x %zu B  viewers %zu  sent %llu in %.2fs", step.offered, step.size,
+                    step.viewers, static_cast<unsigned long long>(step.send.sent), step.send.seconds);
+        if (step.ingest_loss_pct >= 0.0) std::printf("  ingest loss %.2f%%", step.ingest_loss_pct);
+        std::printf("\n");
+    }
+    std::printf("  %-9s %10s %8s %8s %8s %8s %10s %9s %9s %9s\n", "sink", "unique/s", "loss%", "dup", "reord", "resync",
+                "Mbit/s", "p50 ms", "p99 ms", "max ms");
+    for (const auto& s : step.streams) {
+        std::printf("  %-9s %10.1f %8.2f %8llu %8llu %8llu %10.2f %9.3f %9.3f %9.3f\n", s.name.c_str(), s.rate,
+                    s.loss_pct, static_cast<unsigned long long>(s.duplicates),
+                    static_cast<unsigned long long>(s.reordered), static_cast<unsigned long long>(s.resyncs), s.mbps,
+                    s.p50_ms, s.p99_ms, s.max_ms);
+    }
+}
+
+bool write_json(const std::string& path, const Options& opts, const std::vector<StepReport>& steps) {
+    std::string out;
+    mini_json::Writer writer(out, 2);
+    writer.begin_object();
+    writer.member("tool", "bridge_loadgen");
+    writer.member("timestamp", timestamp::local_string(std::chrono::system_clock::now()));
+    writer.member("external", opts.external);
+    writer.member("duration_s", opts.duration);
+    if (!opts.external) {
+        writer.member("io_backend", opts.io_backend);
+        writer.member("loop_threads", opts.loop_threads);
+    }
+    writer.key("steps").begin_array();
+    for (const auto& step : steps) {
+        writer.begin_object();
+        writer.member("kind", step.kind);
+        writer.member("offered", step.offered);
+        writer.member("size", step.size);
+        if (step.kind == "image") writer.member("viewers", step.viewers);
+        writer.member("sent", step.send.sent);
+        writer.member("send_errors", step.send.errors);
+        writer.member("seconds", step.send.seconds);
+        if (step.ingest_loss_pct >= 0.0) writer.member("ingest_loss_pct", step.ingest_loss_pct);
+        writer.key("sinks").begin_array();
+        for (const auto& s : step.streams) {
+            writer.begin_object();
+            writer.member("name", s.name);
+            writer.member("unique", s.unique);
+            writer.member("rate", s.rate);
+            writer.member("loss_pct", s.loss_pct);
+            writer.member("duplicates", s.duplicates);
+            writer.member("reordered", s.reordered);
+            writer.member("resyncs", s.resyncs);
+            writer.member("mbps", s.mbps);
+            writer.member("latency_p50_ms", s.p50_ms);
+            writer.member("latency_p99_ms", s.p99_ms);
+            writer.member("latency_max_ms", s.max_ms);
+            writer.end_object();
+        }
+        writer.end_array();
+        writer.end_object();
+    }
+    writer.end_array();
+    writer.end_object();
+    out += '\n';
+
+    if (path == "-") {
+        std::fwrite(out.data(), 1, out.size(), stdout);
+        return true;
+    }
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) return false;
+    bool ok = std::fwrite(out.data(), 1, out.size(), file) == out.size();
+    return std::fclose(file) == 0 && ok;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    Options opts;
+    if (!parse_args(argc, argv, opts)) {
+        print_usage(argv[0]);
+        return 2;
+    }
+#ifdef _WIN32
+    WSADATA wsaData;
+    if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0) {
+        std::fprintf(stderr, "Failed to initialize Winsock\n");
+        return 1;
+    }
+#endif
+
+    logging::Logger logger("LoadGen");
+    logger.set_level(logging::Level::Warning);
+    network::Reactor reactor(static_cast<std::size_t>(opts.loop_threads), network::parse_io_backend(opts.io_backend));
+    reactor.start();
+    std::unique_ptr<core::UdpRelay> relay;
+    std::unique_ptr<core::ImageStreamBridge> bridge;
+    if (!opts.external) {
+        if (opts.run_relay) {
+            settings::RelaySettings cfg;
+            cfg.bind_ip = opts.relay_ip;
+            cfg.bind_port = opts.relay_port;
+            cfg.raw_ip = opts.relay_ip;
+            cfg.raw_port = opts.raw_port;
+            cfg.proc_ip = opts.relay_ip;
+            cfg.proc_port = opts.proc_port;
+            relay = std::make_unique<core::UdpRelay>(cfg, reactor, logger, nullptr);
+            relay->start();
+        }
+        if (opts.run_image) {
+            settings::BridgeSettings cfg;
+            cfg.ip = opts.image_ip;
+            cfg.udp_port = opts.image_udp_port;
+            cfg.tcp_port = opts.image_tcp_port;
+            bridge = std::make_unique<core::ImageStreamBridge>(cfg, reactor, logger);
+            bridge->start();
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+
+    const bool quiet = opts.json_path == "-";
+    std::vector<StepReport> steps;
+    std::uint64_t sequence = 0;
+    if (opts.run_relay) {
+        for (double rate : opts.relay_rates) {
+            steps.push_back(run_relay_step(opts, rate, sequence));
+            if (!quiet) print_step(steps.back());
+        }
+    }
+    if (opts.run_image) {
+        for (double count : opts.viewer_counts) {
+            steps.push_back(run_image_step(opts, static_cast<std::size_t>(count), sequence));
+            if (!quiet) print_step(steps.back());
+        }
+    }
+
+    if (bridge) bridge->stop();
+    if (relay) relay->stop();
+    reactor.stop();
+
+    int rc = 0;
+    if (!opts.json_path.empty() && !write_json(opts.json_path, opts, steps)) {
+        std::fprintf(stderr, "failed to write %s\n", opts.json_path.c_str());
+        rc = 1;
+    }
+#ifdef _WIN32
+    WSACleanup();
+#endif
+    return rc;
+}